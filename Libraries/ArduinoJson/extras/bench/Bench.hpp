@@ -0,0 +1,60 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <stdio.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// Returns the best time of one call to f(), in seconds.
+// The calls are timed in batches of at least 10 ms, so that the clock doesn't
+// count, and the best of 7 batches filters out the noise of a shared machine.
+template <typename TFunction>
+double measure(TFunction f) {
+  typedef std::chrono::steady_clock clock;
+  long calls = 1;
+  double best = 0;
+  for (int batch = 0; batch < 7;) {
+    clock::time_point start = clock::now();
+    for (long i = 0; i < calls; i++)
+      f();
+    double seconds =
+        std::chrono::duration<double>(clock::now() - start).count();
+    if (seconds < 0.01) {
+      calls *= 2;
+      continue;
+    }
+    double perCall = seconds / double(calls);
+    if (batch == 0 || perCall < best)
+      best = perCall;
+    batch++;
+  }
+  return best;
+}
+
+inline double megabytesPerSecond(size_t bytes, double seconds) {
+  return double(bytes) / seconds / 1e6;
+}
+
+inline std::string readFile(const std::string& path) {
+  std::ifstream file(path.c_str(), std::ios::binary);
+  if (!file) {
+    fprintf(stderr, "Failed to open %s\n", path.c_str());
+    return std::string();
+  }
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+// Keeps the compiler from dropping a computation whose result is unused
+inline void consume(size_t value) {
+  static volatile size_t sink;
+  sink = value;
+  (void)sink;
+}
@@ -0,0 +1,32 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+// Included after ArduinoJson.h by the translation units that compare the
+// configurations, so that each one builds its own copy of this function.
+
+#include <string>
+
+#include "Bench.hpp"
+
+struct ParseResult {
+  double seconds;  // per document
+  size_t memoryUsage;
+  DeserializationError error;
+};
+
+// Deserializes a copy of json, so every string goes through deduplication
+static ParseResult measureParse(const std::string& json) {
+  DynamicJsonDocument doc(1 << 20);
+
+  ParseResult result;
+  result.error = deserializeJson(doc, json.c_str(), json.size());
+  result.memoryUsage = doc.memoryUsage();
+  result.seconds = measure([&]() {
+    deserializeJson(doc, json.c_str(), json.size());
+    consume(doc.memoryUsage());
+  });
+  return result;
+}
@@ -0,0 +1,34 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+// Included after ArduinoJson.h by the translation units that compare the
+// configurations, so that each one builds its own copy of this function.
+
+#include <string>
+
+#include "Bench.hpp"
+
+struct NumbersResult {
+  double parseSeconds;  // per document
+  double serializeSeconds;
+  std::string output;
+};
+
+static NumbersResult measureNumbers(const std::string& json) {
+  DynamicJsonDocument doc(1 << 17);
+  static char output[1 << 16];
+
+  NumbersResult result;
+  result.parseSeconds = measure([&]() {
+    deserializeJson(doc, json.c_str(), json.size());
+    consume(doc.memoryUsage());
+  });
+  result.serializeSeconds = measure([&]() {
+    consume(serializeJson(doc, output, sizeof(output)));
+  });
+  result.output = output;
+  return result;
+}
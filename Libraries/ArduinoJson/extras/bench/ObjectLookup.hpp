@@ -0,0 +1,39 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+// Included after ArduinoJson.h by the translation units that compare the
+// configurations, so that each one builds its own copy of this function.
+
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+
+struct LookupResult {
+  double seconds;  // per lookup
+  size_t memoryUsage;
+};
+
+static LookupResult measureLookup(int members) {
+  DynamicJsonDocument doc(65536);
+  std::vector<std::string> keys;
+  for (int i = 0; i < members; i++) {
+    keys.push_back("member" + std::to_string(i));
+    doc[keys.back()] = i;
+  }
+  JsonObjectConst obj = doc.as<JsonObjectConst>();
+
+  LookupResult result;
+  result.seconds = measure([&]() {
+    int sum = 0;
+    for (int i = 0; i < members; i++)
+      sum += obj[keys[size_t(i)].c_str()].as<int>();
+    consume(size_t(sum));
+  });
+  result.seconds /= members;
+  result.memoryUsage = doc.memoryUsage();
+  return result;
+}
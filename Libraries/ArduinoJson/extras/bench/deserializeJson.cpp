@@ -0,0 +1,119 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Deserialization speed in MB/s of the inputs scanned in place (char arrays)
+// and of a reader called once per character, the path every input used to
+// take, on relay events and on the fuzzing seed corpus.
+
+#include <ArduinoJson.h>
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "Bench.hpp"
+
+// A reader that isn't a char array, so JsonDeserializer reads it char by char
+struct CharByCharReader {
+  const char* p;
+  const char* end;
+
+  int read() {
+    return p < end ? static_cast<unsigned char>(*p++) : -1;
+  }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t n = 0;
+    while (n < length && p < end)
+      buffer[n++] = *p++;
+    return n;
+  }
+};
+
+struct Input {
+  std::string name;
+  std::string json;
+};
+
+static std::vector<Input> inputs() {
+  std::vector<Input> result;
+  Input chat = {
+      "chat event",
+      "{\"type\":\"chat\",\"username\":\"tiktok_user123\",\"message\":\"this "
+      "stream is amazing, love it! \\ud83d\\udd25\",\"timestamp\":"
+      "1792251146105}"};
+  result.push_back(chat);
+  Input gift = {"gift event",
+                "{\"type\":\"gift\",\"username\":\"generous.viewer\","
+                "\"giftName\":\"Rose\",\"giftId\":5655,\"repeatCount\":37,"
+                "\"timestamp\":1792251146105}"};
+  result.push_back(gift);
+
+  // A raw event as forwarded to the clients that didn't subscribe
+  std::string member =
+      "{\"type\":\"member\",\"data\":{\"actionId\":1,\"memberCount\":1532,"
+      "\"user\":{\"userId\":\"7301234567890123456\",\"uniqueId\":\"new_fan\","
+      "\"nickname\":\"New Fan \\u2728\",\"profilePicture\":{\"urls\":[";
+  for (int i = 0; i < 8; i++) {
+    if (i)
+      member += ",";
+    member +=
+        "\"https://p16-sign-va.tiktokcdn.com/tos-maliva-avt-0068/"
+        "a1b2c3d4e5f6~c5_100x100.jpeg?x-expires=1792300000&x-signature=abc\"";
+  }
+  member +=
+      "]},\"followRole\":0,\"userBadges\":[],\"isModerator\":false},"
+      "\"displayType\":\"live_room_enter_toast\",\"label\":\"{0:user} joined\"},"
+      "\"timestamp\":1792251146105}";
+  Input raw = {"raw member event", member};
+  result.push_back(raw);
+
+  const char* corpus[] = {"Numbers.json", "OpenWeatherMap.json", "Strings.json",
+                          "WeatherUnderground.json"};
+  for (size_t i = 0; i < sizeof(corpus) / sizeof(corpus[0]); i++) {
+    Input file = {corpus[i],
+                  readFile(std::string(JSON_SEED_CORPUS_DIR "/") + corpus[i])};
+    if (!file.json.empty())
+      result.push_back(file);
+  }
+  return result;
+}
+
+int main() {
+  DynamicJsonDocument doc(1 << 17);
+  std::vector<Input> list = inputs();
+
+  // The seed corpus has inputs that only parse with the NaN, Infinity and
+  // single quote extensions, so they stop early: the last column says so.
+  printf("%-24s %8s %14s %14s %14s  %s\n", "input", "bytes", "in place MB/s",
+         "copy MB/s", "by char MB/s", "result");
+  for (size_t i = 0; i < list.size(); i++) {
+    const std::string& json = list[i].json;
+    std::vector<char> buffer(json.size());
+    DeserializationError result =
+        deserializeJson(doc, json.c_str(), json.size());
+
+    // the copy back is part of the time, but it's a memcpy
+    double inPlace = measure([&]() {
+      memcpy(buffer.data(), json.data(), json.size());
+      deserializeJson(doc, buffer.data(), buffer.size());
+      consume(doc.memoryUsage());
+    });
+    double copy = measure([&]() {
+      deserializeJson(doc, json.c_str(), json.size());
+      consume(doc.memoryUsage());
+    });
+    double byChar = measure([&]() {
+      CharByCharReader reader = {json.data(), json.data() + json.size()};
+      deserializeJson(doc, reader);
+      consume(doc.memoryUsage());
+    });
+
+    printf("%-24s %8zu %14.1f %14.1f %14.1f  %s\n", list[i].name.c_str(),
+           json.size(), megabytesPerSecond(json.size(), inPlace),
+           megabytesPerSecond(json.size(), copy),
+           megabytesPerSecond(json.size(), byChar), result.c_str());
+  }
+  return 0;
+}
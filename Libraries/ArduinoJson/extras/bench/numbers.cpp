@@ -0,0 +1,88 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Speed of deserializeJson() and serializeJson() on arrays of floating-point
+// values, with rounded and with exact conversions
+// (ARDUINOJSON_USE_EXACT_FLOAT 0 vs 1, see numbersExact.cpp)
+
+#define ARDUINOJSON_USE_EXACT_FLOAT 0
+#include <ArduinoJson.h>
+
+#include <random>
+
+#include "Numbers.hpp"
+
+NumbersResult measureExactNumbers(const std::string& json);
+
+// Values with few decimals, like sensor readings or prices
+static std::string shortDecimals(int count) {
+  std::mt19937 generator(42);
+  std::string json = "[";
+  for (int i = 0; i < count; i++) {
+    unsigned cents = unsigned(generator() % 100000);
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u.%02u", cents / 100, cents % 100);
+    if (i)
+      json += ",";
+    json += buffer;
+  }
+  return json + "]";
+}
+
+// Doubles that need all their 17 digits
+static std::string fullDoubles(int count) {
+  std::mt19937_64 generator(42);
+  std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+  std::string json = "[";
+  for (int i = 0; i < count; i++) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.17g", distribution(generator));
+    if (i)
+      json += ",";
+    json += buffer;
+  }
+  return json + "]";
+}
+
+// Keeps the best times of each configuration
+static void keepBest(NumbersResult& best, const NumbersResult& result) {
+  if (best.output.empty() || result.parseSeconds < best.parseSeconds)
+    best.parseSeconds = result.parseSeconds;
+  if (best.output.empty() || result.serializeSeconds < best.serializeSeconds)
+    best.serializeSeconds = result.serializeSeconds;
+  best.output = result.output;
+}
+
+int main() {
+  struct {
+    const char* name;
+    std::string json;
+  } inputs[] = {
+      {"1000 short decimals", shortDecimals(1000)},
+      {"1000 full doubles", fullDoubles(1000)},
+  };
+
+  printf("%-20s %-8s %12s %16s %14s\n", "input", "mode", "parse MB/s",
+         "serialize MB/s", "output bytes");
+  for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+    const std::string& json = inputs[i].json;
+    // measured in turns, so that a slow period of the machine doesn't favor
+    // one configuration
+    NumbersResult rounded, exact;
+    for (int round = 0; round < 10; round++) {
+      keepBest(rounded, measureNumbers(json));
+      keepBest(exact, measureExactNumbers(json));
+    }
+
+    printf("%-20s %-8s %12.1f %16.1f %14zu\n", inputs[i].name, "rounded",
+           megabytesPerSecond(json.size(), rounded.parseSeconds),
+           megabytesPerSecond(rounded.output.size(), rounded.serializeSeconds),
+           rounded.output.size());
+    printf("%-20s %-8s %12.1f %16.1f %14zu\n", "", "exact",
+           megabytesPerSecond(json.size(), exact.parseSeconds),
+           megabytesPerSecond(exact.output.size(), exact.serializeSeconds),
+           exact.output.size());
+  }
+  return 0;
+}
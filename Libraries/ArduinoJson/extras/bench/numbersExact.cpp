@@ -0,0 +1,12 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_USE_EXACT_FLOAT 1
+#include <ArduinoJson.h>
+
+#include "Numbers.hpp"
+
+NumbersResult measureExactNumbers(const std::string& json) {
+  return measureNumbers(json);
+}
@@ -0,0 +1,35 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Time of JsonObject::operator[] with and without the index of members
+// (ARDUINOJSON_OBJECT_INDEX_THRESHOLD 0 vs 8, see objectLookupIndexed.cpp)
+
+#include <ArduinoJson.h>
+
+#include <algorithm>
+
+#include "ObjectLookup.hpp"
+
+LookupResult measureIndexedLookup(int members);
+
+int main() {
+  const int sizes[] = {4, 32, 256};
+
+  printf("%8s %16s %16s %14s %14s\n", "members", "linear ns/lookup",
+         "indexed ns/lookup", "linear bytes", "indexed bytes");
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    // measured in turns, keeping the best of each, so that a slow period of
+    // the machine doesn't favor one configuration
+    LookupResult linear = measureLookup(sizes[i]);
+    LookupResult indexed = measureIndexedLookup(sizes[i]);
+    for (int round = 1; round < 10; round++) {
+      linear.seconds = std::min(linear.seconds, measureLookup(sizes[i]).seconds);
+      indexed.seconds =
+          std::min(indexed.seconds, measureIndexedLookup(sizes[i]).seconds);
+    }
+    printf("%8d %16.1f %16.1f %14zu %14zu\n", sizes[i], linear.seconds * 1e9,
+           indexed.seconds * 1e9, linear.memoryUsage, indexed.memoryUsage);
+  }
+  return 0;
+}
@@ -0,0 +1,12 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_OBJECT_INDEX_THRESHOLD 8
+#include <ArduinoJson.h>
+
+#include "ObjectLookup.hpp"
+
+LookupResult measureIndexedLookup(int members) {
+  return measureLookup(members);
+}
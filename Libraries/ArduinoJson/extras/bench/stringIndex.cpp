@@ -0,0 +1,51 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Time of deserializeJson() on an array of 1000 relay events, with and without
+// the table of strings (ARDUINOJSON_ENABLE_STRING_INDEX 0 vs 1, see
+// stringIndexEnabled.cpp)
+
+#include <ArduinoJson.h>
+
+#include "EventArray.hpp"
+
+ParseResult measureParseWithStringIndex(const std::string& json);
+
+// Events from 300 viewers, so that the names repeat but the messages don't
+static std::string eventArray(int events) {
+  std::string json = "[";
+  for (int i = 0; i < events; i++) {
+    std::string n = std::to_string(i);
+    std::string user = "viewer_" + std::to_string(i * 7 % 300);
+    if (i)
+      json += ",";
+    if (i % 3)
+      json += "{\"type\":\"chat\",\"username\":\"" + user +
+              "\",\"message\":\"message number " + n +
+              "\",\"timestamp\":1792251146" + n + "}";
+    else
+      json += "{\"type\":\"gift\",\"username\":\"" + user +
+              "\",\"giftName\":\"Rose\",\"giftId\":5655,\"repeatCount\":" + n +
+              ",\"timestamp\":1792251146" + n + "}";
+  }
+  json += "]";
+  return json;
+}
+
+int main() {
+  std::string json = eventArray(1000);
+  ParseResult scan = measureParse(json);
+  ParseResult indexed = measureParseWithStringIndex(json);
+
+  printf("%zu bytes\n", json.size());
+  printf("%-14s %10s %8s %14s  %s\n", "strings", "us/parse", "MB/s",
+         "memoryUsage", "result");
+  printf("%-14s %10.1f %8.1f %14zu  %s\n", "scanned", scan.seconds * 1e6,
+         megabytesPerSecond(json.size(), scan.seconds), scan.memoryUsage,
+         scan.error.c_str());
+  printf("%-14s %10.1f %8.1f %14zu  %s\n", "indexed", indexed.seconds * 1e6,
+         megabytesPerSecond(json.size(), indexed.seconds), indexed.memoryUsage,
+         indexed.error.c_str());
+  return 0;
+}
@@ -0,0 +1,12 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_ENABLE_STRING_INDEX 1
+#include <ArduinoJson.h>
+
+#include "EventArray.hpp"
+
+ParseResult measureParseWithStringIndex(const std::string& json) {
+  return measureParse(json);
+}
@@ -0,0 +1,74 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Speed in MB/s of TextFormatter::writeString(), which writes the runs that
+// don't need escaping in one call, and of a loop of writeChar(), the way it
+// used to write every string, into a char buffer. No input may be slower
+// with writeString().
+
+#include <ArduinoJson.h>
+
+#include <string>
+
+#include "Bench.hpp"
+
+using namespace ArduinoJson::detail;
+
+typedef TextFormatter<StaticStringWriter> Formatter;
+
+struct Input {
+  const char* name;
+  std::string value;
+};
+
+static std::string repeat(const char* s, size_t length) {
+  std::string result;
+  while (result.size() < length)
+    result += s;
+  result.resize(length);
+  return result;
+}
+
+int main() {
+  Input inputs[] = {
+      {"short word", "tiktok_user123"},
+      {"ASCII chat message",
+       repeat("this stream is amazing, greetings from Manila! ", 200)},
+      {"ASCII 4KB", repeat("The quick brown fox jumps over the lazy dog. ", 4096)},
+      {"escape every 4 chars", repeat("ab\"c\\de\nf", 4096)},
+      {"escape every char", repeat("\"\\\n\t", 4096)},
+      // past a few escapes in a row, writeString() stops checking for a while
+      {"bursts of 8 escapes",
+       repeat("\"\\\n\t\"\\\n\tThe quick brown fox jumps over the lazy dog. ",
+              4096)},
+  };
+  static char output[65536];
+
+  printf("%-22s %8s %18s %18s\n", "input", "bytes", "writeString MB/s",
+         "writeChar MB/s");
+  for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+    const std::string& value = inputs[i].value;
+
+    double runs = measure([&]() {
+      StaticStringWriter writer(output, sizeof(output));
+      Formatter formatter(writer);
+      formatter.writeString(value.data(), value.size());
+      consume(formatter.bytesWritten());
+    });
+    double chars = measure([&]() {
+      StaticStringWriter writer(output, sizeof(output));
+      Formatter formatter(writer);
+      formatter.writeRaw('\"');
+      for (size_t j = 0; j < value.size(); j++)
+        formatter.writeChar(value[j]);
+      formatter.writeRaw('\"');
+      consume(formatter.bytesWritten());
+    });
+
+    printf("%-22s %8zu %18.1f %18.1f\n", inputs[i].name, value.size(),
+           megabytesPerSecond(value.size(), runs),
+           megabytesPerSecond(value.size(), chars));
+  }
+  return 0;
+}
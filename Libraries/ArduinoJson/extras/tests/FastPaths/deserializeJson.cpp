@@ -0,0 +1,93 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("deserializeJson() skips runs of spaces") {
+  DynamicJsonDocument doc(4096);
+
+  for (size_t before = 0; before < 20; before++) {
+    for (size_t after = 0; after < 20; after++) {
+      std::string json = "[" + std::string(before, ' ') + "1" +
+                         std::string(after, '\t') + ",\r\n" +
+                         std::string(before + after, ' ') + "2]" +
+                         std::string(after, '\n');
+      CAPTURE(json);
+
+      REQUIRE(deserializeJson(doc, json.c_str(), json.size()) ==
+              DeserializationError::Ok);
+      CHECK(doc.as<std::string>() == "[1,2]");
+
+      REQUIRE(deserializeJson(doc, json.substr(0, json.size() - after - 2)) ==
+              DeserializationError::IncompleteInput);
+    }
+  }
+}
+
+TEST_CASE("Strings scanned a word at a time") {
+  DynamicJsonDocument doc(4096);
+
+  // Every alignment of the string and of the escape sequence in it, for the
+  // inputs that are scanned in place and for the ones that are read by char
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t length = 0; length < 40; length++) {
+      for (size_t escape = 0; escape <= length; escape++) {
+        std::string expected(length, 'a');
+        for (size_t i = 0; i < length; i++)
+          expected[i] = char('a' + i % 26);
+        std::string json = std::string(offset, ' ') + "\"" +
+                           expected.substr(0, escape) + "\\\"" +
+                           expected.substr(escape) + "\"";
+        expected.insert(escape, "\"");
+        CAPTURE(json);
+
+        REQUIRE(deserializeJson(doc, json.c_str()) == DeserializationError::Ok);
+        CHECK(doc.as<std::string>() == expected);
+
+        REQUIRE(deserializeJson(doc, json.c_str(), json.size()) ==
+                DeserializationError::Ok);
+        CHECK(doc.as<std::string>() == expected);
+
+        std::vector<char> input(json.begin(), json.end());
+        input.push_back('\0');
+        REQUIRE(deserializeJson(doc, input.data(), json.size()) ==
+                DeserializationError::Ok);
+        CHECK(doc.as<std::string>() == expected);
+
+        std::istringstream stream(json);
+        REQUIRE(deserializeJson(doc, stream) == DeserializationError::Ok);
+        CHECK(doc.as<std::string>() == expected);
+      }
+    }
+  }
+}
+
+TEST_CASE("String ends before its closing quote") {
+  DynamicJsonDocument doc(4096);
+
+  SECTION("end of the input") {
+    std::string json = "\"" + std::string(37, 'x') + "\"";
+    for (size_t size = 1; size < json.size(); size++) {
+      CAPTURE(size);
+      REQUIRE(deserializeJson(doc, json.c_str(), size) ==
+              DeserializationError::IncompleteInput);
+    }
+  }
+
+  SECTION("NUL inside the input") {
+    std::string json = "\"" + std::string(37, 'x') + "\"";
+    for (size_t i = 1; i < json.size() - 1; i++) {
+      std::string input = json;
+      input[i] = '\0';
+      CAPTURE(i);
+      REQUIRE(deserializeJson(doc, input.c_str(), input.size()) ==
+              DeserializationError::IncompleteInput);
+    }
+  }
+}
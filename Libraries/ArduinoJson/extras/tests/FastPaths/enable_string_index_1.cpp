@@ -0,0 +1,79 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_ENABLE_STRING_INDEX 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+static std::string value(size_t i) {
+  return "value number " + std::to_string(i);
+}
+
+TEST_CASE("ARDUINOJSON_ENABLE_STRING_INDEX == 1") {
+  DynamicJsonDocument doc(65536);
+
+  SECTION("deserializeJson() deduplicates strings") {
+    std::string json = "[";
+    for (size_t i = 0; i < 1000; i++)
+      json += (i ? ",\"" : "\"") + value(i % 300) + "\"";
+    json += "]";
+
+    DeserializationError err = deserializeJson(doc, json);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.size() == 1000);
+    for (size_t i = 0; i < 1000; i++) {
+      REQUIRE(doc[i] == value(i % 300));
+      REQUIRE(doc[i].as<const char*>() == doc[i % 300].as<const char*>());
+    }
+  }
+
+  SECTION("add() deduplicates strings") {
+    for (size_t i = 0; i < 200; i++)
+      doc.add(value(i));
+    for (size_t i = 0; i < 200; i++)
+      doc.add(value(i));
+
+    REQUIRE(doc.size() == 400);
+    for (size_t i = 0; i < 200; i++) {
+      REQUIRE(doc[i] == value(i));
+      REQUIRE(doc[i].as<const char*>() == doc[i + 200].as<const char*>());
+    }
+  }
+
+  SECTION("shrinkToFit()") {
+    for (size_t i = 0; i < 200; i++)
+      doc.add(value(i));
+
+    doc.shrinkToFit();
+
+    for (size_t i = 0; i < 200; i++)
+      REQUIRE(doc[i] == value(i));
+  }
+
+  SECTION("garbageCollect()") {
+    for (size_t i = 0; i < 200; i++)
+      doc.add(value(i));
+    doc.remove(0);
+
+    REQUIRE(doc.garbageCollect());
+
+    REQUIRE(doc.size() == 199);
+    for (size_t i = 1; i < 200; i++)
+      doc.add(value(i));
+    for (size_t i = 0; i < 199; i++)
+      REQUIRE(doc[i].as<const char*>() == doc[i + 199].as<const char*>());
+  }
+
+  SECTION("keys and values share strings") {
+    for (size_t i = 0; i < 200; i++)
+      doc[value(i)] = value(i);
+
+    REQUIRE(doc.size() == 200);
+    for (JsonPair p : doc.as<JsonObject>())
+      REQUIRE(p.key().c_str() == p.value().as<const char*>());
+  }
+}
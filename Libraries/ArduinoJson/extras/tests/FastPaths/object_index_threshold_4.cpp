@@ -0,0 +1,169 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_OBJECT_INDEX_THRESHOLD 4
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+static std::string key(int i) {
+  return "key" + std::to_string(i);
+}
+
+static void checkMembers(JsonObjectConst obj, int n) {
+  REQUIRE(obj.size() == size_t(n));
+  for (int i = 0; i < n; i++)
+    REQUIRE(obj[key(i)] == i);
+  REQUIRE(obj["missing"].isNull());
+}
+
+TEST_CASE("ARDUINOJSON_OBJECT_INDEX_THRESHOLD == 4") {
+  DynamicJsonDocument doc(16384);
+
+  SECTION("small object") {
+    for (int i = 0; i < 3; i++)
+      doc[key(i)] = i;
+
+    checkMembers(doc.as<JsonObject>(), 3);
+  }
+
+  SECTION("large object") {
+    for (int i = 0; i < 100; i++)
+      doc[key(i)] = i;
+
+    checkMembers(doc.as<JsonObject>(), 100);
+  }
+
+  SECTION("assign existing member") {
+    for (int i = 0; i < 20; i++)
+      doc[key(i)] = -1;
+    for (int i = 0; i < 20; i++)
+      doc[key(i)] = i;
+
+    checkMembers(doc.as<JsonObject>(), 20);
+  }
+
+  SECTION("remove members") {
+    for (int i = 0; i < 20; i++)
+      doc[key(i)] = i;
+    doc.remove("key0");
+    doc.remove("key19");
+    doc.remove("key7");
+
+    REQUIRE(doc.size() == 17);
+    REQUIRE(doc["key0"].isNull());
+    REQUIRE(doc["key7"].isNull());
+    REQUIRE(doc["key19"].isNull());
+    REQUIRE(doc["key8"] == 8);
+
+    doc["key7"] = 7;
+    REQUIRE(doc["key7"] == 7);
+    REQUIRE(doc.size() == 18);
+  }
+
+  SECTION("remove and add members in turn") {
+    const char* keys[] = {"a", "b", "c", "d", "e", "f", "g", "h", "i", "j"};
+    for (int i = 0; i < 10; i++)
+      doc[keys[i]] = i;
+    size_t memoryUsage = doc.memoryUsage();
+
+    // the pool doesn't reuse removed slots, but the index keeps its table
+    for (int n = 0; n < 100; n++) {
+      const char* k = keys[n * 7 % 10];
+      doc.remove(k);
+      REQUIRE(doc[k].isNull());
+      doc[k] = n;
+      REQUIRE(doc[k] == n);
+      REQUIRE(doc.memoryUsage() ==
+              memoryUsage + size_t(n + 1) * sizeof(detail::VariantSlot));
+    }
+    REQUIRE(doc.size() == 10);
+    for (int i = 0; i < 10; i++)
+      REQUIRE(doc[keys[i]].is<int>());
+    REQUIRE(doc["missing"].isNull());
+  }
+
+  SECTION("remove a member with a duplicate key") {
+    // deserializeMsgPack() keeps duplicate keys, lookups find the first one
+    const char msgpack[] =
+        "\x86\xA1" "a\x01\xA1" "b\x02\xA1" "c\x03\xA1" "d\x04\xA1" "e\x05"
+        "\xA1" "a\x06";
+    DeserializationError err =
+        deserializeMsgPack(doc, msgpack, sizeof(msgpack) - 1);
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc["a"] == 1);
+
+    doc.remove("a");
+    REQUIRE(doc["a"] == 6);
+    doc.remove("a");
+    REQUIRE(doc["a"].isNull());
+    REQUIRE(doc["e"] == 5);
+  }
+
+  SECTION("deserializeJson()") {
+    std::string json = "{";
+    for (int i = 0; i < 50; i++)
+      json += (i ? ",\"" : "\"") + key(i) + "\":" + std::to_string(i);
+    json += "}";
+
+    DeserializationError err = deserializeJson(doc, json);
+
+    REQUIRE(err == DeserializationError::Ok);
+    checkMembers(doc.as<JsonObject>(), 50);
+  }
+
+  SECTION("deserializeJson() with duplicate keys") {
+    DeserializationError err = deserializeJson(
+        doc, "{\"a\":1,\"b\":2,\"c\":3,\"d\":4,\"e\":5,\"a\":6,\"e\":7}");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"a\":6,\"b\":2,\"c\":3,\"d\":4,\"e\":7}");
+  }
+
+  SECTION("deserializeMsgPack()") {
+    for (int i = 0; i < 30; i++)
+      doc[key(i)] = i;
+    std::string msgpack;
+    serializeMsgPack(doc, msgpack);
+
+    DynamicJsonDocument doc2(16384);
+    DeserializationError err = deserializeMsgPack(doc2, msgpack);
+
+    REQUIRE(err == DeserializationError::Ok);
+    checkMembers(doc2.as<JsonObject>(), 30);
+  }
+
+  SECTION("copy") {
+    for (int i = 0; i < 30; i++)
+      doc[key(i)] = i;
+
+    DynamicJsonDocument doc2(doc);
+
+    checkMembers(doc2.as<JsonObject>(), 30);
+  }
+
+  SECTION("shrinkToFit()") {
+    for (int i = 0; i < 30; i++)
+      doc[key(i)] = i;
+
+    doc.shrinkToFit();
+
+    checkMembers(doc.as<JsonObject>(), 30);
+  }
+}
+
+TEST_CASE("Object index doesn't fit") {
+  // sized with JSON_OBJECT_SIZE(), so there is no room left for the index
+  StaticJsonDocument<JSON_OBJECT_SIZE(4)> doc;
+  const char* keys[] = {"a", "b", "c", "d"};
+
+  for (int i = 0; i < 4; i++)
+    REQUIRE(doc[keys[i]].set(i));
+
+  REQUIRE(doc.memoryUsage() == JSON_OBJECT_SIZE(4));
+  for (int i = 0; i < 4; i++)
+    REQUIRE(doc[keys[i]] == i);
+  REQUIRE(doc["missing"].isNull());
+}
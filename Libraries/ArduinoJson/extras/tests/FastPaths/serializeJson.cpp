@@ -0,0 +1,54 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+static std::string escape(const std::string& value) {
+  std::string result = "\"";
+  for (size_t i = 0; i < value.size(); i++) {
+    switch (value[i]) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        result += value[i];
+    }
+  }
+  return result + "\"";
+}
+
+TEST_CASE("serializeJson() escapes runs of escapes") {
+  // Runs of every length, so that writeString() switches to writing char by
+  // char and back at every position, followed by text that needs no escape
+  DynamicJsonDocument doc(4096);
+  const char escapes[] = "\"\\\n\t";
+  for (size_t run = 0; run < 100; run++) {
+    for (size_t text = 0; text < 20; text += 3) {
+      std::string value;
+      for (size_t i = 0; i < run; i++)
+        value += escapes[i % 4];
+      for (size_t i = 0; i < text; i++)
+        value += char('a' + i);
+      value += "\t\"end";
+      CAPTURE(value);
+
+      doc.set(value);
+      std::string json;
+      serializeJson(doc, json);
+      CHECK(json == escape(value));
+    }
+  }
+}
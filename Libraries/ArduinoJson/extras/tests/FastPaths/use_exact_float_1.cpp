@@ -0,0 +1,196 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_USE_EXACT_FLOAT 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <string>
+
+using namespace ArduinoJson::detail;
+
+template <typename T>
+static std::string format(T value) {
+  std::string output;
+  Writer<std::string> sb(output);
+  TextFormatter<Writer<std::string>> formatter(sb);
+  formatter.writeFloat(value);
+  REQUIRE(formatter.bytesWritten() == output.size());
+  return output;
+}
+
+TEST_CASE("ARDUINOJSON_USE_EXACT_FLOAT == 1") {
+  SECTION("Pi") {
+    CHECK(format<double>(3.14159265359) == "3.14159265359");
+    CHECK(format<double>(3.141592653589793) == "3.141592653589793");
+    CHECK(format<float>(3.14159265359f) == "3.1415927");
+  }
+
+  SECTION("Espilon") {
+    CHECK(format<double>(2.2250738585072014E-308) ==
+          "2.2250738585072014e-308");
+    CHECK(format<double>(-2.2250738585072014E-308) ==
+          "-2.2250738585072014e-308");
+  }
+
+  SECTION("Smallest subnormal") {
+    CHECK(format<double>(4.9406564584124654E-324) == "5e-324");
+  }
+
+  SECTION("Max double") {
+    CHECK(format<double>(1.7976931348623157E+308) == "1.7976931348623157e308");
+    CHECK(format<double>(-1.7976931348623157E+308) ==
+          "-1.7976931348623157e308");
+  }
+
+  SECTION("Shortest decimal that reads back the same") {
+    CHECK(format<double>(0.1) == "0.1");
+    CHECK(format<double>(0.000099999999999) == "0.000099999999999");
+    CHECK(format<double>(0.0000099999999999) == "9.9999999999e-6");
+    CHECK(format<double>(0.9999999996) == "0.9999999996");
+    CHECK(format<double>(0.1 + 0.2) == "0.30000000000000004");
+  }
+
+  SECTION("10 decimal places") {
+    CHECK(format<double>(0.1000000001) == "0.1000000001");
+    CHECK(format<double>(0.9999999999) == "0.9999999999");
+    CHECK(format<double>(9.0000000001) == "9.0000000001");
+    CHECK(format<double>(9.9999999999) == "9.9999999999");
+  }
+
+  SECTION("Trailing zeros") {
+    CHECK(format<double>(100.0) == "100");
+    CHECK(format<double>(1234500.0) == "1234500");
+    CHECK(format<double>(1.5e7) == "1.5e7");
+  }
+
+  SECTION("serializeJson()") {
+    DynamicJsonDocument doc(1024);
+    doc.add(3.14159265359);
+    doc.add(0.9999999996);
+    doc.add(1e-5);
+
+    std::string json;
+    serializeJson(doc, json);
+
+    REQUIRE(json == "[3.14159265359,0.9999999996,1e-5]");
+  }
+
+  SECTION("deserializeJson()") {
+    DynamicJsonDocument doc(1024);
+    DeserializationError err = deserializeJson(
+        doc, "[0.1,2.2250738585072014E-308,1.7976931348623157E+308]");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc[0].as<double>() == 0.1);
+    REQUIRE(doc[1].as<double>() == 2.2250738585072014E-308);
+    REQUIRE(doc[2].as<double>() == 1.7976931348623157E+308);
+  }
+}
+
+template <typename T, typename TBits>
+static void checkRoundTrip(TBits bits) {
+  T value;
+  memcpy(&value, &bits, sizeof(value));
+  if (value != value || value * 2 == value)  // NaN, infinity or zero
+    return;
+
+  std::string json = format(value);
+  T parsed = parseNumber<T>(json.c_str());
+
+  CAPTURE(json);
+  REQUIRE(memcmp(&parsed, &value, sizeof(value)) == 0);
+}
+
+TEST_CASE("Floating-point round trip") {
+  std::mt19937_64 generator(42);
+
+  SECTION("Random doubles") {
+    for (int i = 0; i < 20000; i++)
+      checkRoundTrip<double>(generator());
+  }
+
+  SECTION("Doubles around each power of two") {
+    for (uint64_t exponent = 0; exponent < 0x7FF; exponent++) {
+      checkRoundTrip<double>(exponent << 52);
+      checkRoundTrip<double>(exponent << 52 | 1);
+      checkRoundTrip<double>(exponent << 52 | 0xFFFFFFFFFFFFF);
+    }
+  }
+
+  SECTION("Random floats") {
+    for (int i = 0; i < 20000; i++)
+      checkRoundTrip<float>(uint32_t(generator()));
+  }
+}
+
+// The significant digits of a number, without its leading and trailing zeros
+static std::string significantDigits(const std::string& number) {
+  std::string digits;
+  for (size_t i = 0; i < number.size() && number[i] != 'e'; i++) {
+    if (number[i] >= '0' && number[i] <= '9' &&
+        (number[i] != '0' || !digits.empty()))
+      digits += number[i];
+  }
+  return digits.substr(0, digits.find_last_not_of('0') + 1);
+}
+
+// The shortest decimal with printf(), the closest of its length
+template <typename T>
+static std::string shortestWithPrintf(T value) {
+  char buffer[32];
+  for (int precision = 0;; precision++) {
+    snprintf(buffer, sizeof(buffer), "%.*e", precision, double(value));
+    if (T(strtod(buffer, 0)) == value)
+      return significantDigits(buffer);
+  }
+}
+
+template <typename T>
+static void checkFewDecimals(uint64_t integer, int decimals) {
+  T value = T(integer);
+  for (int i = 0; i < decimals; i++)
+    value /= 10;
+  std::string json = format(value);
+
+  CAPTURE(json);
+  REQUIRE(significantDigits(json) == shortestWithPrintf(value));
+  REQUIRE(parseNumber<T>(json.c_str()) == value);
+}
+
+TEST_CASE("Values with a few decimals") {
+  std::mt19937_64 generator(42);
+
+  // on both sides of the digits a fast path can take
+  for (int i = 0; i < 20000; i++) {
+    int decimals = int(generator() % 7);
+    checkFewDecimals<double>(generator() % 10000000000000000, decimals);
+    checkFewDecimals<float>(generator() % 10000000, decimals);
+  }
+}
+
+TEST_CASE("parseNumber<double>() rounds correctly") {
+  std::mt19937_64 generator(42);
+
+  for (int i = 0; i < 20000; i++) {
+    std::string input;
+    int digits = int(generator() % 25) + 1;
+    int dot = int(generator() % size_t(digits + 1));
+    for (int j = 0; j < digits; j++) {
+      if (j == dot)
+        input += '.';
+      input += char('0' + generator() % 10);
+    }
+    input += 'e' + std::to_string(int(generator() % 640) - 330);
+
+    CAPTURE(input);
+    double expected = strtod(input.c_str(), 0);
+    double actual = parseNumber<double>(input.c_str());
+    REQUIRE(memcmp(&actual, &expected, sizeof(double)) == 0);
+  }
+}
@@ -2,6 +2,7 @@
 // Copyright © 2014-2025, Benoit BLANCHON
 // MIT License
 
+#define ARDUINOJSON_USE_EXACT_FLOAT 0
 #include <ArduinoJson.h>
 #include <catch.hpp>
 #include <limits>
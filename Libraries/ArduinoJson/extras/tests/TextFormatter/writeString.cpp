@@ -54,4 +54,32 @@ TEST_CASE("TextFormatter::writeString()") {
   SECTION("HorizontalTab") {
     check("\t", "\"\\t\"");
   }
+
+  SECTION("Other control characters") {
+    check("\x01\x1f", "\"\x01\x1f\"");
+  }
+
+  SECTION("Long string without escapes") {
+    check("hello world, this is a longer string",
+          "\"hello world, this is a longer string\"");
+  }
+
+  SECTION("Escapes in a long string") {
+    check("\"hello\"\tworld\\, this\nis a longer string\r",
+          "\"\\\"hello\\\"\\tworld\\\\, this\\nis a longer string\\r\"");
+  }
+
+  SECTION("Non-ASCII characters") {
+    check("caf\xc3\xa9 \xe2\x98\x83 \xf0\x9f\x98\x80",
+          "\"caf\xc3\xa9 \xe2\x98\x83 \xf0\x9f\x98\x80\"");
+  }
+
+  SECTION("Null character") {
+    char output[64] = {0};
+    StaticStringWriter sb(output, sizeof(output));
+    TextFormatter<StaticStringWriter> writer(sb);
+    writer.writeString("hello\0world", 11);
+    REQUIRE(std::string("\"hello\\u0000world\"") == output);
+    REQUIRE(writer.bytesWritten() == 18);
+  }
 }
@@ -11,13 +11,15 @@
 
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
+class CollectionIndex;
 class MemoryPool;
 class VariantData;
 class VariantSlot;
 
 class CollectionData {
   VariantSlot* head_;
-  VariantSlot* tail_;
+  VariantSlot* tail_;  // or the index, tagged with the lowest bit, which keeps
+                       // the tail instead
 
  public:
   // Must be a POD!
@@ -64,6 +66,9 @@ class CollectionData {
   VariantSlot* addSlot(MemoryPool*);
   void removeSlot(VariantSlot* slot);
 
+  // Call after setting the key of a new member
+  void indexMembers(MemoryPool*);
+
   bool copyFrom(const CollectionData& src, MemoryPool* pool);
 
   VariantSlot* head() const {
@@ -78,7 +83,15 @@ class CollectionData {
   template <typename TAdaptedString>
   VariantSlot* getSlot(TAdaptedString key) const;
 
+  template <typename TAdaptedString>
+  VariantSlot* getIndexedSlot(TAdaptedString key, CollectionIndex*) const;
+
   VariantSlot* getPreviousSlot(VariantSlot*) const;
+
+  VariantSlot* tail() const;
+  void setTail(VariantSlot*);
+  CollectionIndex* index() const;
+  void reindexMembers(MemoryPool*, size_t capacity);
 };
 
 inline const VariantData* collectionToVariant(
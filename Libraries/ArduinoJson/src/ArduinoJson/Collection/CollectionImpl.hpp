@@ -5,25 +5,49 @@
 #pragma once
 
 #include <ArduinoJson/Collection/CollectionData.hpp>
+#include <ArduinoJson/Collection/CollectionIndex.hpp>
+#include <ArduinoJson/Polyfills/attributes.hpp>
 #include <ArduinoJson/Strings/StoragePolicy.hpp>
 #include <ArduinoJson/Strings/StringAdapters.hpp>
 #include <ArduinoJson/Variant/VariantData.hpp>
 
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
+inline CollectionIndex* CollectionData::index() const {
+#if ARDUINOJSON_OBJECT_INDEX_THRESHOLD
+  uintptr_t p = reinterpret_cast<uintptr_t>(tail_);
+  if (p & 1)
+    return reinterpret_cast<CollectionIndex*>(p - 1);
+#endif
+  return 0;
+}
+
+inline VariantSlot* CollectionData::tail() const {
+  CollectionIndex* idx = index();
+  return idx ? idx->tail() : tail_;
+}
+
+inline void CollectionData::setTail(VariantSlot* slot) {
+  CollectionIndex* idx = index();
+  if (idx)
+    idx->setTail(slot);
+  else
+    tail_ = slot;
+}
+
 inline VariantSlot* CollectionData::addSlot(MemoryPool* pool) {
   VariantSlot* slot = pool->allocVariant();
   if (!slot)
     return 0;
 
-  if (tail_) {
-    ARDUINOJSON_ASSERT(pool->owns(tail_));  // Can't alter a linked array/object
-    tail_->setNextNotNull(slot);
-    tail_ = slot;
+  VariantSlot* last = tail();
+  if (last) {
+    ARDUINOJSON_ASSERT(pool->owns(last));  // Can't alter a linked array/object
+    last->setNextNotNull(slot);
   } else {
     head_ = slot;
-    tail_ = slot;
   }
+  setTail(slot);
 
   slot->clear();
   return slot;
@@ -41,9 +65,51 @@ inline VariantData* CollectionData::addMember(TAdaptedString key,
     removeSlot(slot);
     return 0;
   }
+  indexMembers(pool);
   return slot->data();
 }
 
+inline void CollectionData::indexMembers(MemoryPool* pool) {
+#if ARDUINOJSON_OBJECT_INDEX_THRESHOLD
+  CollectionIndex* idx = index();
+  if (idx) {
+    if (idx->update(head_))
+      return;
+    // the tombstones of removed members may be what fills the table: index
+    // the members again in the same table before allocating a bigger one
+    if (idx->tombstones()) {
+      idx->clear();
+      if (idx->update(head_))
+        return;
+    }
+    reindexMembers(pool, idx->capacity() * 2);
+    return;
+  }
+  // Slots are allocated downwards, so most small objects are ruled out
+  // without walking them
+  if (!head_ || head_ - tail_ < ARDUINOJSON_OBJECT_INDEX_THRESHOLD - 1 ||
+      !head_->next(ARDUINOJSON_OBJECT_INDEX_THRESHOLD - 1))
+    return;
+  size_t capacity = 8;
+  while (capacity / 4 * 3 <= ARDUINOJSON_OBJECT_INDEX_THRESHOLD)
+    capacity *= 2;
+  reindexMembers(pool, capacity);
+#else
+  (void)pool;
+#endif
+}
+
+inline void CollectionData::reindexMembers(MemoryPool* pool, size_t capacity) {
+  // if there is no room, keep the old index and search the rest one by one
+  CollectionIndex* idx = CollectionIndex::create(pool, capacity);
+  if (!idx)
+    return;
+  idx->setTail(tail());
+  idx->update(head_);
+  tail_ =
+      reinterpret_cast<VariantSlot*>(reinterpret_cast<uintptr_t>(idx) | 1);
+}
+
 inline void CollectionData::clear() {
   head_ = 0;
   tail_ = 0;
@@ -78,6 +144,9 @@ template <typename TAdaptedString>
 inline VariantSlot* CollectionData::getSlot(TAdaptedString key) const {
   if (key.isNull())
     return 0;
+  CollectionIndex* idx = index();
+  if (idx)
+    return getIndexedSlot(key, idx);
   VariantSlot* slot = head_;
   while (slot) {
     if (stringEquals(key, adaptString(slot->key())))
@@ -87,6 +156,20 @@ inline VariantSlot* CollectionData::getSlot(TAdaptedString key) const {
   return slot;
 }
 
+// Kept out of line, so that getSlot() stays the tight loop of small objects
+template <typename TAdaptedString>
+NO_INLINE VariantSlot* CollectionData::getIndexedSlot(
+    TAdaptedString key, CollectionIndex* idx) const {
+  size_t pos = 0;
+  VariantSlot* slot = idx->first(key, head_, pos);
+  while (slot) {
+    if (stringEquals(key, adaptString(slot->key())))
+      break;
+    slot = idx->next(slot, head_, pos);
+  }
+  return slot;
+}
+
 inline VariantSlot* CollectionData::getSlot(size_t index) const {
   if (!head_)
     return 0;
@@ -156,7 +239,10 @@ inline void CollectionData::removeSlot(VariantSlot* slot) {
   else
     head_ = next;
   if (!next)
-    tail_ = prev;
+    setTail(prev);
+  CollectionIndex* idx = index();
+  if (idx)
+    idx->remove(slot, prev, head_);
 }
 
 inline void CollectionData::removeElement(size_t index) {
@@ -189,7 +275,15 @@ inline void movePointer(T*& p, ptrdiff_t offset) {
 inline void CollectionData::movePointers(ptrdiff_t stringDistance,
                                          ptrdiff_t variantDistance) {
   movePointer(head_, variantDistance);
-  movePointer(tail_, variantDistance);
+  CollectionIndex* idx = index();
+  if (idx) {
+    movePointer(idx, variantDistance);
+    idx->movePointers(variantDistance);
+    tail_ = reinterpret_cast<VariantSlot*>(reinterpret_cast<uintptr_t>(idx) |
+                                           1);
+  } else {
+    movePointer(tail_, variantDistance);
+  }
   for (VariantSlot* slot = head_; slot; slot = slot->next())
     slot->movePointers(stringDistance, variantDistance);
 }
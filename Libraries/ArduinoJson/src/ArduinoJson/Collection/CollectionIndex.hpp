@@ -0,0 +1,211 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2023, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Memory/MemoryPool.hpp>
+#include <ArduinoJson/Polyfills/limits.hpp>
+#include <ArduinoJson/Strings/StringAdapters.hpp>
+#include <ArduinoJson/Variant/VariantSlot.hpp>
+
+#include <string.h>  // strcmp
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// A hash table of the members of a large object.
+// It's allocated in the pool next to the slots, so it moves with them, and
+// refers to each slot by its distance, like VariantSlot::next().
+// It covers the slots from the head of the object to last_; the ones after
+// last_ are searched one by one. Removed members leave a tombstone, so that
+// the probe sequences that pass them go on, until the table fills up and is
+// rebuilt in place.
+class CollectionIndex {
+ public:
+  // Returns null if the pool doesn't have room for it
+  static CollectionIndex* create(MemoryPool* pool, size_t capacity) {
+    size_t bytes =
+        sizeof(CollectionIndex) + capacity * sizeof(VariantSlotDiff);
+    VariantSlot* p = pool->allocOptionalVariants(
+        (bytes + sizeof(VariantSlot) - 1) / sizeof(VariantSlot));
+    if (!p)
+      return 0;
+    CollectionIndex* index = reinterpret_cast<CollectionIndex*>(p);
+    index->tail_ = 0;
+    index->capacity_ = capacity;
+    index->clear();
+    return index;
+  }
+
+  // Empties the table, to index the slots again from the head
+  void clear() {
+    last_ = 0;
+    size_ = 0;
+    tombstones_ = 0;
+    frozen_ = false;
+    for (size_t i = 0; i < capacity_; i++)
+      table()[i] = 0;
+  }
+
+  // The tail of the object, which CollectionData keeps here instead
+  VariantSlot* tail() const {
+    return tail_;
+  }
+
+  void setTail(VariantSlot* slot) {
+    tail_ = slot;
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  size_t tombstones() const {
+    return tombstones_;
+  }
+
+  // Adds the slots after last_, or after head if the table is empty, as long
+  // as the table isn't full. Returns false if some are left.
+  bool update(VariantSlot* head) {
+    if (frozen_)
+      return true;
+    VariantSlot* slot = last_ ? last_->next() : head;
+    while (slot) {
+      if (size_ >= capacity_ / 4 * 3)
+        return false;
+      if (!slot->key() || !insert(slot)) {
+        // not a member, or too far to be stored: leave the rest to the linear
+        // search
+        frozen_ = true;
+        return true;
+      }
+      last_ = slot;
+      slot = slot->next();
+    }
+    return true;
+  }
+
+  // The slots that may have the key: the ones in its probe sequence, then the
+  // ones after last_. CollectionData::getSlot() compares the keys itself, so
+  // that small objects keep their tight loop.
+  template <typename TAdaptedString>
+  VariantSlot* first(TAdaptedString key, VariantSlot* head, size_t& pos) const {
+    pos = stringHash(key) & (capacity_ - 1);
+    return at(pos, head);
+  }
+
+  VariantSlot* next(VariantSlot* slot, VariantSlot* head, size_t& pos) const {
+    if (pos == capacity_)  // past the table
+      return slot->next();
+    pos = (pos + 1) & (capacity_ - 1);
+    return at(pos, head);
+  }
+
+  // Forgets slot, which was just unlinked from the object, prev being the
+  // slot that was before it
+  void remove(VariantSlot* slot, VariantSlot* prev, VariantSlot* head) {
+    VariantSlotDiff* entry = find(slot);
+    if (entry) {
+      *entry = tombstone();
+      tombstones_++;
+      // a duplicate key that the table skipped takes its place
+      for (VariantSlot* s = slot; s != last_;) {
+        s = s->next();
+        if (strcmp(s->key(), slot->key()) == 0) {
+          if (!insert(s)) {  // too far to be stored: index the others again
+            clear();
+            update(head);
+            return;
+          }
+          break;
+        }
+      }
+    }
+    if (slot == last_)
+      last_ = prev;
+  }
+
+  void movePointers(ptrdiff_t variantDistance) {
+    movePointer(tail_, variantDistance);
+    movePointer(last_, variantDistance);
+  }
+
+ private:
+  // An entry that is neither empty (0) nor a slot: the lowest diff, which
+  // insert() doesn't store
+  static VariantSlotDiff tombstone() {
+    return numeric_limits<VariantSlotDiff>::lowest();
+  }
+
+  // Keeps the first of duplicate keys, as the linear search does
+  bool insert(VariantSlot* slot) {
+    ptrdiff_t diff = slot - base();
+    if (diff <= numeric_limits<VariantSlotDiff>::lowest() ||
+        diff > numeric_limits<VariantSlotDiff>::highest())
+      return false;
+    const char* key = slot->key();
+    size_t mask = capacity_ - 1;
+    size_t i = stringHash(adaptString(key)) & mask;
+    while (table()[i]) {
+      if (table()[i] != tombstone() &&
+          strcmp(key, (base() + table()[i])->key()) == 0)
+        return true;
+      i = (i + 1) & mask;
+    }
+    table()[i] = VariantSlotDiff(diff);
+    size_++;
+    return true;
+  }
+
+  // Returns the entry of slot, or null if it isn't in the table
+  VariantSlotDiff* find(VariantSlot* slot) const {
+    if (!last_ || !slot->key())
+      return 0;
+    size_t mask = capacity_ - 1;
+    size_t i = stringHash(adaptString(slot->key())) & mask;
+    while (table()[i]) {
+      if (table()[i] != tombstone() && base() + table()[i] == slot)
+        return &table()[i];
+      i = (i + 1) & mask;
+    }
+    return 0;
+  }
+
+  // The table always has an empty entry, as size_ counts the tombstones
+  VariantSlot* at(size_t& pos, VariantSlot* head) const {
+    VariantSlotDiff diff = table()[pos];
+    while (diff == tombstone()) {
+      pos = (pos + 1) & (capacity_ - 1);
+      diff = table()[pos];
+    }
+    if (diff)
+      return base() + diff;
+    pos = capacity_;
+    return last_ ? last_->next() : head;
+  }
+
+  template <typename T>
+  static void movePointer(T*& p, ptrdiff_t offset) {
+    if (p)
+      p = reinterpret_cast<T*>(
+          reinterpret_cast<void*>(reinterpret_cast<char*>(p) + offset));
+  }
+
+  VariantSlot* base() const {
+    return reinterpret_cast<VariantSlot*>(
+        const_cast<CollectionIndex*>(this));
+  }
+
+  VariantSlotDiff* table() const {
+    return reinterpret_cast<VariantSlotDiff*>(
+        const_cast<CollectionIndex*>(this + 1));
+  }
+
+  VariantSlot* tail_;
+  VariantSlot* last_;
+  size_t size_, capacity_;  // capacity_ is a power of two
+  size_t tombstones_;       // counted in size_ too
+  bool frozen_;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
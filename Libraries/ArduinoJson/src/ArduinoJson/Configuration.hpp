@@ -161,6 +161,24 @@
 #  define ARDUINOJSON_ENABLE_INFINITY 0
 #endif
 
+// Parse floating-point values with correct rounding and serialize them with
+// the fewest digits that read back the same.
+// Parsing is slightly faster than the rounded mode: decimals with up to 15
+// digits and a small exponent take a single exact operation, and most others
+// a single product by a table of powers of ten. Serializing is about as fast,
+// and faster for values with up to 4 decimals, which take a shortcut. Values
+// that need all their 17 digits to read back the same are written with all
+// of them, when the rounded mode cuts at 9 decimal places.
+// The table costs about 11KB of Flash, so it's off on 8-bit targets.
+#ifndef ARDUINOJSON_USE_EXACT_FLOAT
+#  if defined(__SIZEOF_POINTER__) && __SIZEOF_POINTER__ >= 4 || \
+      defined(_MSC_VER)
+#    define ARDUINOJSON_USE_EXACT_FLOAT 1
+#  else
+#    define ARDUINOJSON_USE_EXACT_FLOAT 0
+#  endif
+#endif
+
 // Control the exponentiation threshold for big numbers
 // CAUTION: cannot be more that 1e9 !!!!
 #ifndef ARDUINOJSON_POSITIVE_EXPONENTIATION_THRESHOLD
@@ -191,6 +209,32 @@
 #  endif
 #endif
 
+// Scan character arrays a machine word at a time (saves time but costs Flash)
+#ifndef ARDUINOJSON_USE_SWAR
+#  if defined(__SIZEOF_POINTER__) && __SIZEOF_POINTER__ >= 4 || \
+      defined(_MSC_VER)
+#    define ARDUINOJSON_USE_SWAR 1
+#  else
+#    define ARDUINOJSON_USE_SWAR 0
+#  endif
+#endif
+
+// Hash the keys of objects that have at least this many members, so that
+// looking up a member doesn't compare every key (0 = never).
+// The index takes the room left in the document, so it's off by default:
+// documents sized with JSON_OBJECT_SIZE() could run short.
+#ifndef ARDUINOJSON_OBJECT_INDEX_THRESHOLD
+#  define ARDUINOJSON_OBJECT_INDEX_THRESHOLD 0
+#endif
+
+// The threshold itself doesn't change the layout of the document, so only
+// whether the index exists goes into the namespace
+#if ARDUINOJSON_OBJECT_INDEX_THRESHOLD
+#  define ARDUINOJSON_ENABLE_OBJECT_INDEX 1
+#else
+#  define ARDUINOJSON_ENABLE_OBJECT_INDEX 0
+#endif
+
 #ifndef ARDUINOJSON_TAB
 #  define ARDUINOJSON_TAB "  "
 #endif
@@ -199,6 +243,13 @@
 #  define ARDUINOJSON_ENABLE_STRING_DEDUPLICATION 1
 #endif
 
+// Hash the strings of the document, so that deduplicating a string doesn't
+// compare it with all the others (requires STRING_DEDUPLICATION).
+// The table takes room in the document, so it's off by default.
+#ifndef ARDUINOJSON_ENABLE_STRING_INDEX
+#  define ARDUINOJSON_ENABLE_STRING_INDEX 0
+#endif
+
 #ifndef ARDUINOJSON_STRING_BUFFER_SIZE
 #  define ARDUINOJSON_STRING_BUFFER_SIZE 32
 #endif
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <ArduinoJson/Namespace.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
 #include <ArduinoJson/Polyfills/utility.hpp>
 
 #include <stdlib.h>  // for size_t
@@ -37,6 +38,9 @@ struct BoundedReader {
   // constructor
 };
 
+template <typename TReader, typename Enable = void>
+struct IsContiguousReader : false_type {};
+
 ARDUINOJSON_END_PRIVATE_NAMESPACE
 
 #include <ArduinoJson/Deserialization/Readers/IteratorReader.hpp>
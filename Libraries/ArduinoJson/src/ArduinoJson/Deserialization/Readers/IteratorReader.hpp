@@ -27,6 +27,14 @@ class IteratorReader {
       buffer[i++] = *ptr_++;
     return i;
   }
+
+  TIterator ptr() const {
+    return ptr_;
+  }
+
+  TIterator end() const {
+    return end_;
+  }
 };
 
 template <typename T>
@@ -6,6 +6,8 @@
 
 #include <ArduinoJson/Polyfills/type_traits.hpp>
 
+#include <string.h>  // strlen
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
 template <typename T>
@@ -36,6 +38,14 @@ struct Reader<TSource*,
       buffer[i] = *ptr_++;
     return length;
   }
+
+  const char* ptr() const {
+    return ptr_;
+  }
+
+  const char* end() const {
+    return ptr_ + strlen(ptr_);
+  }
 };
 
 template <typename TSource>
@@ -48,4 +58,17 @@ struct BoundedReader<TSource*,
                                     reinterpret_cast<const char*>(ptr) + len) {}
 };
 
+// Readers of a character array that can be scanned ahead of the current
+// position: char pointers, bounded or not, and everything built upon them
+template <typename TSource>
+struct IsContiguousReader<
+    Reader<TSource*>, typename enable_if<IsCharOrVoid<TSource>::value>::type>
+    : true_type {};
+
+template <typename TReader>
+struct IsContiguousReader<
+    TReader, typename enable_if<
+                 is_base_of<IteratorReader<const char*>, TReader>::value>::type>
+    : true_type {};
+
 ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -286,6 +286,7 @@ class JsonDeserializer {
             return DeserializationError::NoMemory;
 
           slot->setKey(key);
+          object.indexMembers(pool_);
 
           variant = slot->data();
         }
@@ -408,6 +409,7 @@ class JsonDeserializer {
 
     move();
     for (;;) {
+      latch_.appendStringRun(stopChar, stringStorage_);
       char c = current();
       move();
       if (c == stopChar)
@@ -486,6 +488,7 @@ class JsonDeserializer {
 
     move();
     for (;;) {
+      latch_.skipStringRun(stopChar);
       char c = current();
       move();
       if (c == stopChar)
@@ -582,6 +585,7 @@ class JsonDeserializer {
 
   DeserializationError::Code skipSpacesAndComments() {
     for (;;) {
+      latch_.skipSpaces();
       switch (current()) {
         // end of string
         case '\0':
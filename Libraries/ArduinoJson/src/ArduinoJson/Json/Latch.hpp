@@ -4,11 +4,13 @@
 
 #pragma once
 
+#include <ArduinoJson/Deserialization/Reader.hpp>
+#include <ArduinoJson/Json/Swar.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
 
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
-template <typename TReader>
+template <typename TReader, typename Enable = void>
 class Latch {
  public:
   Latch(TReader reader) : reader_(reader), loaded_(false) {
@@ -32,6 +34,16 @@ class Latch {
     return current_;
   }
 
+  // The reader can only be read one character at a time, so these leave the
+  // runs to the caller
+
+  void skipSpaces() {}
+
+  template <typename TStringStorage>
+  void appendStringRun(char, TStringStorage&) {}
+
+  void skipStringRun(char) {}
+
  private:
   void load() {
     ARDUINOJSON_ASSERT(!ended_);
@@ -53,4 +65,50 @@ class Latch {
 #endif
 };
 
+// Reads straight from the character array, and scans runs of spaces and of
+// plain string characters without going through current() for each of them
+template <typename TReader>
+class Latch<TReader,
+            typename enable_if<IsContiguousReader<TReader>::value>::type> {
+ public:
+  Latch(TReader reader) : ptr_(reader.ptr()), end_(reader.end()) {}
+
+  void clear() {
+    ptr_++;
+  }
+
+  int last() const {
+    return ptr_ < end_ ? *ptr_ : 0;
+  }
+
+  FORCE_INLINE char current() {
+    return ptr_ < end_ ? *ptr_ : 0;
+  }
+
+  // Skips ' ', '\t', '\r' and '\n'
+  void skipSpaces() {
+    if (ptr_ < end_)
+      ptr_ = findNonSpace(ptr_, end_);
+  }
+
+  // Appends the characters up to the next stopChar, backslash, or NUL
+  template <typename TStringStorage>
+  void appendStringRun(char stopChar, TStringStorage& storage) {
+    if (ptr_ >= end_)
+      return;
+    const char* run = ptr_;
+    ptr_ = findStringSpecial(ptr_, end_, stopChar);
+    storage.append(run, size_t(ptr_ - run));
+  }
+
+  void skipStringRun(char stopChar) {
+    if (ptr_ < end_)
+      ptr_ = findStringSpecial(ptr_, end_, stopChar);
+  }
+
+ private:
+  const char* ptr_;
+  const char* end_;
+};
+
 ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -0,0 +1,134 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2023, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Namespace.hpp>
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uintptr_t
+#include <string.h>  // memcpy
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Tests all the bytes of a machine word at once ("SIMD within a register").
+// Each test returns a word with 0x80 in the bytes that pass and 0 elsewhere.
+class Swar {
+ public:
+  typedef size_t word_t;
+
+  static const word_t ones = word_t(-1) / 0xFF;  // 0x0101...01
+  static const word_t highs = ones * 0x80;       // 0x8080...80
+
+  static word_t broadcast(char c) {
+    return ones * static_cast<unsigned char>(c);
+  }
+
+  // Bytes strictly below n, with n <= 0x80
+  static word_t lessThan(word_t x, unsigned char n) {
+    return ~(((x & ~highs) + ones * (0x80 - n)) | x) & highs;
+  }
+
+  static word_t equal(word_t x, char c) {
+    return lessThan(x ^ broadcast(c), 1);
+  }
+
+  static bool isAligned(const char* p) {
+    return (reinterpret_cast<uintptr_t>(p) & (sizeof(word_t) - 1)) == 0;
+  }
+
+  // p must be aligned, so that targets without unaligned loads can use one
+  // load instruction
+  static word_t load(const char* p) {
+    word_t x;
+#ifdef __GNUC__
+    memcpy(&x, __builtin_assume_aligned(p, sizeof(word_t)), sizeof(word_t));
+#else
+    memcpy(&x, p, sizeof(word_t));
+#endif
+    return x;
+  }
+
+  // Offset of the first byte that passed a test, or of the word's end if
+  // none did
+  static size_t firstByte(word_t mask) {
+#if ARDUINOJSON_LITTLE_ENDIAN && defined(__GNUC__)
+    if (mask)
+      return size_t(__builtin_ctzll(mask)) / 8;
+    return sizeof(word_t);
+#else
+    for (size_t i = 0; i < sizeof(word_t); i++) {
+      size_t shift = ARDUINOJSON_LITTLE_ENDIAN ? 8 * i
+                                               : 8 * (sizeof(word_t) - 1 - i);
+      if ((mask >> shift) & 0x80)
+        return i;
+    }
+    return sizeof(word_t);
+#endif
+  }
+};
+
+// Returns the first character in [p, end) that is stopChar, a backslash, or a
+// NUL, or end if there is none
+inline const char* findStringSpecial(const char* p, const char* end,
+                                     char stopChar) {
+#if ARDUINOJSON_USE_SWAR
+  while (p < end && !Swar::isAligned(p)) {
+    if (*p == stopChar || *p == '\\' || *p == '\0')
+      return p;
+    p++;
+  }
+  while (end - p >= static_cast<ptrdiff_t>(sizeof(Swar::word_t))) {
+    Swar::word_t x = Swar::load(p);
+    Swar::word_t special = Swar::equal(x, stopChar) | Swar::equal(x, '\\') |
+                           Swar::lessThan(x, 1);
+    if (special)
+      return p + Swar::firstByte(special);
+    p += sizeof(Swar::word_t);
+  }
+#endif
+  while (p < end && *p != stopChar && *p != '\\' && *p != '\0')
+    p++;
+  return p;
+}
+
+// Tells if c may need to be escaped in a JSON string: a quote, a backslash,
+// or a control character
+inline bool isEscapeChar(char c) {
+  return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+// Returns the first character in [p, end) that isEscapeChar(), or end if there
+// is none
+inline const char* findEscapeChar(const char* p, const char* end) {
+#if ARDUINOJSON_USE_SWAR
+  while (p < end && !Swar::isAligned(p)) {
+    if (isEscapeChar(*p))
+      return p;
+    p++;
+  }
+  while (end - p >= static_cast<ptrdiff_t>(sizeof(Swar::word_t))) {
+    Swar::word_t x = Swar::load(p);
+    Swar::word_t special = Swar::equal(x, '"') | Swar::equal(x, '\\') |
+                           Swar::lessThan(x, 0x20);
+    if (special)
+      return p + Swar::firstByte(special);
+    p += sizeof(Swar::word_t);
+  }
+#endif
+  while (p < end && !isEscapeChar(*p))
+    p++;
+  return p;
+}
+
+// Returns the first character in [p, end) that isn't a space, a tab, a
+// carriage return or a line feed, or end if there is none.
+// Runs of spaces are short (indentation at most), so words don't pay off here.
+inline const char* findNonSpace(const char* p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+    p++;
+  return p;
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
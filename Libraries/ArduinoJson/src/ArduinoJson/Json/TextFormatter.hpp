@@ -8,8 +8,10 @@
 #include <string.h>  // for strlen
 
 #include <ArduinoJson/Json/EscapeSequence.hpp>
+#include <ArduinoJson/Json/Swar.hpp>
 #include <ArduinoJson/Numbers/FloatParts.hpp>
 #include <ArduinoJson/Numbers/JsonInteger.hpp>
+#include <ArduinoJson/Numbers/ShortestDecimal.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/attributes.hpp>
 #include <ArduinoJson/Polyfills/type_traits.hpp>
@@ -38,17 +40,36 @@ class TextFormatter {
 
   void writeString(const char* value) {
     ARDUINOJSON_ASSERT(value != NULL);
-    writeRaw('\"');
-    while (*value)
-      writeChar(*value++);
-    writeRaw('\"');
+    writeString(value, strlen(value));
   }
 
+  // Writes the runs that don't need escaping in one call to the TWriter
   void writeString(const char* value, size_t n) {
     ARDUINOJSON_ASSERT(value != NULL);
+    const char* end = value + n;
     writeRaw('\"');
-    while (n--)
-      writeChar(*value++);
+    for (;;) {
+      const char* special = findEscapeChar(value, end);
+      if (special != value)
+        writeRaw(value, special);
+      if (special == end)
+        break;
+      // escapes often come in a row, checking the next one is cheaper than
+      // searching again
+      value = special;
+      size_t escapes = 0;
+      do {
+        writeChar(*value++);
+        // in a string of escapes, the check costs more than it saves: write
+        // the next chars one by one, like writeChar() always did
+        if (++escapes >= denseEscapes) {
+          const char* stop =
+              end - value > denseChunk ? value + denseChunk : end;
+          while (value < stop)
+            writeChar(*value++);
+        }
+      } while (value < end && isEscapeChar(*value));
+    }
     writeRaw('\"');
   }
 
@@ -87,6 +108,64 @@ class TextFormatter {
     }
 #endif
 
+#if ARDUINOJSON_USE_EXACT_FLOAT
+    if (value == 0)
+      return writeRaw('0');
+
+    ShortestDecimal<T> decimal(value);
+
+    char buffer[24];
+    char* end = buffer + sizeof(buffer);
+    char* begin = end;
+
+    // write the digits in reverse order, by blocks of 8 to divide 32-bit
+    // integers only
+    while (decimal.significand >= 100000000) {
+      uint32_t block = uint32_t(decimal.significand % 100000000);
+      decimal.significand /= 100000000;
+      // two halves, so the divisions can run in parallel
+      uint32_t high = block / 10000, low = block % 10000;
+      for (int i = 0; i < 4; i++) {
+        begin[-1 - i] = char(low % 10 + '0');
+        begin[-5 - i] = char(high % 10 + '0');
+        low /= 10;
+        high /= 10;
+      }
+      begin -= 8;
+    }
+    uint32_t block = uint32_t(decimal.significand);
+    do {
+      *--begin = char(block % 10 + '0');
+      block /= 10;
+    } while (block);
+
+    int digits = int(end - begin);
+    int exponent = decimal.exponent;
+
+    if (value >= ARDUINOJSON_POSITIVE_EXPONENTIATION_THRESHOLD ||
+        value <= ARDUINOJSON_NEGATIVE_EXPONENTIATION_THRESHOLD) {
+      writeRaw(*begin);
+      if (digits > 1) {
+        writeRaw('.');
+        writeRaw(begin + 1, end);
+      }
+      writeRaw('e');
+      writeInteger(exponent + digits - 1);
+    } else if (exponent >= 0) {
+      writeRaw(begin, end);
+      while (exponent--)
+        writeRaw('0');
+    } else if (digits + exponent > 0) {
+      writeRaw(begin, end + exponent);
+      writeRaw('.');
+      writeRaw(end + exponent, end);
+    } else {
+      writeRaw("0.");
+      for (int i = digits + exponent; i < 0; i++)
+        writeRaw('0');
+      writeRaw(begin, end);
+    }
+#else
     FloatParts<T> parts(value);
 
     writeInteger(parts.integral);
@@ -97,6 +176,7 @@ class TextFormatter {
       writeRaw('e');
       writeInteger(parts.exponent);
     }
+#endif
   }
 
   template <typename T>
@@ -168,6 +248,12 @@ class TextFormatter {
 
  protected:
   CountingDecorator<TWriter> writer_;
+
+ private:
+  // Escapes in a row after which writeString() stops checking for a while,
+  // and the number of chars it then writes without checking
+  static const size_t denseEscapes = 4;
+  static const ptrdiff_t denseChunk = 64;
 };
 
 ARDUINOJSON_END_PRIVATE_NAMESPACE
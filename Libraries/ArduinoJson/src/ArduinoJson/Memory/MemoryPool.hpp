@@ -5,12 +5,13 @@
 #pragma once
 
 #include <ArduinoJson/Memory/Alignment.hpp>
+#include <ArduinoJson/Memory/StringIndex.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/mpl/max.hpp>
 #include <ArduinoJson/Strings/StringAdapters.hpp>
 #include <ArduinoJson/Variant/VariantSlot.hpp>
 
-#include <string.h>  // memmove
+#include <string.h>  // memmove, strlen
 
 #define JSON_STRING_SIZE(SIZE) (SIZE + 1)
 
@@ -41,6 +42,9 @@ class MemoryPool {
         left_(buf),
         right_(buf ? buf + capa : 0),
         end_(buf ? buf + capa : 0),
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+        strings_(0),
+#endif
         overflowed_(false) {
     ARDUINOJSON_ASSERT(isAligned(begin_));
     ARDUINOJSON_ASSERT(isAligned(right_));
@@ -69,6 +73,14 @@ class MemoryPool {
     return allocRight<VariantSlot>();
   }
 
+  // Allocates n consecutive slots for data the document can do without, so
+  // it doesn't mark the pool as overflowed if they don't fit
+  VariantSlot* allocOptionalVariants(size_t n) {
+    if (!canAlloc(n * sizeof(VariantSlot)))
+      return 0;
+    return reinterpret_cast<VariantSlot*>(allocRight(n * sizeof(VariantSlot)));
+  }
+
   template <typename TAdaptedString>
   const char* saveString(TAdaptedString str) {
     if (str.isNull())
@@ -86,6 +98,7 @@ class MemoryPool {
     if (newCopy) {
       stringGetChars(str, newCopy, n);
       newCopy[n] = 0;  // force null-terminator
+      indexStrings();
     }
     return newCopy;
   }
@@ -106,6 +119,7 @@ class MemoryPool {
     left_ += len;
     *left_++ = 0;
     checkInvariants();
+    indexStrings();
     return str;
   }
 
@@ -116,6 +130,9 @@ class MemoryPool {
   void clear() {
     left_ = begin_;
     right_ = end_;
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    strings_ = 0;
+#endif
     overflowed_ = false;
   }
 
@@ -154,6 +171,11 @@ class MemoryPool {
     ptrdiff_t bytes_reclaimed = right_ - new_right;
     right_ = new_right;
     end_ = new_right + right_size;
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    if (strings_)
+      strings_ = reinterpret_cast<StringIndex*>(
+          reinterpret_cast<char*>(strings_) - bytes_reclaimed);
+#endif
     return bytes_reclaimed;
   }
 
@@ -164,6 +186,11 @@ class MemoryPool {
     left_ += offset;
     right_ += offset;
     end_ += offset;
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    if (strings_)
+      strings_ = reinterpret_cast<StringIndex*>(
+          reinterpret_cast<char*>(strings_) + offset);
+#endif
   }
 
  private:
@@ -178,7 +205,16 @@ class MemoryPool {
   template <typename TAdaptedString>
   const char* findString(const TAdaptedString& str) const {
     size_t n = str.size();
-    for (char* next = begin_; next + n < left_; ++next) {
+    char* next = begin_;
+#  if ARDUINOJSON_ENABLE_STRING_INDEX
+    if (strings_) {
+      const char* s = strings_->find(begin_, str, stringHash(str));
+      if (s)
+        return s;
+      next += strings_->end();
+    }
+#  endif
+    for (; next + n < left_; ++next) {
       if (next[n] == '\0' && stringEquals(str, adaptString(next, n)))
         return next;
 
@@ -190,6 +226,47 @@ class MemoryPool {
   }
 #endif
 
+  // Adds the strings saved since the last call to the table
+  void indexStrings() {
+#if ARDUINOJSON_ENABLE_STRING_DEDUPLICATION && ARDUINOJSON_ENABLE_STRING_INDEX
+    if (strings_)
+      addStringsToIndex();
+    else if (left_ - begin_ >= 512)  // a few strings are faster to scan
+      createStringIndex();
+#endif
+  }
+
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+  void createStringIndex() {
+    strings_ = allocStringIndex(32);
+    if (strings_)
+      addStringsToIndex();
+  }
+
+  void addStringsToIndex() {
+    while (begin_ + strings_->end() < left_) {
+      if (strings_->full()) {
+        // if there is no room, keep the old table and scan the rest
+        StringIndex* bigger = allocStringIndex(strings_->capacity() * 2);
+        if (!bigger)
+          return;
+        strings_->copyTo(bigger);
+        strings_ = bigger;
+      }
+      const char* s = begin_ + strings_->end();
+      size_t n = strlen(s);
+      strings_->add(n + 1, stringHash(adaptString(s, n)));
+    }
+  }
+
+  StringIndex* allocStringIndex(size_t capacity) {
+    VariantSlot* p = allocOptionalVariants(
+        (StringIndex::sizeFor(capacity) + sizeof(VariantSlot) - 1) /
+        sizeof(VariantSlot));
+    return p ? StringIndex::create(p, capacity) : 0;
+  }
+#endif
+
   char* allocString(size_t n) {
     if (!canAlloc(n)) {
       overflowed_ = true;
@@ -216,6 +293,9 @@ class MemoryPool {
   }
 
   char *begin_, *left_, *right_, *end_;
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+  StringIndex* strings_;
+#endif
   bool overflowed_;
 };
 
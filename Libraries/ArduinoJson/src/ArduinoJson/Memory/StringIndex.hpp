@@ -0,0 +1,106 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2023, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Polyfills/assert.hpp>
+#include <ArduinoJson/Strings/StringAdapters.hpp>
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint32_t
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// A hash table of the strings of a MemoryPool, so that deduplication doesn't
+// compare every string.
+// It's allocated with the variants and refers to each string by its offset
+// from the beginning of the pool, so it survives squash() and realloc.
+// It covers the strings up to end(); the ones after are searched one by one.
+class StringIndex {
+ public:
+  static size_t sizeFor(size_t capacity) {
+    return sizeof(StringIndex) + capacity * sizeof(Entry);
+  }
+
+  // p must have sizeFor(capacity) bytes
+  static StringIndex* create(void* p, size_t capacity) {
+    StringIndex* index = reinterpret_cast<StringIndex*>(p);
+    index->end_ = 0;
+    index->size_ = 0;
+    index->capacity_ = capacity;
+    for (size_t i = 0; i < capacity; i++)
+      index->entries()[i].offset = 0;
+    return index;
+  }
+
+  // Offset of the first string that isn't in the table
+  size_t end() const {
+    return end_;
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  bool full() const {
+    return size_ >= capacity_ / 4 * 3;
+  }
+
+  template <typename TAdaptedString>
+  const char* find(const char* begin, TAdaptedString str, uint32_t hash) const {
+    size_t n = str.size();
+    size_t mask = capacity_ - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      const Entry& entry = entries()[i];
+      if (!entry.offset)
+        return 0;
+      const char* s = begin + entry.offset - 1;
+      if (entry.hash == hash && s[n] == '\0' &&
+          stringEquals(str, adaptString(s, n)))
+        return s;
+    }
+  }
+
+  // Adds the string at end(), which takes size bytes with its terminator
+  void add(size_t size, uint32_t hash) {
+    ARDUINOJSON_ASSERT(!full());
+    insert(end_, hash);
+    end_ += size;
+  }
+
+  // Moves the entries to a bigger table
+  void copyTo(StringIndex* bigger) const {
+    for (size_t i = 0; i < capacity_; i++) {
+      const Entry& entry = entries()[i];
+      if (entry.offset)
+        bigger->insert(entry.offset - 1, entry.hash);
+    }
+    bigger->end_ = end_;
+  }
+
+ private:
+  struct Entry {
+    uint32_t hash;
+    uint32_t offset;  // plus one, so that zero means empty
+  };
+
+  void insert(size_t offset, uint32_t hash) {
+    size_t mask = capacity_ - 1;
+    size_t i = hash & mask;
+    while (entries()[i].offset)
+      i = (i + 1) & mask;
+    entries()[i].hash = hash;
+    entries()[i].offset = uint32_t(offset + 1);
+    size_++;
+  }
+
+  Entry* entries() const {
+    return reinterpret_cast<Entry*>(const_cast<StringIndex*>(this + 1));
+  }
+
+  size_t end_;
+  size_t size_, capacity_;  // capacity_ is a power of two
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -502,6 +502,7 @@ class MsgPackDeserializer {
           return DeserializationError::NoMemory;
 
         slot->setKey(key);
+        object->indexMembers(pool_);
 
         member = slot->data();
       } else {
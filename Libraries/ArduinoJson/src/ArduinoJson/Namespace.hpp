@@ -19,7 +19,12 @@
         ARDUINOJSON_BIN2ALPHA(                                                \
             ARDUINOJSON_ENABLE_NAN, ARDUINOJSON_ENABLE_INFINITY,              \
             ARDUINOJSON_ENABLE_COMMENTS, ARDUINOJSON_DECODE_UNICODE),         \
-        ARDUINOJSON_SLOT_OFFSET_SIZE)
+        ARDUINOJSON_CONCAT2(                                                  \
+            ARDUINOJSON_BIN2ALPHA(                                            \
+                ARDUINOJSON_ENABLE_OBJECT_INDEX,                              \
+                ARDUINOJSON_ENABLE_STRING_INDEX, ARDUINOJSON_USE_EXACT_FLOAT, \
+                ARDUINOJSON_USE_SWAR),                                        \
+            ARDUINOJSON_SLOT_OFFSET_SIZE))
 
 #endif
 
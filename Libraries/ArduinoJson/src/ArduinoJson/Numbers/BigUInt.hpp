@@ -0,0 +1,93 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2023, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Polyfills/assert.hpp>
+
+#include <stddef.h>  // size_t
+#include <stdint.h>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// An unsigned integer big enough to compare a decimal number of up to 769
+// digits with the midpoint between two doubles (about 2600 bits).
+class BigUInt {
+ public:
+  explicit BigUInt(uint64_t value) : size_(0) {
+    while (value) {
+      push(uint32_t(value));
+      value >>= 32;
+    }
+  }
+
+  // *this = *this * factor + addend
+  void multiplyAdd(uint32_t factor, uint32_t addend) {
+    uint64_t carry = addend;
+    for (size_t i = 0; i < size_; i++) {
+      carry += uint64_t(limbs_[i]) * factor;
+      limbs_[i] = uint32_t(carry);
+      carry >>= 32;
+    }
+    if (carry)
+      push(uint32_t(carry));
+  }
+
+  void multiplyByPowerOfFive(int32_t n) {
+    for (; n >= 13; n -= 13)
+      multiplyAdd(1220703125, 0);  // 5^13
+    uint32_t factor = 1;
+    while (n--)
+      factor *= 5;
+    multiplyAdd(factor, 0);
+  }
+
+  void shiftLeft(int32_t n) {
+    if (!size_)
+      return;
+    size_t words = size_t(n) / 32;
+    int bits = n % 32;
+    if (bits) {
+      uint32_t carry = 0;
+      for (size_t i = 0; i < size_; i++) {
+        uint32_t limb = limbs_[i];
+        limbs_[i] = (limb << bits) | carry;
+        carry = limb >> (32 - bits);
+      }
+      if (carry)
+        push(carry);
+    }
+    if (words) {
+      ARDUINOJSON_ASSERT(size_ + words <= capacity);
+      for (size_t i = size_; i-- > 0;)
+        limbs_[i + words] = limbs_[i];
+      for (size_t i = 0; i < words; i++)
+        limbs_[i] = 0;
+      size_ += words;
+    }
+  }
+
+  // Returns -1, 0 or 1
+  int compare(const BigUInt& other) const {
+    if (size_ != other.size_)
+      return size_ < other.size_ ? -1 : 1;
+    for (size_t i = size_; i-- > 0;) {
+      if (limbs_[i] != other.limbs_[i])
+        return limbs_[i] < other.limbs_[i] ? -1 : 1;
+    }
+    return 0;
+  }
+
+ private:
+  void push(uint32_t limb) {
+    ARDUINOJSON_ASSERT(size_ < capacity);
+    limbs_[size_++] = limb;
+  }
+
+  static const size_t capacity = 84;
+  uint32_t limbs_[capacity];
+  size_t size_;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -0,0 +1,183 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2023, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Numbers/FloatTraits.hpp>
+#include <ArduinoJson/Numbers/powersOfTen.hpp>
+#include <ArduinoJson/Polyfills/alias_cast.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// The decimal with the fewest digits that reads back as the value (the closest
+// one if there are several), as significand * 10^exponent.
+// It uses Raffaello Giulietti's Schubfach algorithm; the value must be finite
+// and strictly positive.
+template <typename TFloat>
+struct ShortestDecimal {
+  typedef typename FloatTraits<TFloat>::mantissa_type mantissa_type;
+
+  mantissa_type significand;
+  int16_t exponent;
+
+  ShortestDecimal(TFloat value) {
+    if (fromFewDecimals(value))
+      return;
+
+    typedef FloatTraits<TFloat> traits;
+    const int mantissaBits = traits::mantissa_bits;
+    const int bias =
+        (1 << (8 * sizeof(TFloat) - mantissaBits - 2)) - 1 + mantissaBits;
+
+    mantissa_type bits = alias_cast<mantissa_type>(value);
+    mantissa_type fraction = bits & traits::mantissa_max;
+    int biasedExponent = int(bits >> mantissaBits);
+
+    // value = c * 2^q
+    mantissa_type c = fraction;
+    int q = 1 - bias;
+    if (biasedExponent) {
+      c |= mantissa_type(1) << mantissaBits;
+      q = biasedExponent - bias;
+    }
+
+    // the values that read back as value are in [cbl, cbr] * 2^(q-2),
+    // bounds included if c is even
+    mantissa_type even = (c & 1) == 0;
+    bool lowerIsCloser = fraction == 0 && biasedExponent > 1;
+    mantissa_type cbl = 4 * c - 2 + lowerIsCloser;
+    mantissa_type cb = 4 * c;
+    mantissa_type cbr = 4 * c + 2;
+
+    // k = floor(log10(2^q)), or floor(log10(3/4 * 2^q)) if lowerIsCloser
+    int k = (q * 1262611 - (lowerIsCloser ? 524031 : 0)) >> 22;
+    int h = q + floorLog2PowerOfTen(-k) + 1;
+    UInt128 g = powerOfTen(-k);
+
+    // the same values scaled by 10^-k * 4
+    mantissa_type vbl = roundToOdd(g, mantissa_type(cbl << h));
+    mantissa_type vb = roundToOdd(g, mantissa_type(cb << h));
+    mantissa_type vbr = roundToOdd(g, mantissa_type(cbr << h));
+    mantissa_type lower = vbl + 1 - even;
+    mantissa_type upper = vbr - 1 + even;
+
+    mantissa_type s = vb / 4;
+    exponent = int16_t(k);
+    if (s >= 10) {
+      // try with one digit less
+      mantissa_type sp = s / 10;
+      bool upInside = lower <= 40 * sp;
+      bool wpInside = 40 * sp + 40 <= upper;
+      if (upInside != wpInside) {
+        significand = sp + wpInside;
+        exponent++;
+        removeTrailingZeros();
+        return;
+      }
+    }
+
+    bool uInside = lower <= 4 * s;
+    bool wInside = 4 * s + 4 <= upper;
+    if (uInside != wInside) {
+      significand = s + wInside;
+    } else {
+      // both s and s + 1 read back as value: take the closest
+      mantissa_type mid = 4 * s + 2;
+      bool roundUp = vb > mid || (vb == mid && (s & 1) != 0);
+      significand = s + roundUp;
+    }
+    removeTrailingZeros();
+  }
+
+ private:
+  // Values with a few decimals, like prices or sensor readings: if value *
+  // 10^k is an integer n with fewer digits than TFloat has, no other decimal
+  // that short is within an ulp, so n * 10^-k is the shortest if it reads
+  // back as value, which one division tells since n and 10^k are exact.
+  bool fromFewDecimals(TFloat value) {
+    const TFloat maxInteger = sizeof(TFloat) >= 8 ? 1e15 : 1e6;
+    const TFloat factors[] = {1, 10, 100, 1000, 10000};
+    const int maxDecimals = 4;
+
+    // value * 10^4 is then within a few ulps of an integer, which a value
+    // with more digits rarely is: one product rules most of them out
+    TFloat scaled = value * factors[maxDecimals];
+    if (scaled >= maxInteger * factors[maxDecimals])
+      return false;
+    TFloat distance = scaled - TFloat(uint64_t(scaled + TFloat(0.5)));
+    TFloat tolerance = scaled * (sizeof(TFloat) >= 8 ? TFloat(1e-15) : 1e-6f);
+    if (distance > tolerance || -distance > tolerance)
+      return false;
+
+    for (int k = 0; k <= maxDecimals; k++) {
+      scaled = value * factors[k];
+      if (scaled >= maxInteger)
+        return false;
+      mantissa_type n = mantissa_type(scaled);
+      if (TFloat(n) == scaled && TFloat(n) / factors[k] == value) {
+        significand = n;
+        exponent = int16_t(-k);
+        if (k == 0)  // the other ones would have been found with a smaller k
+          removeTrailingZeros();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void removeTrailingZeros() {
+    // significand = high * 10^8 + low, so that we divide 32-bit integers only
+    if (sizeof(mantissa_type) > 4 && significand >= 100000000) {
+      mantissa_type high = significand / 100000000;
+      uint32_t low = uint32_t(significand - high * 100000000);
+      if (low) {
+        uint32_t factor = 100000000;
+        while (low % 10 == 0) {
+          low /= 10;
+          factor /= 10;
+          exponent++;
+        }
+        significand = high * factor + low;
+        return;
+      }
+      significand = high;
+      exponent = int16_t(exponent + 8);
+    }
+    uint32_t value = uint32_t(significand);  // less than 10^9
+    if (value % 10000 == 0) {
+      value /= 10000;
+      exponent = int16_t(exponent + 4);
+    }
+    while (value % 10 == 0) {
+      value /= 10;
+      exponent++;
+    }
+    significand = value;
+  }
+
+  // Returns the upper bits of g * cp, with the lowest bit set if any of the
+  // other bits is, where g is powerOfTen() + 1 truncated to the precision
+  static uint64_t roundToOdd(UInt128 g, uint64_t cp) {
+    g.low++;
+    if (!g.low)
+      g.high++;
+    UInt128 x = multiply(g.low, cp);
+    UInt128 y = multiply(g.high, cp);
+    uint64_t z = y.low + x.high;
+    uint64_t vbp = y.high + (z < y.low);
+    return vbp | (z > 1);
+  }
+
+  static uint32_t roundToOdd(UInt128 g, uint32_t cp) {
+    uint64_t g64 = g.high + 1;
+    uint64_t b01 = uint64_t(cp) * uint32_t(g64);
+    uint64_t b11 = uint64_t(cp) * (g64 >> 32);
+    uint64_t hi = b11 + (b01 >> 32);
+    uint32_t y1 = uint32_t(hi >> 32);
+    uint32_t y0 = uint32_t(hi);
+    return y1 | (y0 > 1);
+  }
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -0,0 +1,305 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2023, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Numbers/BigUInt.hpp>
+#include <ArduinoJson/Numbers/FloatTraits.hpp>
+#include <ArduinoJson/Numbers/powersOfTen.hpp>
+#include <ArduinoJson/Polyfills/attributes.hpp>
+#include <ArduinoJson/Polyfills/ctype.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// A float as significand * 2^exponent, before encoding
+struct BinaryFloat {
+  uint64_t significand;
+  int exponent;
+
+  bool operator==(const BinaryFloat& other) const {
+    return significand == other.significand && exponent == other.exponent;
+  }
+};
+
+template <typename TFloat>
+struct BinaryFormat {
+  static const int mantissaBits = FloatTraits<TFloat>::mantissa_bits;
+  static const int exponentBits = 8 * sizeof(TFloat) - 1 - mantissaBits;
+
+  // the exponent of the subnormals
+  static const int minExponent = 2 - (1 << (exponentBits - 1)) - mantissaBits;
+
+  // the largest power of ten that is exact
+  static const int maxExactPowerOfTen = sizeof(TFloat) >= 8 ? 22 : 10;
+
+  static void normalize(BinaryFloat& f) {
+    if (f.significand >> (mantissaBits + 1)) {
+      f.significand >>= 1;
+      f.exponent++;
+    }
+  }
+
+  static TFloat encode(BinaryFloat f) {
+    typedef FloatTraits<TFloat> traits;
+    typedef typename traits::mantissa_type bits_type;
+    if (!(f.significand >> mantissaBits))  // subnormal
+      return traits::forge(bits_type(f.significand));
+    bits_type biasedExponent = bits_type(f.exponent - minExponent + 1);
+    if (biasedExponent >= (bits_type(1) << exponentBits) - 1)
+      return traits::inf();
+    return traits::forge(bits_type(biasedExponent << mantissaBits |
+                                   (f.significand & traits::mantissa_max)));
+  }
+};
+
+// 10^n, for n up to BinaryFormat<TFloat>::maxExactPowerOfTen
+template <typename TFloat>
+inline TFloat exactPowerOfTen(int n) {
+  ARDUINOJSON_DEFINE_PROGMEM_ARRAY(
+      double, powers,
+      {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22});
+  return TFloat(pgm_ptr<double>(powers)[n]);
+}
+
+inline int countLeadingZeros(uint64_t x) {
+#ifdef __GNUC__
+  return __builtin_clzll(x);
+#else
+  int n = 0;
+  while (!(x >> 63)) {
+    x <<= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+// Rounds x * 2^e to the nearest float, ties to even.
+// x has 192 bits, x[0] being the most significant word, and is at least 2^190.
+template <typename TFloat>
+inline BinaryFloat roundProduct(const uint64_t (&x)[3], int e) {
+  typedef BinaryFormat<TFloat> format;
+  BinaryFloat result;
+  result.exponent = (x[0] >> 63 ? 191 : 190) + e - format::mantissaBits;
+  if (result.exponent < format::minExponent)
+    result.exponent = format::minExponent;
+  int shift = result.exponent - e;
+  if (shift > 192) {  // less than half of the smallest subnormal
+    result.significand = 0;
+    return result;
+  }
+  result.significand = shift < 192 ? x[0] >> (shift - 128) : 0;
+  uint64_t rest = x[0] << (192 - shift);  // the bits below, left-aligned
+  bool aboveHalf = (rest << 1) != 0 || x[1] != 0 || x[2] != 0;
+  if ((rest >> 63) && (aboveHalf || (result.significand & 1)))
+    result.significand++;
+  format::normalize(result);
+  return result;
+}
+
+// Rounds w * 10^q, which must be in the range of the table (Eisel-Lemire).
+// The table is truncated, so the product is between two bounds: returns false
+// if they round differently, result being the rounding of the lower one.
+template <typename TFloat>
+inline bool roundDecimal(uint64_t w, int q, BinaryFloat& result) {
+  int lz = countLeadingZeros(w);
+  w <<= lz;
+  UInt128 g = powerOfTen(q);
+  UInt128 low = multiply(w, g.low);
+  UInt128 high = multiply(w, g.high);
+  uint64_t x[3];
+  x[2] = low.low;
+  x[1] = low.high + high.low;
+  x[0] = high.high + (x[1] < high.low);
+  int e = floorLog2PowerOfTen(q) - 127 - lz;
+  result = roundProduct<TFloat>(x, e);
+  if (q >= 0 && q <= 55)  // the table is exact
+    return true;
+
+  // upper bound: w * (g + 1)
+  x[2] += w;
+  if (x[2] < w && ++x[1] == 0)
+    x[0]++;
+  return roundProduct<TFloat>(x, e) == result;
+}
+
+// Rounds w * 10^q like roundDecimal(), with a single 64-bit product by the
+// high word of the table. Returns false when the bits past the rounding bit
+// are too close to 0 or to a carry to decide, or when the result is subnormal.
+template <typename TFloat>
+inline bool roundDecimalFast(uint64_t w, int q, BinaryFloat& result) {
+  typedef BinaryFormat<TFloat> format;
+  int lz = countLeadingZeros(w);
+  UInt128 product = multiply(w << lz, powerOfTen(q).high);
+  int shift = int(product.high >> 63) + 62 - format::mantissaBits;
+  uint64_t halfBit = uint64_t(1) << (shift - 1);
+  uint64_t rest = product.high & (halfBit - 1);
+
+  // the low words of the product and the truncation of the table add at most
+  // 2 to product.high, this can't carry to the rounding bit nor make a tie
+  if (rest == 0 || rest >= halfBit - 2)
+    return false;
+
+  // the rounding bit is 0 or 1 at random, it is added without a branch
+  result.significand =
+      (product.high >> shift) + ((product.high >> (shift - 1)) & 1);
+  result.exponent = floorLog2PowerOfTen(q) + 1 - lz + shift;
+  format::normalize(result);
+  return result.exponent >= format::minExponent;
+}
+
+// Decides between candidate and the next float by comparing the midpoint with
+// the exact value of the digits
+template <typename TFloat>
+inline BinaryFloat roundDigits(const char* s, uint64_t w, int32_t q,
+                               bool truncated, BinaryFloat candidate) {
+  const int maxDigits = 768;
+  BinaryFloat result = candidate;
+  BigUInt value(truncated ? 0 : w);
+  if (truncated) {
+    // read all the digits again
+    int digits = 0;
+    uint32_t chunk = 0, chunkFactor = 1;
+    bool sticky = false;
+    for (; isdigit(*s) || *s == '.'; s++) {
+      if (*s == '.' || (*s == '0' && digits == 0))
+        continue;
+      if (digits == maxDigits) {
+        sticky |= *s != '0';
+        continue;
+      }
+      chunk = chunk * 10 + uint32_t(*s - '0');
+      chunkFactor *= 10;
+      digits++;
+      if (chunkFactor == 1000000000) {
+        value.multiplyAdd(chunkFactor, chunk);
+        chunk = 0;
+        chunkFactor = 1;
+      }
+    }
+    value.multiplyAdd(chunkFactor, chunk);
+    q -= digits - 19;
+    if (sticky) {
+      // the digits past maxDigits can't make the value equal to the midpoint
+      value.multiplyAdd(10, 1);
+      q--;
+    }
+  }
+
+  // compare value * 10^q with (2 * significand + 1) * 2^(exponent - 1)
+  BigUInt midpoint(2 * candidate.significand + 1);
+  if (q >= 0)
+    value.multiplyByPowerOfFive(q);
+  else
+    midpoint.multiplyByPowerOfFive(-q);
+  int32_t shift = q - candidate.exponent + 1;
+  if (shift >= 0)
+    value.shiftLeft(shift);
+  else
+    midpoint.shiftLeft(-shift);
+
+  int comparison = value.compare(midpoint);
+  if (comparison > 0 || (comparison == 0 && (candidate.significand & 1))) {
+    result.significand++;
+    BinaryFormat<TFloat>::normalize(result);
+  }
+  return result;
+}
+
+// Rounds w * 10^q when a single product can't: with both bounds or with all
+// the digits. Kept out of line, so that the parser stays small.
+template <typename TFloat>
+NO_INLINE BinaryFloat roundDecimalOutOfLine(const char* s, uint64_t w,
+                                            int32_t q, bool truncated) {
+  BinaryFloat result;
+  bool exact = roundDecimal<TFloat>(w, q, result);
+  if (truncated) {
+    // the exact significand is between w and w + 1
+    BinaryFloat upper;
+    exact = roundDecimal<TFloat>(w + 1, q, upper) && exact && upper == result;
+  }
+  if (!exact)
+    result = roundDigits<TFloat>(s, w, q, truncated, result);
+  return result;
+}
+
+// Returns the float closest to w * 10^q, where w has the first 19 significant
+// digits of the number that starts at s, and truncated tells if it has other
+// digits than zeros after them.
+template <typename TFloat>
+inline TFloat decimalToFloat(const char* s, uint64_t w, int32_t q,
+                             bool truncated) {
+  typedef BinaryFormat<TFloat> format;
+
+  // both w and 10^q are exact, so one operation rounds correctly
+  if (!truncated && w >> (format::mantissaBits + 1) == 0 &&
+      q >= -format::maxExactPowerOfTen && q <= format::maxExactPowerOfTen) {
+    return q < 0 ? TFloat(w) / exactPowerOfTen<TFloat>(-q)
+                 : TFloat(w) * exactPowerOfTen<TFloat>(q);
+  }
+
+  if (w == 0 || q < powerOfTenMin)
+    return 0;
+  if (q > 308)
+    return FloatTraits<TFloat>::inf();
+
+  BinaryFloat result;
+  if (!truncated && roundDecimalFast<TFloat>(w, q, result))
+    return format::encode(result);
+  return format::encode(roundDecimalOutOfLine<TFloat>(s, w, q, truncated));
+}
+
+// Parses the rest of a number without sign that starts at digits, s being
+// after its first digits whose value is w (less than 10^19)
+template <typename TFloat>
+inline bool parseDecimal(const char* digits, const char* s, uint64_t w,
+                         TFloat& result) {
+  const uint64_t maxW = 1000000000000000000;  // w has at most 19 digits
+  int32_t q = 0;
+  bool truncated = false;
+
+  for (; isdigit(*s) && w < maxW; s++)
+    w = w * 10 + uint8_t(*s - '0');
+  for (; isdigit(*s); s++) {
+    truncated |= *s != '0';
+    q++;
+  }
+
+  if (*s == '.') {
+    s++;
+    const char* fraction = s;
+    for (; isdigit(*s) && w < maxW; s++)
+      w = w * 10 + uint8_t(*s - '0');
+    q -= int32_t(s - fraction);
+    for (; isdigit(*s); s++)
+      truncated |= *s != '0';
+  }
+
+  if (*s == 'e' || *s == 'E') {
+    s++;
+    bool negativeExponent = false;
+    if (*s == '-') {
+      negativeExponent = true;
+      s++;
+    } else if (*s == '+') {
+      s++;
+    }
+    int32_t exponent = 0;
+    for (; isdigit(*s); s++) {
+      if (exponent < 100000)  // already out of range
+        exponent = exponent * 10 + (*s - '0');
+    }
+    q += negativeExponent ? -exponent : exponent;
+  }
+
+  // we should be at the end of the string, otherwise it's an error
+  if (*s != '\0')
+    return false;
+
+  result = decimalToFloat<TFloat>(digits, w, q, truncated);
+  return true;
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -6,6 +6,7 @@
 
 #include <ArduinoJson/Numbers/FloatTraits.hpp>
 #include <ArduinoJson/Numbers/convertNumber.hpp>
+#include <ArduinoJson/Numbers/decimalToFloat.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/ctype.hpp>
 #include <ArduinoJson/Polyfills/math.hpp>
@@ -21,7 +22,6 @@ struct choose_largest : conditional<(sizeof(A) > sizeof(B)), A, B> {};
 inline bool parseNumber(const char* s, VariantData& result) {
   typedef FloatTraits<JsonFloat> traits;
   typedef choose_largest<traits::mantissa_type, JsonUInt>::type mantissa_t;
-  typedef traits::exponent_type exponent_t;
 
   ARDUINOJSON_ASSERT(s != 0);
 
@@ -53,8 +53,10 @@ inline bool parseNumber(const char* s, VariantData& result) {
   if (!isdigit(*s) && *s != '.')
     return false;
 
+#if ARDUINOJSON_USE_EXACT_FLOAT
+  const char* digits = s;
+#endif
   mantissa_t mantissa = 0;
-  exponent_t exponent_offset = 0;
   const mantissa_t maxUint = JsonUInt(-1);
 
   while (isdigit(*s)) {
@@ -82,6 +84,21 @@ inline bool parseNumber(const char* s, VariantData& result) {
     }
   }
 
+#if ARDUINOJSON_USE_EXACT_FLOAT
+  // continue after the integral part, unless it overflowed or has more than
+  // 19 digits
+  if (isdigit(*s) || s - digits > 19) {
+    s = digits;
+    mantissa = 0;
+  }
+
+  JsonFloat final_result;
+  if (!parseDecimal(digits, s, uint64_t(mantissa), final_result))
+    return false;
+#else
+  typedef traits::exponent_type exponent_t;
+  exponent_t exponent_offset = 0;
+
   // avoid mantissa overflow
   while (mantissa > traits::mantissa_max) {
     mantissa /= 10;
@@ -138,6 +155,7 @@ inline bool parseNumber(const char* s, VariantData& result) {
 
   JsonFloat final_result =
       make_float(static_cast<JsonFloat>(mantissa), exponent);
+#endif
 
   result.setFloat(is_negative ? -final_result : final_result);
   return true;
@@ -30,10 +30,19 @@ class Writer<::String, void> {
   }
 
   size_t write(const uint8_t* s, size_t n) {
-    for (size_t i = 0; i < n; i++) {
-      write(s[i]);
+    size_t written = 0;
+    while (written < n) {
+      if (size_ + 1 >= bufferCapacity)
+        if (flush() != 0)
+          break;
+      size_t chunk = bufferCapacity - 1 - size_;
+      if (chunk > n - written)
+        chunk = n - written;
+      memcpy(buffer_ + size_, s + written, chunk);
+      size_ += chunk;
+      written += chunk;
     }
-    return n;
+    return written;
   }
 
   size_t flush() {
@@ -6,6 +6,8 @@
 
 #include <ArduinoJson/Namespace.hpp>
 
+#include <string.h>  // memcpy
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
 class StaticStringWriter {
@@ -20,12 +22,11 @@ class StaticStringWriter {
   }
 
   size_t write(const uint8_t* s, size_t n) {
-    char* begin = p;
-    while (p < end && n > 0) {
-      *p++ = static_cast<char>(*s++);
-      n--;
-    }
-    return size_t(p - begin);
+    if (n > size_t(end - p))
+      n = size_t(end - p);
+    memcpy(p, s, n);
+    p += n;
+    return n;
   }
 
  private:
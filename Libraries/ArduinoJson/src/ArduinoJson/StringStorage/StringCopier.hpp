@@ -6,6 +6,8 @@
 
 #include <ArduinoJson/Memory/MemoryPool.hpp>
 
+#include <string.h>  // memcpy
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
 class StringCopier {
@@ -32,6 +34,11 @@ class StringCopier {
   }
 
   void append(const char* s, size_t n) {
+    if (size_ + n < capacity_) {
+      memcpy(ptr_ + size_, s, n);
+      size_ += n;
+      return;
+    }
     while (n-- > 0)
       append(*s++);
   }
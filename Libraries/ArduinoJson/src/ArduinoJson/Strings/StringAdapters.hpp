@@ -13,6 +13,8 @@
 #  include <ArduinoJson/Strings/Adapters/FlashString.hpp>
 #endif
 
+#include <stdint.h>  // uint32_t
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
 template <typename TAdaptedString1, typename TAdaptedString2>
@@ -66,6 +68,16 @@ stringEquals(TAdaptedString1 s1, TAdaptedString2 s2) {
   return stringEquals(s2, s1);
 }
 
+// FNV-1a
+template <typename TAdaptedString>
+uint32_t stringHash(TAdaptedString s) {
+  uint32_t h = 2166136261u;
+  size_t n = s.size();
+  for (size_t i = 0; i < n; i++)
+    h = (h ^ static_cast<uint8_t>(s[i])) * 16777619u;
+  return h;
+}
+
 template <typename TAdaptedString>
 static void stringGetChars(TAdaptedString s, char* p, size_t n) {
   ARDUINOJSON_ASSERT(s.size() <= n);
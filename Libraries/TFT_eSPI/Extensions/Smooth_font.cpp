@@ -245,6 +245,64 @@ void TFT_eSPI::loadMetrics(void)
   gFont.yAdvance = gFont.maxAscent + gFont.maxDescent;
 
   gFont.spaceWidth = (gFont.ascent + gFont.descent) * 2/7;  // Guess at space width
+
+  buildUnicodeIndex();
+}
+
+
+/***************************************************************************************
+** Function name:           buildUnicodeIndex
+** Description:             Build the ASCII table and sorted index used by getUnicodeIndex
+*************************************************************************************x*/
+// Lookups return the first glyph with a code, as the linear search did, so the
+// index is ordered by code and then by glyph number. If memory runs out the
+// missing table is simply not used.
+void TFT_eSPI::buildUnicodeIndex(void)
+{
+  gAscii = (uint16_t*)malloc(0x80 * 2);
+  if (gAscii)
+  {
+    for (uint16_t i = 0; i < 0x80; i++) gAscii[i] = 0xFFFF;
+    for (uint16_t gNum = gFont.gCount; gNum-- > 0; )
+    {
+      if (gUnicode[gNum] < 0x80) gAscii[gUnicode[gNum]] = gNum;
+    }
+  }
+
+  // Fonts made by the Processing sketch are already sorted, search gUnicode directly
+  gInOrder = true;
+  for (uint16_t gNum = 1; gNum < gFont.gCount && gInOrder; gNum++)
+  {
+    if (gUnicode[gNum] <= gUnicode[gNum - 1]) gInOrder = false;
+  }
+  if (gInOrder) return;
+
+#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
+  if ( psramFound() ) gSorted = (uint16_t*)ps_malloc( gFont.gCount * 2);
+  else
+#endif
+  gSorted = (uint16_t*)malloc( gFont.gCount * 2);
+  if (!gSorted) return;
+
+  for (uint16_t gNum = 0; gNum < gFont.gCount; gNum++) gSorted[gNum] = gNum;
+
+  // Shell sort, no recursion or extra memory needed
+  for (uint16_t gap = gFont.gCount / 2; gap > 0; gap = (gap == 2) ? 1 : gap * 5 / 11)
+  {
+    for (uint16_t i = gap; i < gFont.gCount; i++)
+    {
+      uint16_t gNum = gSorted[i];
+      uint16_t j = i;
+      while (j >= gap && (gUnicode[gSorted[j - gap]] > gUnicode[gNum] ||
+                         (gUnicode[gSorted[j - gap]] == gUnicode[gNum] && gSorted[j - gap] > gNum)))
+      {
+        gSorted[j] = gSorted[j - gap];
+        j -= gap;
+      }
+      gSorted[j] = gNum;
+    }
+    yield();
+  }
 }
 
 
@@ -296,6 +354,34 @@ void TFT_eSPI::unloadFont( void )
     gBitmap = NULL;
   }
 
+  if (gAscii)
+  {
+    free(gAscii);
+    gAscii = NULL;
+  }
+
+  if (gSorted)
+  {
+    free(gSorted);
+    gSorted = NULL;
+  }
+
+  gInOrder = false;
+
+  clearGlyphCache();
+
+  if (gBlend)
+  {
+    free(gBlend);
+    gBlend = NULL;
+  }
+
+  if (gLine)
+  {
+    free(gLine);
+    gLine = NULL;
+  }
+
   gFont.gArray = nullptr;
 
 #ifdef FONT_FS_AVAILABLE
@@ -340,6 +426,36 @@ uint32_t TFT_eSPI::readInt32(void)
 *************************************************************************************x*/
 bool TFT_eSPI::getUnicodeIndex(uint16_t unicode, uint16_t *index)
 {
+  if (unicode < 0x80 && gAscii)
+  {
+    if (gAscii[unicode] == 0xFFFF) return false;
+    *index = gAscii[unicode];
+    return true;
+  }
+
+  if (gInOrder || gSorted)
+  {
+    // Binary search for the first glyph with this code
+    uint16_t lo = 0, hi = gFont.gCount;
+    while (lo < hi)
+    {
+      uint16_t mid = (lo + hi) >> 1;
+      uint16_t gNum = gInOrder ? mid : gSorted[mid];
+      if (gUnicode[gNum] < unicode) lo = mid + 1;
+      else hi = mid;
+    }
+    if (lo < gFont.gCount)
+    {
+      uint16_t gNum = gInOrder ? lo : gSorted[lo];
+      if (gUnicode[gNum] == unicode)
+      {
+        *index = gNum;
+        return true;
+      }
+    }
+    return false;
+  }
+
   for (uint16_t i = 0; i < gFont.gCount; i++)
   {
     if (gUnicode[i] == unicode)
@@ -352,6 +468,241 @@ bool TFT_eSPI::getUnicodeIndex(uint16_t unicode, uint16_t *index)
 }
 
 
+/***************************************************************************************
+** Function name:           setGlyphCacheSize
+** Description:             Set the RAM used to cache glyph bitmaps read from a font file
+*************************************************************************************x*/
+void TFT_eSPI::setGlyphCacheSize(uint32_t bytes)
+{
+  clearGlyphCache();
+  gCacheLimit = bytes;
+}
+
+
+/***************************************************************************************
+** Function name:           clearGlyphCache
+** Description:             Free all cached glyph bitmaps
+*************************************************************************************x*/
+void TFT_eSPI::clearGlyphCache(void)
+{
+  for (uint16_t i = 0; i < gCacheCount; i++) free(gCache[i].bitmap);
+  if (gCache)
+  {
+    free(gCache);
+    gCache = NULL;
+  }
+  gCacheCount = 0;
+  gCacheCapacity = 0;
+  gCacheBytes = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           findCachedGlyph
+** Description:             Return the cache entry holding a glyph, or -1
+*************************************************************************************x*/
+int32_t TFT_eSPI::findCachedGlyph(uint16_t gNum)
+{
+  for (uint16_t i = 0; i < gCacheCount; i++)
+  {
+    if (gCache[i].gNum == gNum) return i;
+  }
+  return -1;
+}
+
+
+/***************************************************************************************
+** Function name:           getCachedGlyph
+** Description:             Return a glyph bitmap from the cache, reading it on a miss
+*************************************************************************************x*/
+// Returns NULL when the font is not a file, the cache is off or out of memory,
+// the caller then reads the bitmap from the file row by row as before
+const uint8_t* TFT_eSPI::getCachedGlyph(uint16_t gNum)
+{
+#ifdef FONT_FS_AVAILABLE
+  if (!fs_font || gCacheLimit == 0) return NULL;
+
+  uint32_t size = gWidth[gNum] * gHeight[gNum];
+  if (size == 0 || size > gCacheLimit) return NULL;
+
+  gCacheTick++;
+  int32_t i = findCachedGlyph(gNum);
+  if (i >= 0)
+  {
+    gCache[i].lastUse = gCacheTick;
+    glyphCacheHits++;
+    return gCache[i].bitmap;
+  }
+
+  if (!gCache)
+  {
+    // Room for small glyphs to fill the cache, never more than the font has
+    gCacheCapacity = min(gCacheLimit / 64 + 1, (uint32_t)gFont.gCount);
+    gCache = (glyphCacheEntry*)malloc(gCacheCapacity * sizeof(glyphCacheEntry));
+    if (!gCache) return NULL;
+  }
+
+  // Evict least recently used glyphs until the new one fits
+  while (gCacheCount && (gCacheCount == gCacheCapacity || gCacheBytes + size > gCacheLimit))
+  {
+    uint16_t oldest = 0;
+    for (uint16_t j = 1; j < gCacheCount; j++)
+    {
+      if (gCache[j].lastUse < gCache[oldest].lastUse) oldest = j;
+    }
+    free(gCache[oldest].bitmap);
+    gCacheBytes -= gWidth[gCache[oldest].gNum] * gHeight[gCache[oldest].gNum];
+    gCache[oldest] = gCache[--gCacheCount];
+  }
+
+  uint8_t* bitmap;
+#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
+  if ( psramFound() ) bitmap = (uint8_t*)ps_malloc(size);
+  else
+#endif
+  bitmap = (uint8_t*)malloc(size);
+  if (!bitmap) return NULL;
+
+  // Consecutive glyphs in the file are read without seeking
+  if (fontFile.position() != gBitmap[gNum]) fontFile.seek(gBitmap[gNum], fs::SeekSet);
+  fontFile.read(bitmap, size);
+
+  gCache[gCacheCount].bitmap = bitmap;
+  gCache[gCacheCount].lastUse = gCacheTick;
+  gCache[gCacheCount].gNum = gNum;
+  gCacheCount++;
+  gCacheBytes += size;
+  glyphCacheMisses++;
+  return bitmap;
+#else
+  gNum = gNum; // Avoid unused variable warning
+  return NULL;
+#endif
+}
+
+
+/***************************************************************************************
+** Function name:           prefetchGlyphs
+** Description:             Read the uncached glyphs of a string into the cache in file order
+*************************************************************************************x*/
+// Reading in ascending file position turns one seek per glyph into mostly
+// sequential reads. Glyphs beyond the first 32 missing ones, or beyond what
+// the cache holds, are read when drawn.
+void TFT_eSPI::prefetchGlyphs(const char *string, uint16_t len)
+{
+#ifdef FONT_FS_AVAILABLE
+  if (!fs_font || gCacheLimit == 0) return;
+
+  uint16_t missing[32];
+  uint8_t  count = 0;
+  uint16_t n = 0;
+  uint32_t bytes = 0;            // Glyphs of the string in the cache, and to be read
+  uint32_t start = gCacheTick;   // Cached glyphs used later were seen in this string
+  while (n < len && count < 32)
+  {
+    uint16_t gNum = 0;
+    uint16_t unicode = decodeUTF8((uint8_t*)string, &n, len - n);
+    if (unicode < 0x21 || !getUnicodeIndex(unicode, &gNum)) continue;
+    uint32_t size = gWidth[gNum] * gHeight[gNum];
+    if (size == 0 || size > gCacheLimit) continue; // Never cached
+
+    // Glyphs already cached are marked as used, so the reads below evict
+    // glyphs of other strings first
+    int32_t cached = findCachedGlyph(gNum);
+    if (cached >= 0)
+    {
+      if (gCache[cached].lastUse <= start) bytes += size;
+      gCache[cached].lastUse = ++gCacheTick;
+      continue;
+    }
+
+    // Insertion sort by position in the file, skipping repeats
+    uint8_t i = count;
+    while (i > 0 && gBitmap[missing[i - 1]] > gBitmap[gNum]) i--;
+    if (i > 0 && missing[i - 1] == gNum) continue;
+
+    // Reading more than the cache holds would evict glyphs before they are drawn
+    if (bytes + size > gCacheLimit) break;
+    bytes += size;
+    memmove(missing + i + 1, missing + i, (count - i) * sizeof(uint16_t));
+    missing[i] = gNum;
+    count++;
+  }
+
+  for (uint8_t i = 0; i < count; i++) getCachedGlyph(missing[i]);
+#else
+  string = string; // Avoid unused variable warning
+  len = len;
+#endif
+}
+
+
+/***************************************************************************************
+** Function name:           setAlphaDither
+** Description:             Set the ordered dither applied to anti-aliased glyph edges
+*************************************************************************************x*/
+void TFT_eSPI::setAlphaDither(uint8_t dither)
+{
+  gDither = dither;
+}
+
+
+/***************************************************************************************
+** Function name:           ditherAlpha
+** Description:             Offset an alpha value by a 4x4 Bayer pattern at x,y
+*************************************************************************************x*/
+uint8_t TFT_eSPI::ditherAlpha(uint8_t alpha, int32_t x, int32_t y)
+{
+  static const uint8_t bayer[16] = { 0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5 };
+
+  int32_t a = alpha + (((int32_t)bayer[((y & 3) << 2) | (x & 3)] * 2 - 15) * gDither) / 16;
+  if (a < 0) a = 0;
+  if (a > 255) a = 255;
+  return a;
+}
+
+
+/***************************************************************************************
+** Function name:           prepareBlend
+** Description:             Select the fg/bg pair for blendGlyphPixel()
+*************************************************************************************x*/
+// A solid background leaves only 256 possible colours per fg/bg pair, so each
+// is blended once and then looked up. Returns false if there is no memory for
+// the table, the caller then uses alphaBlend() directly.
+bool TFT_eSPI::prepareBlend(uint16_t fg, uint16_t bg)
+{
+  if (!gBlend)
+  {
+    gBlend = (uint16_t*)malloc(256 * sizeof(uint16_t));
+    if (!gBlend) return false;
+    memset(gBlendDone, 0, sizeof(gBlendDone));
+  }
+  else if (fg != gBlendFg || bg != gBlendBg) memset(gBlendDone, 0, sizeof(gBlendDone));
+
+  gBlendFg = fg;
+  gBlendBg = bg;
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           blendGlyphPixel
+** Description:             Blended colour for a glyph pixel at x,y, prepareBlend() first
+*************************************************************************************x*/
+uint16_t TFT_eSPI::blendGlyphPixel(uint8_t alpha, int32_t x, int32_t y)
+{
+  if (gDither) alpha = ditherAlpha(alpha, x, y);
+
+  uint32_t bit = 1UL << (alpha & 31);
+  if (!(gBlendDone[alpha >> 5] & bit))
+  {
+    gBlend[alpha] = alphaBlend(alpha, gBlendFg, gBlendBg);
+    gBlendDone[alpha >> 5] |= bit;
+  }
+  return gBlend[alpha];
+}
+
+
 /***************************************************************************************
 ** Function name:           drawGlyph
 ** Description:             Write a character to the TFT cursor position
@@ -408,7 +759,8 @@ void TFT_eSPI::drawGlyph(uint16_t code)
     const uint8_t* gPtr = (const uint8_t*) gFont.gArray;
 
 #ifdef FONT_FS_AVAILABLE
-    if (fs_font)
+    const uint8_t* cached = getCachedGlyph(gNum);
+    if (fs_font && !cached)
     {
       fontFile.seek(gBitmap[gNum], fs::SeekSet);
       pbuffer =  (uint8_t*)malloc(gWidth[gNum]);
@@ -421,10 +773,6 @@ void TFT_eSPI::drawGlyph(uint16_t code)
     //  if (cx > width() && bg_cursor_x > width()) return;
     //  if (cursor_y > height()) return;
 
-    int16_t  fxs = cx;
-    uint32_t fl = 0;
-    int16_t  bxs = cx;
-    uint32_t bl = 0;
     int16_t  bx = 0;
     uint8_t pixel;
 
@@ -458,10 +806,17 @@ void TFT_eSPI::drawGlyph(uint16_t code)
       }
     }
 
+    bool blendTable = !getColor && prepareBlend(fg, bg);
+    // Colours for one row of the glyph (gWidth fits in a byte), kept until unloadFont()
+    if (!gLine) gLine = (uint16_t*)malloc(256 * sizeof(uint16_t));
+    uint16_t* line = gLine;      // NULL if out of memory, pixels are then drawn one by one
+    bool swap = _swapBytes;
+    _swapBytes = true;           // line[] holds native colours for pushImage()
+
     for (int32_t y = 0; y < gHeight[gNum]; y++)
     {
 #ifdef FONT_FS_AVAILABLE
-      if (fs_font) {
+      if (fs_font && !cached) {
         if (spiffs)
         {
           fontFile.read(pbuffer, gWidth[gNum]);
@@ -477,47 +832,43 @@ void TFT_eSPI::drawGlyph(uint16_t code)
       }
 #endif
 
+      // Each run of pixels to draw is blended into line[] and pushed in one window
+      int32_t xs = 0;
+      int32_t len = 0;
       for (int32_t x = 0; x < gWidth[gNum]; x++)
       {
 #ifdef FONT_FS_AVAILABLE
-        if (fs_font) pixel = pbuffer[x];
+        if (cached) pixel = cached[x + gWidth[gNum] * y];
+        else if (fs_font) pixel = pbuffer[x];
         else
 #endif
         pixel = pgm_read_byte(gPtr + gBitmap[gNum] + x + gWidth[gNum] * y);
 
-        if (pixel)
+        if (pixel == 0 && (!_fillbg || x < bx))
         {
-          if (bl) { drawFastHLine( bxs, y + cy, bl, bg); bl = 0; }
-          if (pixel != 0xFF)
-          {
-            if (fl) {
-              if (fl==1) drawPixel(fxs, y + cy, fg);
-              else drawFastHLine( fxs, y + cy, fl, fg);
-              fl = 0;
-            }
-            if (getColor) bg = getColor(x + cx, y + cy);
-            drawPixel(x + cx, y + cy, alphaBlend(pixel, fg, bg));
-          }
-          else
-          {
-            if (fl==0) fxs = x + cx;
-            fl++;
-          }
+          if (len) { pushImage(cx + xs, y + cy, len, 1, line + xs); len = 0; }
+          continue;
         }
+
+        uint16_t color;
+        if (pixel == 0xFF) color = fg;
+        else if (pixel == 0) color = bg;
+        else if (blendTable) color = blendGlyphPixel(pixel, x + cx, y + cy);
         else
         {
-          if (fl) { drawFastHLine( fxs, y + cy, fl, fg); fl = 0; }
-          if (_fillbg) {
-            if (x >= bx) {
-              if (bl==0) bxs = x + cx;
-              bl++;
-            }
-          }
+          if (getColor) bg = getColor(x + cx, y + cy);
+          if (gDither) pixel = ditherAlpha(pixel, x + cx, y + cy);
+          color = alphaBlend(pixel, fg, bg);
         }
+
+        if (!line) { drawPixel(x + cx, y + cy, color); continue; }
+        if (len == 0) xs = x;
+        line[x] = color;
+        len++;
       }
-      if (fl) { drawFastHLine( fxs, y + cy, fl, fg); fl = 0; }
-      if (bl) { drawFastHLine( bxs, y + cy, bl, bg); bl = 0; }
+      if (len) pushImage(cx + xs, y + cy, len, 1, line + xs);
     }
+    _swapBytes = swap;
 
     // Fill area below glyph
     if (fillwidth > 0) {
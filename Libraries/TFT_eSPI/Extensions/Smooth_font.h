@@ -1,6 +1,12 @@
  // Coded by Bodmer 10/2/18, see license in root directory.
  // This is part of the TFT_eSPI class and is associated with anti-aliased font functions
 
+ // Bytes of RAM (PSRAM if available) for caching glyph bitmaps of fonts loaded from a
+ // file system, 0 = no cache. Can be changed at run time with setGlyphCacheSize().
+#ifndef SMOOTH_FONT_CACHE_SIZE
+  #define SMOOTH_FONT_CACHE_SIZE 0
+#endif
+
  public:
 
   // These are for the new anti-aliased fonts
@@ -16,6 +22,15 @@
 
   void     showFont(uint32_t td);
 
+           // Set the glyph bitmap cache size in bytes, 0 disables it. Only used for font files.
+  void     setGlyphCacheSize(uint32_t bytes);
+  uint32_t glyphCacheHits = 0;   // Glyphs drawn from the cache
+  uint32_t glyphCacheMisses = 0; // Glyphs read from the font file into the cache
+
+           // Ordered dither of anti-aliased edges by up to +/- dither alpha levels, 0 = off.
+           // The pattern depends only on the screen position, so redraws are identical.
+  void     setAlphaDither(uint8_t dither);
+
  // This is for the whole font
   typedef struct
   {
@@ -40,6 +55,11 @@ fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
   int8_t*   gdX = NULL;       //leftExtent
   uint32_t* gBitmap = NULL;   //file pointer to greyscale bitmap
 
+  // Lookup tables built by loadMetrics() so getUnicodeIndex() does not scan every glyph
+  uint16_t* gAscii = NULL;    //glyph number for each code below 0x80, 0xFFFF if not in the font
+  uint16_t* gSorted = NULL;   //glyph numbers in Unicode order, when the file is not in that order
+  bool      gInOrder = false; //gUnicode is strictly ascending, binary search it directly
+
   bool     fontLoaded = false; // Flags when a anti-aliased font is loaded
 
 #ifdef FONT_FS_AVAILABLE
@@ -52,9 +72,47 @@ fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
   bool     fontFile = true;
 #endif
 
+  protected:
+
+  // Glyph bitmap cache for font files, least recently used glyphs are evicted first
+  typedef struct
+  {
+    uint8_t* bitmap;   // gWidth * gHeight alpha values
+    uint32_t lastUse;  // gCacheTick when last used
+    uint16_t gNum;
+  } glyphCacheEntry;
+
+  glyphCacheEntry* gCache = NULL;
+  uint16_t gCacheCount = 0;
+  uint16_t gCacheCapacity = 0;
+  uint32_t gCacheBytes = 0;
+  uint32_t gCacheLimit = SMOOTH_FONT_CACHE_SIZE;
+  uint32_t gCacheTick = 0;
+
+  const uint8_t* getCachedGlyph(uint16_t gNum);
+  int32_t  findCachedGlyph(uint16_t gNum);
+  void     prefetchGlyphs(const char *string, uint16_t len);
+  void     clearGlyphCache(void);
+
+  // alphaBlend() results of gBlendFg over gBlendBg, each alpha level is
+  // blended the first time it is used and flagged in gBlendDone
+  uint16_t* gBlend = NULL;
+  uint32_t gBlendDone[8];
+  uint16_t gBlendFg = 0;
+  uint16_t gBlendBg = 0;
+  uint8_t  gDither = 0;
+
+  // Colours of one row of a glyph, for drawGlyph()
+  uint16_t* gLine = NULL;
+
+  bool     prepareBlend(uint16_t fg, uint16_t bg);
+  uint16_t blendGlyphPixel(uint8_t alpha, int32_t x, int32_t y);
+  uint8_t  ditherAlpha(uint8_t alpha, int32_t x, int32_t y);
+
   private:
 
   void     loadMetrics(void);
+  void     buildUnicodeIndex(void);
   uint32_t readInt32(void);
 
   uint8_t* fontPtr = nullptr;
@@ -1623,6 +1623,30 @@ uint8_t TFT_eSprite::getRotation(void)
 }
 
 
+/***************************************************************************************
+** Function name:           drawBitmap
+** Description:             draw a 1bpp bitmap, one buffer fill per run of set bits
+***************************************************************************************/
+void TFT_eSprite::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor)
+{
+  if (!_created) return;
+
+  drawBitmapRuns(x, y, bitmap, w, h, fgcolor, fgcolor, false);
+}
+
+
+/***************************************************************************************
+** Function name:           drawBitmap
+** Description:             draw a 1bpp bitmap with a background colour, run by run
+***************************************************************************************/
+void TFT_eSprite::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor, uint16_t bgcolor)
+{
+  if (!_created) return;
+
+  drawBitmapRuns(x, y, bitmap, w, h, fgcolor, bgcolor, true);
+}
+
+
 /***************************************************************************************
 ** Function name:           drawPixel
 ** Description:             push a single pixel at an arbitrary position
@@ -2032,28 +2056,22 @@ void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uin
   }
   else
   {
-    for (int8_t i = 0; i < 6; i++ ) {
-      uint8_t line;
-      if (i == 5)
-        line = 0x0;
-      else
-        line = pgm_read_byte(font + (c * 5) + i);
+    if (size == 1) // default size
+    {
+      for (int8_t i = 0; i < 6; i++ ) {
+        uint8_t line;
+        if (i == 5)
+          line = 0x0;
+        else
+          line = pgm_read_byte(font + (c * 5) + i);
 
-      if (size == 1) // default size
-      {
         for (int8_t j = 0; j < 8; j++) {
           if (line & 0x1) drawPixel(x + i, y + j, color);
           line >>= 1;
         }
       }
-      else {  // big size
-        for (int8_t j = 0; j < 8; j++) {
-          if (line & 0x1) fillRect(x + (i * size), y + (j * size), size, size, color);
-          else if (fillbg) fillRect(x + i * size, y + j * size, size, size, bg);
-          line >>= 1;
-        }
-      }
     }
+    else drawCharRuns(x, y, font + (c * 5), size, color, bg, fillbg); // big size, one fill per run
   }
 
 //>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -2479,7 +2497,8 @@ void TFT_eSprite::drawGlyph(uint16_t code)
     const uint8_t* gPtr = (const uint8_t*) gFont.gArray;
 
 #ifdef FONT_FS_AVAILABLE
-    if (fs_font) {
+    const uint8_t* cached = getCachedGlyph(gNum);
+    if (fs_font && !cached) {
       fontFile.seek(gBitmap[gNum], fs::SeekSet); // This is slow for a significant position shift!
       pbuffer =  (uint8_t*)malloc(gWidth[gNum]);
     }
@@ -2498,6 +2517,9 @@ void TFT_eSprite::drawGlyph(uint16_t code)
     int16_t  bx = 0;
     uint8_t pixel = 0;
 
+    // Blend from a table unless the background is read from the sprite
+    bool blendTable = !getBG && prepareBlend(fg, bg);
+
     int16_t fillwidth  = 0;
     int16_t fillheight = 0;
 
@@ -2528,7 +2550,7 @@ void TFT_eSprite::drawGlyph(uint16_t code)
     for (int32_t y = 0; y < gHeight[gNum]; y++)
     {
 #ifdef FONT_FS_AVAILABLE
-      if (fs_font) {
+      if (fs_font && !cached) {
         fontFile.read(pbuffer, gWidth[gNum]);
       }
 #endif
@@ -2536,7 +2558,8 @@ void TFT_eSprite::drawGlyph(uint16_t code)
       for (int32_t x = 0; x < gWidth[gNum]; x++)
       {
 #ifdef FONT_FS_AVAILABLE
-        if (fs_font) pixel = pbuffer[x];
+        if (cached) pixel = cached[x + gWidth[gNum] * y];
+        else if (fs_font) pixel = pbuffer[x];
         else
 #endif
         pixel = pgm_read_byte(gPtr + gBitmap[gNum] + x + gWidth[gNum] * y);
@@ -2551,8 +2574,13 @@ void TFT_eSprite::drawGlyph(uint16_t code)
               else drawFastHLine( fxs, y + cy, fl, fg);
               fl = 0;
             }
-            if (getBG) bg = readPixel(x + cx, y + cy);
-            drawPixel(x + cx, y + cy, alphaBlend(pixel, fg, bg));
+            if (blendTable) drawPixel(x + cx, y + cy, blendGlyphPixel(pixel, x + cx, y + cy));
+            else
+            {
+              if (getBG) bg = readPixel(x + cx, y + cy);
+              if (gDither) pixel = ditherAlpha(pixel, x + cx, y + cy);
+              drawPixel(x + cx, y + cy, alphaBlend(pixel, fg, bg));
+            }
           }
           else
           {
@@ -2622,6 +2650,8 @@ void TFT_eSprite::printToSprite(char *cbuffer, uint16_t len) //String string)
 {
   if(!fontLoaded) return;
 
+  prefetchGlyphs(cbuffer, len); // Font files only, read the glyphs in file order
+
   uint16_t n = 0;
   bool newSprite = !_created;
   int16_t  cursorX = _tft->cursor_x;
@@ -55,6 +55,10 @@ class TFT_eSprite : public TFT_eSPI {
            // Draw a single pixel at x,y
   void     drawPixel(int32_t x, int32_t y, uint32_t color);
 
+           // Draw a 1bpp bitmap, runs of set (and with bgcolor, clear) bits are filled into the buffer
+  void     drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor),
+           drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor, uint16_t bgcolor);
+
            // Draw a single character in the GLCD or GFXFF font
   void     drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size),
 
@@ -2757,6 +2757,59 @@ void TFT_eSPI::fillTriangle ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, in
 }
 
 
+/***************************************************************************************
+** Function name:           bitRunEnd
+** Description:             Find where a run of set (or clear) bits in a 1bpp row ends
+***************************************************************************************/
+// Scans 32 bits at a time from bit i (MSB first) and returns the index of the
+// first bit that differs from 'set', or w if the run reaches the end of the row
+int32_t TFT_eSPI::bitRunEnd(const uint8_t *row, int32_t i, int32_t w, bool set)
+{
+  int32_t  byteWidth = (w + 7) >> 3;
+  uint32_t flip = set ? 0xFFFFFFFF : 0;
+
+  while (i < w) {
+    int32_t  b = i >> 3;
+    uint32_t bits = 0;
+    for (int32_t k = 0; k < 4; k++) {
+      bits <<= 8;
+      if (b + k < byteWidth) bits |= pgm_read_byte(row + b + k);
+    }
+    // Bits matching the run become 0, bits before i are ignored
+    bits = (bits ^ flip) & (0xFFFFFFFF >> (i & 7));
+    if (bits) {
+      i = (b << 3) + __builtin_clz(bits);
+      return (i < w) ? i : w;
+    }
+    i = (b + 4) << 3;
+  }
+  return w;
+}
+
+
+/***************************************************************************************
+** Function name:           drawBitmapRuns
+** Description:             Draw a 1bpp bitmap as horizontal lines, one per run
+***************************************************************************************/
+// drawFastHLine is virtual, so this clips and draws correctly on the TFT and in Sprites
+void TFT_eSPI::drawBitmapRuns(int32_t x, int32_t y, const uint8_t *bitmap, int32_t w, int32_t h, uint32_t fgcolor, uint32_t bgcolor, bool bg)
+{
+  int32_t byteWidth = (w + 7) / 8;
+
+  for (int32_t j = 0; j < h; j++) {
+    const uint8_t *row = bitmap + j * byteWidth;
+    int32_t i = 0;
+    while (i < w) {
+      int32_t end = bitRunEnd(row, i, w, false);
+      if (bg && end > i) drawFastHLine(x + i, y + j, end - i, bgcolor);
+      if (end >= w) break;
+      i = bitRunEnd(row, end, w, true);
+      drawFastHLine(x + end, y + j, i - end, fgcolor);
+    }
+  }
+}
+
+
 /***************************************************************************************
 ** Function name:           drawBitmap
 ** Description:             Draw an image stored in an array on the TFT
@@ -2766,15 +2819,7 @@ void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w
   //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
   inTransaction = true;
 
-  int32_t i, j, byteWidth = (w + 7) / 8;
-
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++ ) {
-      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (128 >> (i & 7))) {
-        drawPixel(x + i, y + j, color);
-      }
-    }
-  }
+  drawBitmapRuns(x, y, bitmap, w, h, color, color, false);
 
   inTransaction = lockTransaction;
   end_tft_write();              // Does nothing if Sprite class uses this function
@@ -2787,21 +2832,38 @@ void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w
 ***************************************************************************************/
 void TFT_eSPI::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor, uint16_t bgcolor)
 {
-  //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
-  inTransaction = true;
+  if (_vpOoB || w < 1 || h < 1) return;
 
-  int32_t i, j, byteWidth = (w + 7) / 8;
+  int32_t xs = x + _xDatum;
+  int32_t ys = y + _yDatum;
 
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++ ) {
-      if (pgm_read_byte(bitmap + j * byteWidth + i / 8) & (128 >> (i & 7)))
-           drawPixel(x + i, y + j, fgcolor);
-      else drawPixel(x + i, y + j, bgcolor);
+  // Partly outside the viewport, clip run by run
+  if ((xs < _vpX) || (ys < _vpY) || (xs + w > _vpW) || (ys + h > _vpH)) {
+    inTransaction = true;
+    drawBitmapRuns(x, y, bitmap, w, h, fgcolor, bgcolor, true);
+    inTransaction = lockTransaction;
+    end_tft_write();
+    return;
+  }
+
+  // Every pixel is written, so one window takes the whole bitmap run by run
+  begin_tft_write();
+  setWindow(xs, ys, xs + w - 1, ys + h - 1);
+
+  int32_t byteWidth = (w + 7) / 8;
+  for (int32_t j = 0; j < h; j++) {
+    const uint8_t *row = bitmap + j * byteWidth;
+    int32_t i = 0;
+    while (i < w) {
+      int32_t end = bitRunEnd(row, i, w, false);
+      if (end > i) pushBlock(bgcolor, end - i);
+      if (end >= w) break;
+      i = bitRunEnd(row, end, w, true);
+      pushBlock(fgcolor, i - end);
     }
   }
 
-  inTransaction = lockTransaction;
-  end_tft_write();              // Does nothing if Sprite class uses this function
+  end_tft_write();
 }
 
 /***************************************************************************************
@@ -3176,6 +3238,43 @@ int16_t TFT_eSPI::fontHeight(void)
   return fontHeight(textfont);
 }
 
+/***************************************************************************************
+** Function name:           glcdRowBits
+** Description:             Return one row of a 5x8 GLCD glyph, bit i set for column i
+***************************************************************************************/
+// GLCD glyphs are stored column by column, bit j of each byte is row j.
+// Column 5 is the blank gap between characters.
+uint8_t TFT_eSPI::glcdRowBits(const uint8_t *glyph, int32_t j)
+{
+  uint8_t bits = 0;
+  for (int8_t i = 0; i < 5; i++) {
+    if (pgm_read_byte(glyph + i) & (1 << j)) bits |= 1 << i;
+  }
+  return bits;
+}
+
+
+/***************************************************************************************
+** Function name:           drawCharRuns
+** Description:             Draw a scaled GLCD glyph as one rectangle per horizontal run
+***************************************************************************************/
+// fillRect is virtual, so this clips and draws correctly on the TFT and in Sprites
+void TFT_eSPI::drawCharRuns(int32_t x, int32_t y, const uint8_t *glyph, uint8_t size, uint32_t color, uint32_t bg, bool fillbg)
+{
+  for (int32_t j = 0; j < 8; j++) {
+    uint8_t bits = glcdRowBits(glyph, j);
+    int32_t i = 0;
+    while (i < 6) {
+      bool set = bits & (1 << i);
+      int32_t end = i + 1;
+      while (end < 6 && (bool)(bits & (1 << end)) == set) end++;
+      if (set || fillbg) fillRect(x + i * size, y + j * size, (end - i) * size, size, set ? color : bg);
+      i = end;
+    }
+  }
+}
+
+
 /***************************************************************************************
 ** Function name:           drawChar
 ** Description:             draw a single character in the GLCD or GFXFF font
@@ -3203,7 +3302,7 @@ void TFT_eSPI::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32
     return;
 
   bool fillbg = (bg != color);
-  bool clip = xd < _vpX || xd + 6  * textsize >= _vpW || yd < _vpY || yd + 8 * textsize >= _vpH;
+  bool clip = xd < _vpX || xd + 6  * size >= _vpW || yd < _vpY || yd + 8 * size >= _vpH;
 
   if ((size==1) && fillbg && !clip) {
     uint8_t column[6];
@@ -3226,31 +3325,53 @@ void TFT_eSPI::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32
 
     end_tft_write();
   }
+  else if (fillbg && !clip) { // Big size, every pixel is written so one window takes the whole cell
+    const uint8_t *glyph = font + (c * 5);
+    begin_tft_write();
+
+    setWindow(xd, yd, xd + 6 * size - 1, yd + 8 * size - 1);
+
+    // Runs of one colour carry on across scan lines, so blank rows cost a single block
+    uint32_t runColor = bg;
+    uint32_t runLen = 0;
+    for (int8_t j = 0; j < 8; j++) {
+      uint8_t bits = glcdRowBits(glyph, j);
+      for (uint8_t s = 0; s < size; s++) {
+        for (int8_t i = 0; i < 6; i++) {
+          uint32_t pixelColor = (bits & (1 << i)) ? color : bg;
+          if (pixelColor != runColor) {
+            if (runLen) pushBlock(runColor, runLen);
+            runColor = pixelColor;
+            runLen = 0;
+          }
+          runLen += size;
+        }
+      }
+    }
+    if (runLen) pushBlock(runColor, runLen);
+
+    end_tft_write();
+  }
   else {
     //begin_tft_write();          // Sprite class can use this function, avoiding begin_tft_write()
     inTransaction = true;
 
-    for (int8_t i = 0; i < 6; i++ ) {
-      uint8_t line;
-      if (i == 5)
-        line = 0x0;
-      else
-        line = pgm_read_byte(font + (c * 5) + i);
+    if (size == 1 && !fillbg) { // default size
+      for (int8_t i = 0; i < 6; i++ ) {
+        uint8_t line;
+        if (i == 5)
+          line = 0x0;
+        else
+          line = pgm_read_byte(font + (c * 5) + i);
 
-      if (size == 1 && !fillbg) { // default size
         for (int8_t j = 0; j < 8; j++) {
           if (line & 0x1) drawPixel(x + i, y + j, color);
           line >>= 1;
         }
       }
-      else {  // big size or clipped
-        for (int8_t j = 0; j < 8; j++) {
-          if (line & 0x1) fillRect(x + (i * size), y + (j * size), size, size, color);
-          else if (fillbg) fillRect(x + i * size, y + j * size, size, size, bg);
-          line >>= 1;
-        }
-      }
     }
+    else drawCharRuns(x, y, font + (c * 5), size, color, bg, fillbg); // big size or clipped
+
     inTransaction = lockTransaction;
     end_tft_write();              // Does nothing if Sprite class uses this function
   }
@@ -5633,6 +5754,8 @@ int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY, uint8
     // If padding is requested then fill the text background
     if (padX && !_fillbg) _fillbg = true;
 
+    prefetchGlyphs(string, len); // Font files only, read the glyphs in file order
+
     while (n < len) {
       uint16_t uniCode = decodeUTF8((uint8_t*)string, &n, len - n);
       drawGlyph(uniCode);
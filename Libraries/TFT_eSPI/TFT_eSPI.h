@@ -585,10 +585,11 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
   void     setSwapBytes(bool swap);
   bool     getSwapBytes(void);
 
-           // Draw bitmap
-  void     drawBitmap( int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor),
-           drawBitmap( int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor, uint16_t bgcolor),
-           drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor),
+           // Draw bitmap, one line per run of set bits. With a background colour the
+           // TFT takes the whole bitmap through a single window, Sprites override both
+  virtual void drawBitmap( int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor),
+               drawBitmap( int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor, uint16_t bgcolor);
+  void     drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor),
            drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t fgcolor, uint16_t bgcolor),
            setBitmapColor(uint16_t fgcolor, uint16_t bgcolor); // Define the 2 colours for 1bpp sprites
 
@@ -947,6 +948,14 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
 
   bool     _fillbg;    // Fill background flag (just for for smooth fonts at the moment)
 
+           // 1bpp run helpers for drawBitmap(), also used by the Sprite class
+  static int32_t bitRunEnd(const uint8_t *row, int32_t i, int32_t w, bool set);
+  void     drawBitmapRuns(int32_t x, int32_t y, const uint8_t *bitmap, int32_t w, int32_t h, uint32_t fgcolor, uint32_t bgcolor, bool bg);
+
+           // Scaled GLCD glyph helpers for the big size drawChar() path, also used by the Sprite class
+  static uint8_t glcdRowBits(const uint8_t *glyph, int32_t j);
+  void     drawCharRuns(int32_t x, int32_t y, const uint8_t *glyph, uint8_t size, uint32_t color, uint32_t bg, bool fillbg);
+
 #if defined (SSD1963_DRIVER)
   uint16_t Cswap;      // Swap buffer for SSD1963
   uint8_t r6, g6, b6;  // RGB buffer for SSD1963
@@ -333,6 +333,10 @@
 // this will save ~20kbytes of FLASH
 #define SMOOTH_FONT
 
+// Uncomment to keep recently drawn glyphs of smooth fonts loaded from a file system in RAM,
+// so repeated characters are not read from the file again
+//#define SMOOTH_FONT_CACHE_SIZE 16384 // Bytes of RAM (PSRAM if available) for glyph bitmaps
+
 
 // ##################################################################################
 //
@@ -0,0 +1,252 @@
+/**
+ * @file Harness.cpp
+ * the emulated panel, the globals of the mock Arduino core, WiFi and file system,
+ * and the synthetic font generator
+ */
+
+#include "Harness.h"
+
+#include <WiFi.h>
+
+#include <algorithm>
+#include <math.h>
+
+uint8_t hostPins[64];
+unsigned long hostMillis = 0;
+SPIClass SPI;
+HardwareSerial Serial;
+HostPanel panel;
+HostWiFi WiFi;
+
+#ifdef FONT_FS_AVAILABLE
+fs::FS SPIFFS;
+#endif
+
+void hostPanelWrite(uint8_t data) {
+    if(hostPins[TFT_CS] == LOW) {
+        panel.write(data);
+    }
+}
+
+void HostPanel::clear(uint16_t color) {
+    std::fill(pixels, pixels + WIDTH * HEIGHT, color);
+    resetCounters();
+}
+
+void HostPanel::resetCounters() {
+    windows  = 0;
+    commands = 0;
+    bytes    = 0;
+    written  = 0;
+}
+
+void HostPanel::write(uint8_t data) {
+    bytes++;
+
+    if(hostPins[TFT_DC] == LOW) {
+        command  = data;
+        argCount = 0;
+        haveHigh = false;
+        commands++;
+        if(command == TFT_RAMWR) {
+            windows++;
+            x = xs;
+            y = ys;
+        }
+        return;
+    }
+
+    if(command == TFT_CASET || command == TFT_PASET) {
+        if(argCount < 4) {
+            args[argCount++] = data;
+        }
+        if(argCount == 4) {
+            int32_t start = args[0] << 8 | args[1];
+            int32_t end   = args[2] << 8 | args[3];
+            if(command == TFT_CASET) {
+                xs = start;
+                xe = end;
+            } else {
+                ys = start;
+                ye = end;
+            }
+        }
+        return;
+    }
+
+    if(command != TFT_RAMWR) {
+        return;
+    }
+    if(!haveHigh) {
+        high     = data;
+        haveHigh = true;
+        return;
+    }
+    haveHigh = false;
+    written++;
+
+    if(x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT) {
+        pixels[y * WIDTH + x] = high << 8 | data;
+    }
+    // the address counter wraps at the end of the window, as the panel's does
+    if(++x > xe) {
+        x = xs;
+        if(++y > ye) {
+            y = ys;
+        }
+    }
+}
+
+uint8_t fontAdvance(uint16_t code) {
+    if(code < 0x80) return 7;
+    if(code < 0x100) return 8;
+    if(code < 0x500) return 9;
+    return 15;
+}
+
+static void putInt32(std::vector<uint8_t> & out, int32_t value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+std::vector<uint8_t> makeFont(const std::vector<uint16_t> & codes, bool shuffled) {
+    const int32_t ascent = 11, descent = 3;
+
+    std::vector<uint16_t> order(codes);
+    if(shuffled) {
+        uint32_t seed = 12345;
+        for(size_t i = order.size(); i > 1; i--) {
+            seed = seed * 1103515245 + 12345;
+            std::swap(order[i - 1], order[(seed >> 8) % i]);
+        }
+        order.push_back(order.front());
+    }
+
+    std::vector<uint8_t> out;
+    putInt32(out, order.size());
+    putInt32(out, 11);    // version
+    putInt32(out, ascent + descent);
+    putInt32(out, 0);
+    putInt32(out, ascent);
+    putInt32(out, descent);
+
+    std::vector<uint8_t> bitmaps;
+    for(uint16_t code : order) {
+        int32_t width  = fontAdvance(code) - 1;
+        int32_t height = code < 0x500 ? ascent : ascent + descent;
+        putInt32(out, code);
+        putInt32(out, height);
+        putInt32(out, width);
+        putInt32(out, fontAdvance(code));
+        putInt32(out, ascent);    // dY, top of the bitmap on the ascent line
+        putInt32(out, 0);         // dX
+        putInt32(out, 0);
+
+        // a ring around the middle and a bar whose row depends on the code
+        float cx = (width - 1) / 2.0f, cy = (height - 1) / 2.0f;
+        float radius = std::min(cx, cy) - 0.5f;
+        int32_t bar = code % height;
+        for(int32_t y = 0; y < height; y++) {
+            for(int32_t x = 0; x < width; x++) {
+                float d     = fabsf(hypotf(x - cx, y - cy) - radius);
+                float cover = 1.5f - d;
+                if(y == bar) cover = 1;
+                cover = std::max(0.0f, std::min(1.0f, cover));
+                bitmaps.push_back((uint8_t)(cover * 255 + 0.5f));
+            }
+        }
+    }
+    out.insert(out.end(), bitmaps.begin(), bitmaps.end());
+
+    // font name, PostScript name, smoothed flag
+    out.push_back(0);
+    out.push_back(0);
+    out.push_back(0);
+    out.push_back(0);
+    out.push_back(1);
+    return out;
+}
+
+std::vector<uint16_t> mixedScriptCodes(size_t count) {
+    static const uint16_t ranges[][2] = {
+        { 0x0020, 0x007E },    // ASCII
+        { 0x00A0, 0x00FF },    // Latin-1
+        { 0x0400, 0x04FF },    // Cyrillic
+        { 0x3040, 0x30FF },    // hiragana and katakana
+        { 0x4E00, 0x9FFF },    // CJK unified ideographs
+    };
+
+    std::vector<uint16_t> codes;
+    for(const auto & range : ranges) {
+        for(uint32_t code = range[0]; code <= range[1] && codes.size() < count; code++) {
+            codes.push_back(code);
+        }
+    }
+    return codes;
+}
+
+void appendUtf8(std::string & out, uint16_t code) {
+    if(code < 0x80) {
+        out += (char)code;
+    } else if(code < 0x800) {
+        out += (char)(0xC0 | code >> 6);
+        out += (char)(0x80 | (code & 0x3F));
+    } else {
+        out += (char)(0xE0 | code >> 12);
+        out += (char)(0x80 | ((code >> 6) & 0x3F));
+        out += (char)(0x80 | (code & 0x3F));
+    }
+}
+
+std::string mixedScriptComment(size_t count) {
+    // first code and number of codes to pick from, per script
+    static const uint16_t scripts[][2] = {
+        { 'a', 26 }, { 0xC0, 64 }, { 0x430, 32 }, { 0x3042, 80 }, { 0x4E00, 4000 },
+    };
+
+    std::string out;
+    uint32_t seed = 7;
+    size_t script = 0;
+    for(size_t n = 0; n < count; n++) {
+        if(n % 6 == 5) {
+            out += ' ';
+            script = (script + 1) % 5;
+            continue;
+        }
+        seed = seed * 1103515245 + 12345;
+        appendUtf8(out, scripts[script][0] + (seed >> 8) % scripts[script][1]);
+    }
+    return out;
+}
+
+void pixelGlyph(TFT_eSPI & gfx, int32_t cursorX, int32_t cursorY, uint16_t code, uint16_t fg, uint16_t bg, bool fill, uint8_t dither) {
+    static const uint8_t bayer[16] = { 0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5 };
+
+    uint16_t gNum = 0;
+    if(!gfx.getUnicodeIndex(code, &gNum)) return;
+
+    gfx.startWrite();
+    if(fill) gfx.fillRect(cursorX, cursorY, gfx.gxAdvance[gNum], gfx.gFont.yAdvance, bg);
+
+    int32_t cy              = cursorY + gfx.gFont.maxAscent - gfx.gdY[gNum];
+    int32_t cx              = cursorX + gfx.gdX[gNum];
+    const uint8_t * bitmap = gfx.gFont.gArray + gfx.gBitmap[gNum];
+    for(int32_t y = 0; y < gfx.gHeight[gNum]; y++) {
+        for(int32_t x = 0; x < gfx.gWidth[gNum]; x++) {
+            int32_t alpha = bitmap[y * gfx.gWidth[gNum] + x];
+            if(alpha == 0) continue;
+            if(alpha == 0xFF) {
+                gfx.drawPixel(x + cx, y + cy, fg);
+                continue;
+            }
+            if(dither) {
+                alpha += ((bayer[((y + cy) & 3) << 2 | ((x + cx) & 3)] * 2 - 15) * dither) / 16;
+                alpha = std::max(0, std::min(255, alpha));
+            }
+            gfx.drawPixel(x + cx, y + cy, gfx.alphaBlend(alpha, fg, bg));
+        }
+    }
+    gfx.endWrite();
+}
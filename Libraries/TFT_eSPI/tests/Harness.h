@@ -0,0 +1,93 @@
+/**
+ * @file Harness.h
+ * host harness: TFT_eSPI on the generic processor driver, writing through
+ * the mock SPI bus (mock/SPI.h) to an emulated ILI9341
+ */
+
+#ifndef HARNESS_H_
+#define HARNESS_H_
+
+#include <TFT_eSPI.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * the panel: CASET and PASET set the window, RAMWR fills it row by row with
+ * 16 bit pixels, other commands are counted and ignored. The tests keep
+ * the default rotation, so pixels are in the coordinates of the TFT.
+ */
+class HostPanel {
+  public:
+    static const int32_t WIDTH  = TFT_WIDTH;
+    static const int32_t HEIGHT = TFT_HEIGHT;
+
+    uint16_t pixels[WIDTH * HEIGHT];
+
+    size_t windows  = 0;    ///< RAMWR commands, one per setWindow()
+    size_t commands = 0;    ///< all commands, RAMWR, CASET and PASET included
+    size_t bytes    = 0;    ///< bytes written with CS low, commands included
+    size_t written  = 0;    ///< pixels written by RAMWR, inside the panel or not
+
+    /// fill the panel with a colour and zero the counters
+    void clear(uint16_t color = 0);
+    void resetCounters();
+
+    uint16_t pixel(int32_t x, int32_t y) const {
+        return pixels[y * WIDTH + x];
+    }
+
+    void write(uint8_t data);
+
+  private:
+    uint8_t command  = 0;
+    uint8_t args[4]  = { 0 };
+    size_t argCount  = 0;
+    int32_t xs = 0, xe = WIDTH - 1, ys = 0, ye = HEIGHT - 1;
+    int32_t x = 0, y = 0;
+    uint8_t high     = 0;
+    bool haveHigh    = false;
+};
+
+extern HostPanel panel;
+
+/**
+ * a synthetic anti-aliased font in the .vlw format of the Processing sketch
+ * (see loadFont() in Smooth_font.cpp), for loadFont(const uint8_t array[])
+ *
+ * glyph bitmaps are as wide as their script's: 6 pixels for ASCII, 7 for
+ * Latin-1, 8 for Cyrillic, 14 for kana and CJK, plus a pixel of spacing in
+ * the advance. Each is an anti-aliased ring with a bar, so it has clear,
+ * solid and blended pixels, different for each code.
+ * @param shuffled  write the glyphs out of code order, with the first one
+ *                  repeated at the end, as files not made by the Processing
+ *                  sketch may be
+ */
+std::vector<uint8_t> makeFont(const std::vector<uint16_t> & codes, bool shuffled = false);
+
+/// the first count codes of: ASCII, Latin-1, Cyrillic, kana, then CJK ideographs
+std::vector<uint16_t> mixedScriptCodes(size_t count);
+
+/// cursor advance of a glyph of makeFont()
+uint8_t fontAdvance(uint16_t code);
+
+/// append the UTF-8 sequence of a code point
+void appendUtf8(std::string & out, uint16_t code);
+
+/**
+ * a chat comment of count code points that cycles through the scripts of
+ * mixedScriptCodes(): words of ASCII, Latin-1, Cyrillic, kana and CJK
+ * separated by spaces, as UTF-8
+ */
+std::string mixedScriptComment(size_t count);
+
+/**
+ * drawGlyph() of a smooth font as it was before the blend table and the row
+ * writer: every glyph pixel blended by alphaBlend() and sent with
+ * drawPixel(), after filling the glyph's cell with bg if fill is set.
+ * dither offsets the alpha of edge pixels by the 4x4 ordered pattern of
+ * setAlphaDither(). The cursor is not moved.
+ */
+void pixelGlyph(TFT_eSPI & gfx, int32_t cursorX, int32_t cursorY, uint16_t code, uint16_t fg, uint16_t bg, bool fill, uint8_t dither = 0);
+
+#endif /* HARNESS_H_ */
@@ -0,0 +1,130 @@
+/**
+ * @file animation.cpp
+ * the sketch's intro player (animation.h) against the encoder
+ * (tools/animation_encoder.h, as used by encode_intro.cpp): synthetic frames
+ * are encoded, played with drawAnimationFrame() and the panel compared with
+ * each frame, in both encodings (pixels added, or replaced), in two colour
+ * pairs, inside the screen and clipped by its edges
+ */
+
+#include "Harness.h"
+
+#include "../../../animation.h"
+#include "../../../tools/animation_encoder.h"
+
+static int failures = 0;
+
+static const int WIDTH  = 72;
+static const int HEIGHT = 45;
+
+// a ring moving across bars, with noise, a frame that changes nothing, a
+// full frame and an empty one
+static std::vector<Pixels> makeFrames() {
+    std::vector<Pixels> frames;
+    uint32_t seed = 99;
+    for(int f = 0; f < 16; f++) {
+        Pixels pixels(WIDTH * HEIGHT, 0);
+        for(int y = 0; y < HEIGHT; y++) {
+            for(int x = 0; x < WIDTH; x++) {
+                int dx = x - (8 + 4 * f), dy = y - 22;
+                int d2 = dx * dx + dy * dy;
+                bool ring = d2 >= 36 && d2 <= 100;
+                bool bar = (y / 5 + f) % 4 == 0 && x % 16 < 11;
+                seed = seed * 1103515245 + 12345;
+                bool noise = f % 3 == 2 && (seed >> 16) % 50 == 0;
+                pixels[y * WIDTH + x] = ring || bar || noise;
+            }
+        }
+        frames.push_back(pixels);
+        if(f == 5) frames.push_back(pixels);
+    }
+    frames.push_back(Pixels(WIDTH * HEIGHT, 1));
+    frames.push_back(Pixels(WIDTH * HEIGHT, 0));
+    return frames;
+}
+
+// the panel shows frame at x0,y0 on a bg screen, clipped by its edges
+static bool panelShows(const Pixels & frame, int x0, int y0, uint16_t fg, uint16_t bg) {
+    for(int y = 0; y < HostPanel::HEIGHT; y++) {
+        for(int x = 0; x < HostPanel::WIDTH; x++) {
+            int fx = x - x0, fy = y - y0;
+            bool inside = fx >= 0 && fx < WIDTH && fy >= 0 && fy < HEIGHT;
+            uint16_t expected = inside && frame[fy * WIDTH + fx] ? fg : bg;
+            if(panel.pixel(x, y) != expected) return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    TFT_eSPI tft;
+    tft.init();
+
+    if(ENCODER_VERSION != ANIMATION_VERSION) {
+        printf("FAIL the encoder writes version %d, the player reads %d\n", ENCODER_VERSION, ANIMATION_VERSION);
+        failures++;
+    }
+
+    static const uint16_t colors[][2] = {
+        { TFT_WHITE, TFT_BLACK },
+        { TFT_ORANGE, TFT_NAVY },
+    };
+    static const int places[][2] = {
+        { 30, 50 },
+        { HostPanel::WIDTH - WIDTH / 2, HostPanel::HEIGHT - HEIGHT / 3 },
+    };
+
+    size_t played = 0;
+    for(int replace = 0; replace < 2; replace++) {
+        std::vector<Pixels> frames = makeFrames();
+        uint32_t runTotal = 0;
+        std::vector<uint8_t> data = encodeAnimation(frames, WIDTH, HEIGHT, replace, runTotal);
+
+        for(const auto & pair : colors) {
+            for(const auto & place : places) {
+                // the screen is cleared to the background before the intro
+                panel.clear(pair[1]);
+                AnimationPlayer player;
+                if(!beginAnimation(player, data.data()) || player.frames != frames.size() || player.width != WIDTH ||
+                   player.height != HEIGHT) {
+                    printf("FAIL the header of %zu frames of %dx%d is not read back\n", frames.size(), WIDTH, HEIGHT);
+                    failures++;
+                    continue;
+                }
+
+                uint32_t runs = 0;
+                for(size_t f = 0; f < frames.size(); f++) {
+                    if(!drawAnimationFrame(player, tft, place[0], place[1], pair[0], pair[1])) {
+                        printf("FAIL frame %zu was not drawn\n", f);
+                        failures++;
+                        break;
+                    }
+                    runs += player.runs;
+                    if(!panelShows(frames[f], place[0], place[1], pair[0], pair[1])) {
+                        printf("FAIL frame %zu%s at %d,%d fg %04X bg %04X differs\n", f, replace ? " replaced" : "", place[0], place[1], pair[0],
+                               pair[1]);
+                        failures++;
+                    }
+                    played++;
+                }
+                if(drawAnimationFrame(player, tft, place[0], place[1], pair[0], pair[1])) {
+                    printf("FAIL a frame was drawn after the last one\n");
+                    failures++;
+                }
+                if(runs != runTotal) {
+                    printf("FAIL %u runs drawn, %u encoded\n", (unsigned)runs, (unsigned)runTotal);
+                    failures++;
+                }
+                if(player.pos != data.data() + data.size()) {
+                    printf("FAIL the player stopped %d bytes from the end of the data\n", (int)(data.data() + data.size() - player.pos));
+                    failures++;
+                }
+            }
+        }
+        printf("%s: %zu frames, %zu bytes, %u runs\n", replace ? "replaced" : "added", frames.size(), data.size(), (unsigned)runTotal);
+    }
+
+    printf("%zu frames played as encoded\n", played);
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
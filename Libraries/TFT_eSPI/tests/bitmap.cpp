@@ -0,0 +1,220 @@
+/**
+ * @file bitmap.cpp
+ * drawBitmap() against the drawPixel() loops it replaced: pixel for pixel on
+ * the panel (clipped by its edges and by a viewport) and in sprites of each
+ * colour depth, then the windows and bytes each way costs for the frames of
+ * a 240x320 intro
+ */
+
+#include "Harness.h"
+
+#include <vector>
+
+// drawBitmap() before it drew runs: a drawPixel() per pixel to draw
+static void pixelBitmap(TFT_eSPI & gfx, int16_t x, int16_t y, const uint8_t * bitmap, int16_t w, int16_t h, uint16_t fg) {
+    int32_t byteWidth = (w + 7) / 8;
+    gfx.startWrite();
+    for(int32_t j = 0; j < h; j++) {
+        for(int32_t i = 0; i < w; i++) {
+            if(bitmap[j * byteWidth + i / 8] & (128 >> (i & 7))) {
+                gfx.drawPixel(x + i, y + j, fg);
+            }
+        }
+    }
+    gfx.endWrite();
+}
+
+static void pixelBitmap(TFT_eSPI & gfx, int16_t x, int16_t y, const uint8_t * bitmap, int16_t w, int16_t h, uint16_t fg, uint16_t bg) {
+    int32_t byteWidth = (w + 7) / 8;
+    gfx.startWrite();
+    for(int32_t j = 0; j < h; j++) {
+        for(int32_t i = 0; i < w; i++) {
+            bool set = bitmap[j * byteWidth + i / 8] & (128 >> (i & 7));
+            gfx.drawPixel(x + i, y + j, set ? fg : bg);
+        }
+    }
+    gfx.endWrite();
+}
+
+// rows of random runs, density is the chance in 16 that a run is set
+static std::vector<uint8_t> randomBitmap(int32_t w, int32_t h, int density) {
+    int32_t byteWidth = (w + 7) / 8;
+    std::vector<uint8_t> bitmap(byteWidth * h, 0);
+    for(int32_t j = 0; j < h; j++) {
+        int32_t i = 0;
+        while(i < w) {
+            bool set    = rand() % 16 < density;
+            int32_t end = std::min(w, i + 1 + rand() % 40);
+            // padding bits past w are random too, drawBitmap() must ignore them
+            for(; i < end; i++) {
+                if(set) bitmap[j * byteWidth + i / 8] |= 128 >> (i & 7);
+            }
+        }
+        if(w & 7) bitmap[j * byteWidth + byteWidth - 1] |= rand() & (0xFF >> (w & 7));
+    }
+    return bitmap;
+}
+
+// a frame of the intro: a ring around the middle and bars that move with the frame
+static std::vector<uint8_t> introFrame(int frame) {
+    const int32_t w = HostPanel::WIDTH, h = HostPanel::HEIGHT, byteWidth = w / 8;
+    std::vector<uint8_t> bitmap(byteWidth * h, 0);
+    int32_t radius = 40 + frame * 3;
+    for(int32_t y = 0; y < h; y++) {
+        for(int32_t x = 0; x < w; x++) {
+            int32_t dx = x - w / 2, dy = y - h / 2;
+            int32_t d2 = dx * dx + dy * dy;
+            bool ring  = d2 >= radius * radius && d2 < (radius + 6) * (radius + 6);
+            bool bar   = (y + frame * 8) % 64 < 4 && x % 48 < 40;
+            if(ring || bar) bitmap[y * byteWidth + x / 8] |= 128 >> (x & 7);
+        }
+    }
+    return bitmap;
+}
+
+static std::vector<uint16_t> snapshot() {
+    return std::vector<uint16_t>(panel.pixels, panel.pixels + HostPanel::WIDTH * HostPanel::HEIGHT);
+}
+
+static std::vector<uint16_t> snapshot(TFT_eSprite & sprite) {
+    std::vector<uint16_t> pixels;
+    for(int32_t y = 0; y < sprite.height(); y++) {
+        for(int32_t x = 0; x < sprite.width(); x++) {
+            pixels.push_back(sprite.readPixel(x, y));
+        }
+    }
+    return pixels;
+}
+
+struct Cost {
+    size_t windows;
+    size_t bytes;
+};
+
+static Cost cost() {
+    return Cost{ panel.windows, panel.bytes };
+}
+
+int main() {
+    TFT_eSPI tft;
+    tft.init();
+    tft.setRotation(0);
+    int failures = 0;
+
+    // the panel, with and without a viewport, both overloads
+    for(int n = 0; n < 400; n++) {
+        int32_t w = 1 + rand() % 90, h = 1 + rand() % 40;
+        int32_t x = rand() % 340 - 60, y = rand() % 440 - 60;
+        std::vector<uint8_t> bitmap = randomBitmap(w, h, rand() % 17);
+        bool withBg = n & 1;
+
+        if(n & 2) tft.setViewport(20, 30, 150, 200, n & 4);
+        else tft.resetViewport();
+
+        panel.clear(0x1234);
+        if(withBg) pixelBitmap(tft, x, y, bitmap.data(), w, h, TFT_WHITE, TFT_NAVY);
+        else pixelBitmap(tft, x, y, bitmap.data(), w, h, TFT_WHITE);
+        std::vector<uint16_t> expected = snapshot();
+
+        panel.clear(0x1234);
+        if(withBg) tft.drawBitmap(x, y, bitmap.data(), w, h, TFT_WHITE, TFT_NAVY);
+        else tft.drawBitmap(x, y, bitmap.data(), w, h, TFT_WHITE);
+
+        if(snapshot() != expected) {
+            printf("FAIL panel %d: %dx%d at %d,%d%s%s\n", n, w, h, x, y, withBg ? " with bg" : "", (n & 2) ? " in a viewport" : "");
+            failures++;
+        }
+    }
+    tft.resetViewport();
+
+    // sprites of each colour depth, drawn through their own overrides, also
+    // when called as a TFT_eSPI, without touching the panel
+    panel.resetCounters();
+    const int8_t depths[] = { 16, 8, 1 };
+    for(int8_t depth : depths) {
+        TFT_eSprite sprite(&tft);
+        sprite.setColorDepth(depth);
+        sprite.createSprite(100, 60);
+        sprite.setBitmapColor(TFT_WHITE, TFT_BLACK);
+        for(int n = 0; n < 200; n++) {
+            int32_t w = 1 + rand() % 90, h = 1 + rand() % 40;
+            int32_t x = rand() % 160 - 40, y = rand() % 110 - 30;
+            std::vector<uint8_t> bitmap = randomBitmap(w, h, rand() % 17);
+            bool withBg = n & 1;
+            uint16_t fg = depth == 1 ? TFT_WHITE : TFT_YELLOW;
+            uint16_t bg = depth == 1 ? TFT_BLACK : TFT_DARKGREEN;
+
+            sprite.fillSprite(bg);
+            if(withBg) pixelBitmap(sprite, x, y, bitmap.data(), w, h, fg, TFT_BLACK);
+            else pixelBitmap(sprite, x, y, bitmap.data(), w, h, fg);
+            std::vector<uint16_t> expected = snapshot(sprite);
+
+            sprite.fillSprite(bg);
+            if(n & 2) {
+                TFT_eSPI & gfx = sprite;
+                if(withBg) gfx.drawBitmap(x, y, bitmap.data(), w, h, fg, TFT_BLACK);
+                else gfx.drawBitmap(x, y, bitmap.data(), w, h, fg);
+            }
+            else if(withBg) sprite.drawBitmap(x, y, bitmap.data(), w, h, fg, TFT_BLACK);
+            else sprite.drawBitmap(x, y, bitmap.data(), w, h, fg);
+
+            if(snapshot(sprite) != expected) {
+                printf("FAIL %d bit sprite %d: %dx%d at %d,%d%s%s\n", depth, n, w, h, x, y, withBg ? " with bg" : "", (n & 2) ? " as a TFT_eSPI" : "");
+                failures++;
+            }
+        }
+        sprite.deleteSprite();
+    }
+    if(panel.bytes) {
+        printf("FAIL drawing bitmaps into sprites wrote %zu bytes to the panel\n", panel.bytes);
+        failures++;
+    }
+
+    // the intro: 16 full screen frames, about a tenth of the pixels set
+    const int frames = 16;
+    Cost pixelFg = { 0, 0 }, runFg = { 0, 0 }, pixelBg = { 0, 0 }, runBg = { 0, 0 };
+    for(int frame = 0; frame < frames; frame++) {
+        std::vector<uint8_t> bitmap = introFrame(frame);
+        const int32_t w = HostPanel::WIDTH, h = HostPanel::HEIGHT;
+
+        for(int withBg = 0; withBg < 2; withBg++) {
+            panel.clear();
+            if(withBg) pixelBitmap(tft, 0, 0, bitmap.data(), w, h, TFT_WHITE, TFT_BLACK);
+            else pixelBitmap(tft, 0, 0, bitmap.data(), w, h, TFT_WHITE);
+            Cost before = cost();
+            std::vector<uint16_t> expected = snapshot();
+
+            panel.clear();
+            if(withBg) tft.drawBitmap(0, 0, bitmap.data(), w, h, TFT_WHITE, TFT_BLACK);
+            else tft.drawBitmap(0, 0, bitmap.data(), w, h, TFT_WHITE);
+            Cost after = cost();
+
+            if(snapshot() != expected) {
+                printf("FAIL intro frame %d%s\n", frame, withBg ? " with bg" : "");
+                failures++;
+            }
+            if(after.windows >= before.windows || after.bytes >= before.bytes) {
+                printf("FAIL intro frame %d%s: %zu windows, %zu bytes, per pixel %zu, %zu\n", frame, withBg ? " with bg" : "", after.windows, after.bytes,
+                       before.windows, before.bytes);
+                failures++;
+            }
+
+            Cost & pixelTotal = withBg ? pixelBg : pixelFg;
+            Cost & runTotal   = withBg ? runBg : runFg;
+            pixelTotal.windows += before.windows;
+            pixelTotal.bytes += before.bytes;
+            runTotal.windows += after.windows;
+            runTotal.bytes += after.bytes;
+        }
+    }
+
+    printf("per intro frame (%dx%d, %d frames)\n", HostPanel::WIDTH, HostPanel::HEIGHT, frames);
+    printf("%-20s %18s %18s\n", "", "drawPixel loop", "drawBitmap");
+    printf("%-20s %18zu %18zu\n", "fg windows", pixelFg.windows / frames, runFg.windows / frames);
+    printf("%-20s %18zu %18zu\n", "fg bytes", pixelFg.bytes / frames, runFg.bytes / frames);
+    printf("%-20s %18zu %18zu\n", "fg+bg windows", pixelBg.windows / frames, runBg.windows / frames);
+    printf("%-20s %18zu %18zu\n", "fg+bg bytes", pixelBg.bytes / frames, runBg.bytes / frames);
+
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
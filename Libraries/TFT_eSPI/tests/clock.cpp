@@ -0,0 +1,123 @@
+/**
+ * @file clock.cpp
+ * the sketch's clock (time.h) over a simulated minute of 10 ms loops that
+ * crosses midnight: the text always shows the current second, displayTime()
+ * pushes nothing between second boundaries and only the digits that changed
+ * on them, and the time box looks as a full redraw of the same text does
+ */
+
+#include "Harness.h"
+
+#include <sys/time.h>
+
+#include <chrono>
+
+TFT_eSPI tft;
+
+// the clock time.h reads, moved by the test along with hostMillis
+static struct timeval hostTime;
+
+static int hostGettimeofday(struct timeval * tv, void *) {
+    *tv = hostTime;
+    return 0;
+}
+
+#define gettimeofday hostGettimeofday
+
+#include "../../../time.h"
+
+static int failures = 0;
+
+static std::vector<uint16_t> snapshot() {
+    return std::vector<uint16_t>(panel.pixels, panel.pixels + HostPanel::WIDTH * HostPanel::HEIGHT);
+}
+
+// the text of the clock for the host time, as updateTimeText() formats it
+static std::string expectedTime() {
+    struct tm info;
+    localtime_r(&hostTime.tv_sec, &info);
+    char text[16];
+    strftime(text, sizeof(text), "%H:%M:%S", &info);
+    return text;
+}
+
+int main() {
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    tft.init();
+    panel.clear();
+
+    // 2026-10-17 23:59:30.250
+    struct tm start = {};
+    start.tm_year = 2026 - 1900;
+    start.tm_mon  = 9;
+    start.tm_mday = 17;
+    start.tm_hour = 23;
+    start.tm_min  = 59;
+    start.tm_sec  = 30;
+    hostTime.tv_sec  = timegm(&start);
+    hostTime.tv_usec = 250000;
+    hostMillis       = 1000;
+
+    const int loops = 6000;
+    const size_t cellPixels = 18 * 24;  // a digit at size 3
+    size_t pushed = 0, ticks = 0, pushes = 0;
+    double seconds = 0;
+    std::string shownTime, shownDay;
+    for(int n = 0; n <= loops; n++) {
+        panel.resetCounters();
+        auto begin = std::chrono::steady_clock::now();
+        displayTime();
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if(panel.written) pushes++;
+
+        if(timeText != expectedTime()) {
+            printf("FAIL loop %d: the clock shows %s at %s\n", n, timeText, expectedTime().c_str());
+            failures++;
+        }
+
+        // past the first draw, a second redraws the digits that changed, and
+        // the day and date when they did
+        if(n > 0) {
+            size_t changed = 0;
+            for(size_t i = 0; i < shownTime.size(); i++) changed += shownTime[i] != timeText[i];
+            if(shownTime != timeText) ticks++;
+            pushed += panel.written;
+            if(shownDay == dayText && panel.written != changed * cellPixels) {
+                printf("FAIL loop %d: %s to %s pushed %zu pixels, %zu digits changed\n", n, shownTime.c_str(), timeText, panel.written, changed);
+                failures++;
+            }
+        }
+        shownTime = timeText;
+        shownDay  = dayText;
+
+        // every 5 seconds, the box against a full redraw of the same text
+        if(n % 500 == 0) {
+            std::vector<uint16_t> updated = snapshot();
+            initialDrawDone = false;
+            nextTimeUpdate  = 0;
+            displayTime();
+            if(snapshot() != updated) {
+                printf("FAIL %s %s: the clock differs from a full redraw\n", dateText, timeText);
+                failures++;
+            }
+        }
+
+        hostMillis += 10;
+        hostTime.tv_usec += 10000;
+        if(hostTime.tv_usec >= 1000000) {
+            hostTime.tv_sec++;
+            hostTime.tv_usec -= 1000000;
+        }
+    }
+
+    if(ticks != 60 || pushes != 60 + 1) {
+        printf("FAIL a minute has %zu ticks and %zu loops pushed pixels, expected 60 and 61\n", ticks, pushes);
+        failures++;
+    }
+
+    printf("%d loops of 10 ms from 23:59:30 to %s: %.0f ns/loop, %zu px/s pushed after the first draw\n", loops, timeText,
+           seconds * 1e9 / (loops + 1), pushed / 60);
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
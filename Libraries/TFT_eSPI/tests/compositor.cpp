@@ -0,0 +1,192 @@
+/**
+ * @file compositor.cpp
+ * the sketch's compositor (compositor.h) with USE_COMPOSITOR: what is drawn
+ * into a band reaches the panel at the next flush, and only the rectangles
+ * marked dirty, small ones pushed at once and larger ones as band rows with
+ * DMA. A band is not drawn into while a transfer may still read it, and the
+ * TFT is selected only from a flush until its transfers end.
+ *
+ * The generic processor has no DMA, so the test stands in for it: a transfer
+ * is held until dmaWait() or finishTransfer(), then pushed from the sprite as
+ * it is by then, as the DMA engine reads the buffer while it runs.
+ */
+
+#define USE_COMPOSITOR 1
+#define FRAME_STATS 0
+
+#include "Harness.h"
+
+TFT_eSPI tft;
+
+#include "../../../compositor.h"
+
+static int failures = 0;
+
+struct Transfer {
+    int32_t x, y, w, h;
+    uint16_t * data;
+};
+
+static std::vector<Transfer> pending;   ///< the transfer in flight, if any
+static size_t transfers = 0;            ///< pushImageDMA() calls
+
+// the DMA engine is done with the transfer in flight
+static void finishTransfer() {
+    for(const Transfer & t : pending) tft.pushImage(t.x, t.y, t.w, t.h, t.data);
+    pending.clear();
+}
+
+bool TFT_eSPI::initDMA(bool) {
+    DMA_Enabled = true;
+    return true;
+}
+
+bool TFT_eSPI::dmaBusy() {
+    return !pending.empty();
+}
+
+void TFT_eSPI::dmaWait() {
+    finishTransfer();
+}
+
+void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t * data, uint16_t *) {
+    dmaWait();
+    pending.push_back({ x, y, w, h, data });
+    transfers++;
+}
+
+// every band of the panel shows its sprite
+static bool glassShowsLayers() {
+    for(int i = 0; i < LAYER_COUNT; i++) {
+        const CompositorLayer & layer = layers[i];
+        const uint16_t * buffer = (const uint16_t *)layers[i].sprite.getPointer();
+        for(int y = 0; y < layer.h; y++) {
+            for(int x = 0; x < HostPanel::WIDTH; x++) {
+                // sprites hold the pixels byte swapped for the panel
+                uint16_t color = buffer[y * HostPanel::WIDTH + x];
+                if(panel.pixel(x, layer.y + y) != (uint16_t)(color << 8 | color >> 8)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+// the TFT is selected: CS low
+static bool selected() {
+    return hostPins[TFT_CS] == LOW;
+}
+
+static void check(bool ok, const char * what) {
+    if(!ok) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+// flushes and checks the pixels written at once, by DMA, and the panel once
+// the transfer is done
+static void flush(const char * what, size_t direct, size_t dma) {
+    panel.resetCounters();
+    size_t before = transfers;
+    compositorFlush();
+    size_t written = panel.written;
+    size_t queued = transfers - before;
+    finishTransfer();
+    if(written != direct || panel.written - written != dma || (queued != 0) != (dma != 0)) {
+        printf("FAIL %s: %zu pixels pushed at once and %zu by %zu DMA transfers, expected %zu and %zu\n", what, written,
+               panel.written - written, queued, direct, dma);
+        failures++;
+    }
+    if(!glassShowsLayers()) {
+        printf("FAIL %s: the panel differs from the layers\n", what);
+        failures++;
+    }
+}
+
+int main() {
+    tft.init();
+    panel.clear(TFT_RED);
+
+    // the bands of main.cpp
+    compositorAddLayer(LAYER_KAOMOJI, 5, 55);
+    compositorAddLayer(LAYER_TIME, 80, 120);
+    compositorAddLayer(LAYER_TIKTOK, 210, 100);
+    initializeCompositor();
+    check(!selected(), "the TFT is selected before the first flush");
+
+    // the first flush sends every band
+    panel.resetCounters();
+    compositorFlush();
+    check(selected() && pending.size() == 1, "the TFT is not held while the last band is sent");
+    check(transfers == 3, "each band is not one DMA transfer");
+    finishTransfer();
+    check(panel.written == 240 * (55 + 120 + 100) && glassShowsLayers(), "the first flush does not show the bands");
+
+    // nothing drawn: nothing sent, and the TFT released once the transfer is done
+    flush("flushing nothing", 0, 0);
+    check(!selected(), "the TFT is still selected after the transfers");
+
+    // a small rectangle is pushed at once, without DMA, and the TFT released
+    TFT_eSPI & timeBand = beginLayer(LAYER_TIME);
+    timeBand.fillRect(100, 130, 30, 20, TFT_GREEN);
+    check(panel.pixel(100, 130) == TFT_BLACK, "drawing into a band reaches the panel before the flush");
+    compositorMarkDirty(LAYER_TIME, 100, 130, 30, 20);
+    flush("a 30x20 rectangle", 30 * 20, 0);
+    check(!selected(), "the TFT is still selected after pushing a small rectangle");
+
+    // two marks send the rectangle around both
+    timeBand.drawPixel(20, 90, TFT_WHITE);
+    compositorMarkDirty(LAYER_TIME, 20, 90, 1, 1);
+    timeBand.drawPixel(60, 100, TFT_WHITE);
+    compositorMarkDirty(LAYER_TIME, 60, 100, 1, 1);
+    flush("two pixels", 41 * 11, 0);
+
+    // a large rectangle goes out by DMA, as the band rows it covers
+    TFT_eSPI & tiktokBand = beginLayer(LAYER_TIKTOK);
+    tiktokBand.fillRect(10, 220, 200, 40, TFT_NAVY);
+    compositorMarkDirty(LAYER_TIKTOK, 10, 220, 200, 40);
+    flush("a 200x40 rectangle", 0, 240 * 40);
+    check(selected(), "the TFT is released while a transfer runs");
+    flush("flushing nothing after a transfer", 0, 0);
+    check(!selected(), "the TFT is still selected after the transfer");
+
+    // marks are cut to the band, and those outside it send nothing
+    TFT_eSPI & kaomojiBand = beginLayer(LAYER_KAOMOJI);
+    kaomojiBand.fillRect(0, 0, 240, 40, TFT_YELLOW);
+    compositorMarkDirty(LAYER_KAOMOJI, -10, 0, 300, 40);
+    flush("a rectangle across the top of the band", 0, 240 * 35);
+    compositorMarkDirty(LAYER_KAOMOJI, 0, 100, 240, 20);
+    compositorMarkDirty(LAYER_KAOMOJI, 240, 10, 20, 20);
+    flush("rectangles outside the band", 0, 0);
+
+    // drawing into the band in flight waits for its transfer, other bands don't
+    tiktokBand.fillRect(0, 230, 240, 10, TFT_BLUE);
+    compositorMarkDirty(LAYER_TIKTOK, 0, 230, 240, 10);
+    compositorFlush();
+    beginLayer(LAYER_KAOMOJI);
+    check(pending.size() == 1, "drawing into another band waits for the transfer");
+    beginLayer(LAYER_TIKTOK);
+    check(pending.empty() && panel.pixel(0, 230) == TFT_BLUE, "drawing into the band in flight does not wait for it");
+    tiktokBand.fillRect(0, 230, 240, 10, TFT_ORANGE);
+    check(panel.pixel(0, 230) == TFT_BLUE, "drawing into a band reaches the panel before the flush");
+    compositorMarkDirty(LAYER_TIKTOK, 0, 230, 240, 10);
+
+    // a small rectangle of the next frame waits for the transfer of the last
+    compositorFlush();
+    kaomojiBand.fillRect(100, 20, 10, 10, TFT_GREEN);
+    compositorMarkDirty(LAYER_KAOMOJI, 100, 20, 10, 10);
+    flush("a small rectangle during a transfer", 10 * 10 + 240 * 10, 0);
+
+    // small and large in one flush: the small one first, then the DMA
+    timeBand.fillRect(30, 120, 20, 20, TFT_CYAN);
+    compositorMarkDirty(LAYER_TIME, 30, 120, 20, 20);
+    tiktokBand.fillRect(0, 240, 240, 50, TFT_MAGENTA);
+    compositorMarkDirty(LAYER_TIKTOK, 0, 240, 240, 50);
+    flush("a small and a large rectangle", 20 * 20, 240 * 50);
+    flush("flushing nothing at last", 0, 0);
+    check(!selected(), "the TFT is still selected at last");
+
+    printf("%zu DMA transfers\n", transfers);
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file drawChar.cpp
+ * GLCD drawChar() drawn as runs against the fillRect() per font pixel it
+ * replaced: every glyph at sizes 1 to 7, with and without a background, on
+ * the panel (clipped by its edges and by a viewport) and in a sprite. Then
+ * the sketch's drawGlyphLine() (glyphs.h), which redraws only the cells that
+ * changed, against clearing the line and drawing all of it the old way, for
+ * clock ticks and kaomoji swaps, with the windows and bytes each one costs.
+ */
+
+#include "Harness.h"
+
+#include "Fonts/glcdfont.c"
+
+#include "../../../glyphs.h"
+
+static int failures = 0;
+
+// drawChar() before it drew runs: a size x size fillRect() per font pixel,
+// the background ones only if bg differs from color
+static void pixelChar(TFT_eSPI & gfx, int32_t x, int32_t y, uint8_t c, uint16_t color, uint16_t bg, uint8_t size) {
+    gfx.startWrite();
+    for(int32_t i = 0; i < 6; i++) {
+        uint8_t line = i == 5 ? 0 : font[c * 5 + i];
+        for(int32_t j = 0; j < 8; j++) {
+            if(line & 1) gfx.fillRect(x + i * size, y + j * size, size, size, color);
+            else if(bg != color) gfx.fillRect(x + i * size, y + j * size, size, size, bg);
+            line >>= 1;
+        }
+    }
+    gfx.endWrite();
+}
+
+// a text line the old ways: the kaomoji cleared it and printed every
+// character without a background, the clock drew the characters that changed
+// over their background, and cleared the line only when its length changed
+static void pixelLine(TFT_eSPI & gfx, int32_t x, int32_t y, const char * text, const char * shown, bool clear, uint8_t size, uint16_t color,
+                      uint16_t bg) {
+    clear = clear || strlen(text) != strlen(shown);
+    if(clear) gfx.fillRect(0, y, HostPanel::WIDTH, GLYPH_CELL_H * size, bg);
+    for(int32_t i = 0; text[i]; i++) {
+        if(clear) pixelChar(gfx, x + i * GLYPH_CELL_W * size, y, text[i], color, color, size);
+        else if(text[i] != shown[i]) pixelChar(gfx, x + i * GLYPH_CELL_W * size, y, text[i], color, bg, size);
+    }
+}
+
+static std::vector<uint16_t> snapshot() {
+    return std::vector<uint16_t>(panel.pixels, panel.pixels + HostPanel::WIDTH * HostPanel::HEIGHT);
+}
+
+static std::vector<uint16_t> snapshot(TFT_eSprite & sprite) {
+    std::vector<uint16_t> pixels;
+    for(int32_t y = 0; y < sprite.height(); y++) {
+        for(int32_t x = 0; x < sprite.width(); x++) pixels.push_back(sprite.readPixel(x, y));
+    }
+    return pixels;
+}
+
+struct Cost {
+    size_t windows;
+    size_t bytes;
+};
+
+// a centred line updated from one text to the next by drawGlyphLine() and
+// the old way, on the panel
+static void updateLine(TFT_eSPI & tft, const char * name, const std::vector<const char *> & texts, bool clear, uint8_t size, uint16_t fg,
+                       Cost & glyphs, Cost & old) {
+    GlyphCell cells[8];
+    size_t shownLen = 0;
+    const char * shown = "";
+    panel.clear();
+    for(const char * text : texts) {
+        int32_t x = (HostPanel::WIDTH - (int32_t)strlen(text) * GLYPH_CELL_W * size) / 2, y = 40;
+
+        // as the sketch does it, the line is cleared when its length changes
+        std::vector<uint16_t> before = snapshot();
+        panel.resetCounters();
+        if(strlen(text) != shownLen) {
+            tft.fillRect(0, y, HostPanel::WIDTH, GLYPH_CELL_H * size, TFT_BLACK);
+            resetGlyphLine(cells, 8);
+            shownLen = strlen(text);
+        }
+        drawGlyphLine(tft, cells, 8, x, y, text, size, fg, TFT_BLACK);
+        glyphs.windows += panel.windows;
+        glyphs.bytes += panel.bytes;
+        std::vector<uint16_t> updated = snapshot();
+
+        std::copy(before.begin(), before.end(), panel.pixels);
+        panel.resetCounters();
+        pixelLine(tft, x, y, text, shown, clear, size, fg, TFT_BLACK);
+        old.windows += panel.windows;
+        old.bytes += panel.bytes;
+        shown = text;
+
+        if(snapshot() != updated) {
+            printf("FAIL %s \"%s\": drawGlyphLine() differs from the old drawing\n", name, text);
+            failures++;
+        }
+    }
+}
+
+int main() {
+    TFT_eSPI tft;
+    tft.init();
+
+    // the panel, with and without a viewport: every glyph at each size
+    for(int n = 0; n < 256 * 7; n++) {
+        uint8_t c = n % 256, size = 1 + n / 256;
+        int32_t x = rand() % 300 - 40, y = rand() % 380 - 60;
+        uint16_t fg = rand(), bg = (n & 1) ? fg : (uint16_t)rand();
+
+        if(n & 2) tft.setViewport(20, 30, 150, 200, n & 4);
+        else tft.resetViewport();
+
+        panel.clear(0x1234);
+        pixelChar(tft, x, y, c, fg, bg, size);
+        std::vector<uint16_t> expected = snapshot();
+
+        panel.clear(0x1234);
+        tft.drawChar(x, y, c, fg, bg, size);
+
+        if(snapshot() != expected) {
+            printf("FAIL panel: glyph %d size %d at %d,%d%s%s\n", c, size, x, y, bg == fg ? "" : " with bg", (n & 2) ? " in a viewport" : "");
+            failures++;
+        }
+    }
+    tft.resetViewport();
+
+    // a sprite, drawn through its own drawChar(), which skips control codes
+    TFT_eSprite sprite(&tft);
+    sprite.setColorDepth(16);
+    sprite.createSprite(100, 80);
+    for(int n = 0; n < 224 * 7; n++) {
+        uint8_t c = 32 + n % 224, size = 1 + n / 224;
+        int32_t x = rand() % 140 - 40, y = rand() % 140 - 60;
+        uint16_t fg = TFT_YELLOW, bg = (n & 1) ? fg : TFT_NAVY;
+
+        sprite.fillSprite(TFT_DARKGREEN);
+        pixelChar(sprite, x, y, c, fg, bg, size);
+        std::vector<uint16_t> expected = snapshot(sprite);
+
+        sprite.fillSprite(TFT_DARKGREEN);
+        sprite.drawChar(x, y, c, fg, bg, size);
+
+        if(snapshot(sprite) != expected) {
+            printf("FAIL sprite: glyph %d size %d at %d,%d%s\n", c, size, x, y, bg == fg ? "" : " with bg");
+            failures++;
+        }
+    }
+    sprite.deleteSprite();
+
+    // a minute of the clock at size 3, crossing the hour and a length change
+    std::vector<std::string> ticks;
+    for(int s = 0; s < 60; s++) {
+        char text[16];
+        snprintf(text, sizeof(text), "%02d:%02d:%02d", 9 + (s >= 30), (59 + (s >= 30)) % 60, (30 + s) % 60);
+        ticks.push_back(text);
+    }
+    ticks.push_back("--:--");
+    ticks.push_back("10:00:30");
+    std::vector<const char *> clock;
+    for(const std::string & tick : ticks) clock.push_back(tick.c_str());
+
+    // kaomoji at size 6: swaps that keep the length and ones that change it
+    std::vector<const char *> faces = { "(^_^)", "(^o^)", "(-_-)", "(o_O)", "(^.^)", "(>_<)", "(T_T)", "d(^_^)b", "(-.-)", "(^_^)" };
+
+    Cost clockGlyphs = { 0, 0 }, clockOld = { 0, 0 }, faceGlyphs = { 0, 0 }, faceOld = { 0, 0 };
+    updateLine(tft, "clock", clock, false, 3, TFT_WHITE, clockGlyphs, clockOld);
+    updateLine(tft, "kaomoji", faces, true, 6, TFT_YELLOW, faceGlyphs, faceOld);
+
+    if(clockGlyphs.bytes >= clockOld.bytes || faceGlyphs.bytes >= faceOld.bytes) {
+        printf("FAIL drawGlyphLine() pushes more bytes than the old drawing\n");
+        failures++;
+    }
+
+    printf("%-26s %10s %12s %10s %12s\n", "per update", "windows", "bytes", "old windows", "old bytes");
+    printf("%-26s %10zu %12zu %10zu %12zu\n", "clock tick, size 3", clockGlyphs.windows / clock.size(), clockGlyphs.bytes / clock.size(),
+           clockOld.windows / clock.size(), clockOld.bytes / clock.size());
+    printf("%-26s %10zu %12zu %10zu %12zu\n", "kaomoji swap, size 6", faceGlyphs.windows / faces.size(), faceGlyphs.bytes / faces.size(),
+           faceOld.windows / faces.size(), faceOld.bytes / faces.size());
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
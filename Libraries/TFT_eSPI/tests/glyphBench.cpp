@@ -0,0 +1,73 @@
+/**
+ * @file glyphBench.cpp
+ * glyphs per second and panel bytes of a 48 character chat line in a smooth
+ * font, drawn by drawGlyph() and by the per pixel alphaBlend() path it
+ * replaced (pixelGlyph() in Harness.cpp), transparent and on a filled
+ * background
+ */
+
+#include "Harness.h"
+
+#include <chrono>
+
+// best time of 7 runs of calls, in seconds per call
+template<typename F>
+static double measure(size_t calls, F f) {
+    double best = 0;
+    for(int run = 0; run < 7; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < calls; i++) {
+            f();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / calls;
+        if(run == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+int main() {
+    TFT_eSPI tft;
+    tft.init();
+    tft.setTextWrap(false);
+
+    std::vector<uint8_t> font = makeFont(mixedScriptCodes(5000));
+    tft.loadFont(font.data());
+
+    const char line[] = "@viewer_42: that combo was amazing, gg everyone!";
+    const size_t length = strlen(line);
+    const uint16_t fg = TFT_WHITE, bg = 0x3186;
+
+    printf("%zu characters, %dx%d ASCII glyphs\n", length, fontAdvance('a') - 1, tft.gFont.ascent);
+    printf("%-14s %20s %20s %14s %14s\n", "", "per pixel glyphs/s", "drawGlyph glyphs/s", "per pixel B", "drawGlyph B");
+
+    for(int fill = 0; fill < 2; fill++) {
+        auto pixelLine = [&]() {
+            int32_t x = 0;
+            for(size_t i = 0; i < length; i++) {
+                pixelGlyph(tft, x, 100, line[i], fg, bg, fill);
+                x += line[i] == ' ' ? tft.gFont.spaceWidth : fontAdvance(line[i]);
+            }
+        };
+        auto glyphLine = [&]() {
+            tft.setTextColor(fg, bg, fill);
+            tft.setCursor(0, 100);
+            for(size_t i = 0; i < length; i++) {
+                tft.drawGlyph(line[i]);
+            }
+        };
+
+        panel.clear();
+        pixelLine();
+        size_t pixelBytes = panel.bytes;
+        panel.clear();
+        glyphLine();
+        size_t glyphBytes = panel.bytes;
+
+        double pixelTime = measure(200, pixelLine);
+        double glyphTime = measure(200, glyphLine);
+        printf("%-14s %20.0f %20.0f %14zu %14zu\n", fill ? "filled" : "transparent", length / pixelTime, length / glyphTime, pixelBytes, glyphBytes);
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file glyphCache.cpp
+ * the glyph bitmap cache of font files (getCachedGlyph() and prefetchGlyphs()
+ * in Smooth_font.cpp), on the in memory file system of mock/FS.h: hits and
+ * misses, the least recently used glyph evicted first, prefetching no more
+ * than the cache holds, and text drawn as without the cache
+ */
+
+#include "Harness.h"
+
+static int failures = 0;
+
+static std::vector<uint16_t> snapshot() {
+    return std::vector<uint16_t>(panel.pixels, panel.pixels + HostPanel::WIDTH * HostPanel::HEIGHT);
+}
+
+// a mixed script chat comment cut in lines of about 45 bytes
+static std::vector<std::string> chatLines() {
+    std::vector<std::string> lines;
+    std::string comment = mixedScriptComment(400);
+    for(size_t at = 0; at < comment.size();) {
+        size_t end = std::min(comment.size(), at + 45);
+        // don't split a UTF-8 sequence
+        while(end < comment.size() && (comment[end] & 0xC0) == 0x80) end++;
+        lines.push_back(comment.substr(at, end - at));
+        at = end;
+    }
+    return lines;
+}
+
+static std::vector<uint16_t> drawChat(TFT_eSPI & tft, const std::vector<std::string> & lines) {
+    panel.clear(TFT_NAVY);
+    for(int pass = 0; pass < 2; pass++) {
+        for(size_t i = 0; i < lines.size(); i++) {
+            tft.drawString(lines[i].c_str(), 2, (int32_t)i * 15 % 300);
+        }
+    }
+    return snapshot();
+}
+
+static void checkCounts(TFT_eSPI & tft, uint32_t hits, uint32_t misses, const char * what) {
+    if(tft.glyphCacheHits != hits || tft.glyphCacheMisses != misses) {
+        printf("FAIL %s: %u hits and %u misses, expected %u and %u\n", what, (unsigned)tft.glyphCacheHits, (unsigned)tft.glyphCacheMisses,
+               (unsigned)hits, (unsigned)misses);
+        failures++;
+    }
+}
+
+// draws code with drawGlyph(), which reads the cache without prefetching,
+// and returns 'H' for a hit, 'M' for a miss
+static char drawCode(TFT_eSPI & tft, uint16_t code) {
+    uint32_t hits = tft.glyphCacheHits;
+    tft.setCursor(10, 10);
+    tft.drawGlyph(code);
+    return tft.glyphCacheHits != hits ? 'H' : 'M';
+}
+
+int main() {
+    TFT_eSPI tft;
+    tft.init();
+    tft.setTextColor(TFT_WHITE, TFT_NAVY, true);
+
+    std::vector<uint8_t> font = makeFont(mixedScriptCodes(5000));
+    SPIFFS.files["/mixed.vlw"] = font;
+    std::vector<std::string> lines = chatLines();
+
+    // the font as an array, and as a file without the cache
+    tft.loadFont(font.data());
+    std::vector<uint16_t> expected = drawChat(tft, lines);
+
+    tft.loadFont("mixed", SPIFFS);
+    tft.setGlyphCacheSize(0);
+    SPIFFS.seeks = 0;
+    if(drawChat(tft, lines) != expected) {
+        printf("FAIL uncached file differs from the array font\n");
+        failures++;
+    }
+    size_t uncachedSeeks = SPIFFS.seeks;
+    checkCounts(tft, 0, 0, "no cache");
+
+    // a cache big enough for the text reads each glyph once, and a small one
+    // evicts while drawing, neither changes a pixel
+    const uint32_t sizes[] = { 65536, 2048 };
+    size_t cachedSeeks[2] = { 0 };
+    for(int i = 0; i < 2; i++) {
+        tft.setGlyphCacheSize(sizes[i]);
+        tft.glyphCacheHits = tft.glyphCacheMisses = 0;
+        SPIFFS.seeks = 0;
+        if(drawChat(tft, lines) != expected) {
+            printf("FAIL %u byte cache draws other pixels than no cache\n", (unsigned)sizes[i]);
+            failures++;
+        }
+        cachedSeeks[i] = SPIFFS.seeks;
+        if(cachedSeeks[i] >= uncachedSeeks) {
+            printf("FAIL %u byte cache: %zu seeks, %zu without the cache\n", (unsigned)sizes[i], cachedSeeks[i], uncachedSeeks);
+            failures++;
+        }
+    }
+
+    // the large cache missed each glyph of the text once
+    std::vector<uint16_t> codes;
+    size_t glyphs = 0;
+    for(const std::string & line : lines) {
+        uint16_t n = 0;
+        while(n < line.size()) {
+            uint16_t code = tft.decodeUTF8((uint8_t *)line.c_str(), &n, line.size() - n);
+            if(code < 0x21) continue;
+            glyphs++;
+            if(std::find(codes.begin(), codes.end(), code) == codes.end()) codes.push_back(code);
+        }
+    }
+    tft.setGlyphCacheSize(65536);
+    tft.glyphCacheHits = tft.glyphCacheMisses = 0;
+    drawChat(tft, lines);
+    checkCounts(tft, 2 * glyphs, codes.size(), "65536 byte cache");
+
+    // room for three ASCII glyphs of 6x11: the least recently used one goes
+    tft.setGlyphCacheSize(3 * 66);
+    tft.glyphCacheHits = tft.glyphCacheMisses = 0;
+    std::string order;
+    const char * sequence = "ABCADACBDC";
+    for(const char * c = sequence; *c; c++) order += drawCode(tft, *c);
+    if(order != "MMMHMHHMMH") {
+        printf("FAIL drawing %s: %s, expected MMMHMHHMMH\n", sequence, order.c_str());
+        failures++;
+    }
+
+    // prefetching stops at what the cache holds, the rest is read when drawn
+    tft.setGlyphCacheSize(3 * 66);
+    tft.glyphCacheHits = tft.glyphCacheMisses = 0;
+    tft.drawString("ABCDEFGH", 10, 10);
+    checkCounts(tft, 3, 8, "prefetching ABCDEFGH in a 3 glyph cache");
+
+    // and keeps the glyphs of the string already cached: F was the oldest
+    tft.glyphCacheHits = tft.glyphCacheMisses = 0;
+    tft.drawString("FXYZ", 10, 10);
+    checkCounts(tft, 3, 3, "prefetching FXYZ after ABCDEFGH");
+
+    printf("%zu lines of chat: %zu seeks without the cache, %zu with 64 KB, %zu with 2 KB\n", lines.size(), uncachedSeeks, cachedSeeks[0],
+           cachedSeeks[1]);
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
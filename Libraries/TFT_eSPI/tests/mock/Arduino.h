@@ -0,0 +1,142 @@
+/**
+ * Arduino.h for the host tests, only what TFT_eSPI and the sketch headers need
+ */
+
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT  0x0
+#define OUTPUT 0x1
+
+#define PROGMEM
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+// TFT_eSPI reads the pointers of its font tables with pgm_read_dword, so on a
+// 64 bit host the value is read with the type it is stored as. Fonts 2 to 8
+// still keep glyph addresses in 32 bits, the tests don't draw them.
+template<typename T>
+inline uintptr_t hostReadDword(const T * addr) {
+    return (uintptr_t)*addr;
+}
+
+inline uintptr_t hostReadDword(const void * addr) {
+    return *(const uintptr_t *)addr;
+}
+
+#define pgm_read_dword(addr) hostReadDword(addr)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::max;
+using std::min;
+
+// pin levels, the panel emulator reads TFT_DC and TFT_CS from here
+extern uint8_t hostPins[64];
+
+inline void pinMode(int, int) {
+}
+
+inline void digitalWrite(int pin, int value) {
+    if(pin >= 0 && pin < 64) hostPins[pin] = value;
+}
+
+inline int digitalRead(int pin) {
+    return (pin >= 0 && pin < 64) ? hostPins[pin] : LOW;
+}
+
+#define digitalPinToBitMask(pin) (1UL << ((pin) & 31))
+
+// time runs only when the test moves it
+extern unsigned long hostMillis;
+
+inline unsigned long millis() {
+    return hostMillis;
+}
+
+inline unsigned long micros() {
+    return hostMillis * 1000;
+}
+
+inline void delay(unsigned long ms) {
+    hostMillis += ms;
+}
+
+inline void delayMicroseconds(unsigned int) {
+}
+
+inline void yield() {
+}
+
+inline long random(long max) {
+    return rand() % max;
+}
+
+// newlib and the ESP32 core have it, glibc only since 2.38
+inline size_t hostStrlcpy(char * dst, const char * src, size_t size) {
+    size_t length = strlen(src);
+    if(size) {
+        size_t n = std::min(length, size - 1);
+        memcpy(dst, src, n);
+        dst[n] = 0;
+    }
+    return length;
+}
+
+#define strlcpy hostStrlcpy
+
+inline char * ltoa(long value, char * str, int base) {
+    if(base == 16) sprintf(str, "%lx", value);
+    else sprintf(str, "%ld", value);
+    return str;
+}
+
+class String {
+  public:
+    String(const char * cstr = "")
+        : s(cstr ? cstr : "") {
+    }
+
+    const char * c_str() const {
+        return s.c_str();
+    }
+
+    unsigned int length() const {
+        return s.length();
+    }
+
+    void toCharArray(char * buf, unsigned int size, unsigned int index = 0) const {
+        if(!size) return;
+        strncpy(buf, index < s.length() ? s.c_str() + index : "", size - 1);
+        buf[size - 1] = 0;
+    }
+
+    bool operator==(const char * cstr) const {
+        return s == cstr;
+    }
+
+    friend String operator+(const String & a, const char * b) {
+        return String((a.s + b).c_str());
+    }
+
+    friend String operator+(const char * a, const String & b) {
+        return String((a + b.s).c_str());
+    }
+
+  private:
+    std::string s;
+};
+
+#endif /* HOST_ARDUINO_H_ */
@@ -0,0 +1,94 @@
+/**
+ * FS.h for the host tests: files held in memory, for the font file code of
+ * TFT_eSPI (built with HOST_FONT_FS, see tft_setup.h)
+ */
+
+#ifndef HOST_FS_H_
+#define HOST_FS_H_
+
+#include <Arduino.h>
+#include <Print.h>
+
+#include <map>
+#include <vector>
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+/// reads the bytes of a file of an FS, counting its seeks and reads there
+class File {
+  public:
+    File() {
+    }
+
+    File(const std::vector<uint8_t> * data, size_t * seeks, size_t * reads)
+        : data(data), seeks(seeks), reads(reads) {
+    }
+
+    operator bool() const {
+        return data != nullptr;
+    }
+
+    int read() {
+        if(!data || pos >= data->size()) return -1;
+        (*reads)++;
+        return (*data)[pos++];
+    }
+
+    size_t read(uint8_t * buf, size_t size) {
+        if(!data) return 0;
+        size = std::min(size, data->size() - std::min(pos, data->size()));
+        memcpy(buf, data->data() + pos, size);
+        pos += size;
+        (*reads)++;
+        return size;
+    }
+
+    bool seek(uint32_t offset, SeekMode mode = SeekSet) {
+        if(!data) return false;
+        if(mode == SeekCur) offset += pos;
+        if(mode == SeekEnd) offset += data->size();
+        if(offset > data->size()) return false;
+        pos = offset;
+        (*seeks)++;
+        return true;
+    }
+
+    size_t position() const {
+        return pos;
+    }
+
+    void close() {
+        data = nullptr;
+    }
+
+  private:
+    const std::vector<uint8_t> * data = nullptr;
+    size_t * seeks = nullptr;
+    size_t * reads = nullptr;
+    size_t pos = 0;
+};
+
+class FS {
+  public:
+    std::map<std::string, std::vector<uint8_t> > files;
+
+    size_t seeks = 0;    ///< seek() calls on the files opened from here
+    size_t reads = 0;    ///< read() calls, of a byte or of a block
+
+    bool exists(const String & path) const {
+        return files.count(path.c_str()) != 0;
+    }
+
+    File open(const String & path, const char * = "r") {
+        std::map<std::string, std::vector<uint8_t> >::const_iterator file = files.find(path.c_str());
+        return file == files.end() ? File() : File(&file->second, &seeks, &reads);
+    }
+};
+
+} // namespace fs
+
+extern fs::FS SPIFFS;
+
+#endif /* HOST_FS_H_ */
@@ -0,0 +1,70 @@
+/**
+ * Print.h for the host tests, TFT_eSPI prints through write(uint8_t)
+ */
+
+#ifndef HOST_PRINT_H_
+#define HOST_PRINT_H_
+
+#include <Arduino.h>
+
+#include <stdarg.h>
+
+class Print {
+  public:
+    virtual ~Print() {
+    }
+
+    virtual size_t write(uint8_t) = 0;
+
+    size_t write(const char * str) {
+        size_t n = 0;
+        while(*str) n += write((uint8_t)*str++);
+        return n;
+    }
+
+    size_t print(const char * str) {
+        return write(str);
+    }
+
+    size_t print(const String & str) {
+        return write(str.c_str());
+    }
+
+    size_t print(long value) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), "%ld", value);
+        return write(buf);
+    }
+
+    size_t println(const char * str = "") {
+        return write(str) + write("\n");
+    }
+
+    size_t println(const String & str) {
+        return println(str.c_str());
+    }
+
+    size_t printf(const char * format, ...) {
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(nullptr, 0, format, args);
+        va_end(args);
+        std::string buf(length, '\0');
+        va_start(args, format);
+        vsnprintf(&buf[0], buf.size() + 1, format, args);
+        va_end(args);
+        return write(buf.c_str());
+    }
+};
+
+// Serial prints to stdout
+class HardwareSerial : public Print {
+  public:
+    size_t write(uint8_t c) {
+        return fputc(c, stdout) == EOF ? 0 : 1;
+    }
+};
+
+extern HardwareSerial Serial;
+
+#endif /* HOST_PRINT_H_ */
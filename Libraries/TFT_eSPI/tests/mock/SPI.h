@@ -0,0 +1,57 @@
+/**
+ * SPI.h for the host tests: every byte written goes to the emulated panel
+ * (Panel.h), with the level of TFT_DC telling commands from data
+ */
+
+#ifndef HOST_SPI_H_
+#define HOST_SPI_H_
+
+#include <Arduino.h>
+
+#define MSBFIRST  1
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+// implemented by the panel emulator
+void hostPanelWrite(uint8_t data);
+
+class SPISettings {
+  public:
+    SPISettings(uint32_t = 0, uint8_t = MSBFIRST, uint8_t = SPI_MODE0) {
+    }
+};
+
+class SPIClass {
+  public:
+    void begin(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) {
+    }
+
+    void end() {
+    }
+
+    void setFrequency(uint32_t) {
+    }
+
+    void beginTransaction(SPISettings) {
+    }
+
+    void endTransaction() {
+    }
+
+    uint8_t transfer(uint8_t data) {
+        hostPanelWrite(data);
+        return 0;
+    }
+
+    uint16_t transfer16(uint16_t data) {
+        hostPanelWrite(data >> 8);
+        hostPanelWrite(data);
+        return 0;
+    }
+};
+
+extern SPIClass SPI;
+
+#endif /* HOST_SPI_H_ */
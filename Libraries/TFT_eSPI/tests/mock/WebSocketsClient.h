@@ -0,0 +1,60 @@
+/**
+ * WebSocketsClient.h for the host tests of the sketch's panel: the client's
+ * interface, never connected. The tests call the sketch's event handlers
+ * with the frames themselves.
+ */
+
+#ifndef HOST_WEBSOCKETSCLIENT_H_
+#define HOST_WEBSOCKETSCLIENT_H_
+
+#include <Arduino.h>
+
+#define WEBSOCKETS_MAX_DATA_SIZE (15 * 1024)
+
+typedef enum {
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN,
+    WStype_FRAGMENT_TEXT_START,
+    WStype_FRAGMENT_BIN_START,
+    WStype_FRAGMENT,
+    WStype_FRAGMENT_FIN,
+    WStype_PING,
+    WStype_PONG,
+} WStype_t;
+
+class WebSocketsClient {
+  public:
+    typedef void (*WebSocketClientEvent)(WStype_t type, uint8_t * payload, size_t length);
+
+    void begin(const char *, uint16_t, const char * = "/") {
+    }
+
+    void onEvent(WebSocketClientEvent) {
+    }
+
+    void setReconnectInterval(unsigned long) {
+    }
+
+    void enableHeartbeat(uint32_t, uint32_t, uint8_t) {
+    }
+
+    void loop() {
+    }
+
+    bool isConnected() {
+        return false;
+    }
+
+    bool sendPing() {
+        return false;
+    }
+
+    bool sendTXT(const char *) {
+        return false;
+    }
+};
+
+#endif /* HOST_WEBSOCKETSCLIENT_H_ */
@@ -0,0 +1,44 @@
+/**
+ * WiFi.h for the host tests of the sketch's headers: the station is always
+ * connected, and the clock is what the test sets, not NTP time
+ */
+
+#ifndef HOST_WIFI_H_
+#define HOST_WIFI_H_
+
+#include <Arduino.h>
+
+#include <time.h>
+
+#define WIFI_STA     1
+#define WL_CONNECTED 3
+
+class HostWiFi {
+  public:
+    int status() {
+        return WL_CONNECTED;
+    }
+
+    void mode(int) {
+    }
+
+    void begin(const char *, const char *) {
+    }
+
+    void disconnect() {
+    }
+};
+
+extern HostWiFi WiFi;
+
+// esp32-hal-time
+inline void configTime(long, int, const char *) {
+}
+
+inline bool getLocalTime(struct tm * info, uint32_t = 5000) {
+    time_t now = time(nullptr);
+    localtime_r(&now, info);
+    return true;
+}
+
+#endif /* HOST_WIFI_H_ */
@@ -0,0 +1,106 @@
+/**
+ * @file panel.cpp
+ * the sketch's TikTok panel (tiktok_live.h): a stream of relay events goes
+ * through handleMessage(), and each update of renderPanel() must leave the
+ * panel as a full repaint of the same entries does (clear, then every row)
+ *
+ * short and wrapped chats, likes, gifts and follows, long usernames, Latin-1
+ * and kana that the GLCD font can't draw, and chats longer than the three
+ * content lines. The pixels and SPI bytes of each update are counted on the
+ * emulated panel, against those of the full repaint.
+ */
+
+#include "Harness.h"
+
+#include "../../../tiktok_live.h"
+
+TFT_eSPI tft;
+
+static int failures = 0;
+
+static std::vector<uint16_t> snapshot() {
+    return std::vector<uint16_t>(panel.pixels, panel.pixels + HostPanel::WIDTH * HostPanel::HEIGHT);
+}
+
+static std::string chat(const char * username, const std::string & message) {
+    return std::string("{\"type\":\"chat\",\"username\":\"") + username + "\",\"message\":\"" + message + "\"}";
+}
+
+// count code points of the kana block, as UTF-8
+static std::string kana(size_t count) {
+    std::string out;
+    for(size_t i = 0; i < count; i++) appendUtf8(out, 0x3042 + i % 80);
+    return out;
+}
+
+static std::vector<std::string> events() {
+    std::vector<std::string> out;
+    out.push_back(chat("anna_k", "hi from Berlin!"));
+    out.push_back("{\"type\":\"like\",\"username\":\"night.owl\",\"likeCount\":15}");
+    out.push_back(chat("gamer_4life", "what game is this? can you play it again tomorrow at the same time?"));
+    out.push_back("{\"type\":\"follow\",\"username\":\"new_fan\"}");
+    out.push_back("{\"type\":\"gift\",\"username\":\"generous.viewer\",\"giftName\":\"Rose\",\"repeatCount\":37}");
+    out.push_back(chat("a_rather_long_username_here", "ok"));
+    out.push_back(chat("m.ivanov", "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 caf\xc3\xa9 cr\xc3\xa8me"));
+    out.push_back(chat("\xe3\x82\xbf\xe3\x83\xad\xe3\x82\xa6", kana(5)));
+    out.push_back(chat("long_kana", kana(200)));
+    out.push_back("{\"type\":\"like\",\"username\":\"anna_k\",\"likeCount\":120}");
+    out.push_back(chat("tiktok_user123", "this stream is amazing, love it! really, the best one this week"));
+    out.push_back("{\"type\":\"like\",\"username\":\"anna_k\",\"likeCount\":121}");
+    out.push_back(chat("x", std::string(300, 'w')));
+    out.push_back("{\"type\":\"follow\",\"username\":\"someone.new\"}");
+    out.push_back(chat("anna_k", "hi from Berlin!"));
+    out.push_back(chat("anna_k", "hi from Berlin!"));
+    out.push_back("{\"type\":\"gift\",\"username\":\"anna_k\",\"giftName\":\"TikTok\",\"repeatCount\":1}");
+    out.push_back(chat("gamer_4life", "gg"));
+    return out;
+}
+
+int main() {
+    tft.init();
+    panel.clear();
+    initializeTikTokLive();
+
+    std::vector<std::string> stream = events();
+    size_t pixels = 0, bytes = 0, fullPixels = 0, fullBytes = 0;
+    printf("%5s %10s %10s %10s %10s\n", "event", "pixels", "SPI bytes", "full px", "full bytes");
+    for(size_t i = 0; i < stream.size(); i++) {
+        // the update of this event, as the display does it
+        std::string frame = stream[i];
+        panel.resetCounters();
+        handleMessage((uint8_t *)&frame[0], frame.size());
+        std::vector<uint16_t> updated = snapshot();
+        size_t eventPixels = panel.written, eventBytes = panel.bytes;
+
+        // a full repaint of the same entries
+        panel.resetCounters();
+        panelNeedsClear = true;
+        renderPanel();
+        if(snapshot() != updated) {
+            printf("FAIL event %zu (%s): the update differs from a full repaint\n", i, stream[i].c_str());
+            failures++;
+        }
+        printf("%5zu %10zu %10zu %10zu %10zu\n", i, eventPixels, eventBytes, panel.written, panel.bytes);
+        pixels += eventPixels;
+        bytes += eventBytes;
+        fullPixels += panel.written;
+        fullBytes += panel.bytes;
+
+        // chats cut to fit the entry still end in "..."
+        const PanelEntry & entry = panelEntries[(currentLine + maxLines - 1) % maxLines];
+        if(stream[i].size() > 300 && !entry.contentLayout.truncated) {
+            printf("FAIL event %zu: %zu bytes of chat drawn without \"...\"\n", i, stream[i].size());
+            failures++;
+        }
+    }
+
+    if(bytes >= fullBytes) {
+        printf("FAIL the updates pushed %zu SPI bytes, full repaints %zu\n", bytes, fullBytes);
+        failures++;
+    }
+
+    printf("%zu events: %zu pixels and %zu SPI bytes, full repaints %zu pixels and %zu SPI bytes\n", stream.size(), pixels, bytes, fullPixels,
+           fullBytes);
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file smoothGlyph.cpp
+ * drawGlyph() of a smooth font against the per pixel alphaBlend() path it
+ * replaced (pixelGlyph() in Harness.cpp): glyphs of each script on fixed
+ * fg/bg pairs, transparent and with the background filled, with and without
+ * the ordered dither, on the panel and in a sprite
+ */
+
+#include "Harness.h"
+
+static std::vector<uint16_t> snapshot() {
+    return std::vector<uint16_t>(panel.pixels, panel.pixels + HostPanel::WIDTH * HostPanel::HEIGHT);
+}
+
+static std::vector<uint16_t> snapshot(TFT_eSprite & sprite) {
+    uint16_t * pixels = (uint16_t *)sprite.getPointer();
+    return std::vector<uint16_t>(pixels, pixels + sprite.width() * sprite.height());
+}
+
+// the fixed pairs: the second one after the first checks that the blend table is redone
+static const uint16_t colors[][2] = {
+    { TFT_ORANGE, TFT_NAVY },
+    { TFT_WHITE, 0x3186 },
+};
+
+static const uint16_t codes[] = { 'g', 'W', 0xE9, 0x416, 0x3042, 0x5B57 };
+
+int main() {
+    TFT_eSPI tft;
+    tft.init();
+    int failures = 0;
+
+    std::vector<uint8_t> font = makeFont(mixedScriptCodes(5000));
+    tft.loadFont(font.data());
+    tft.setTextWrap(false);
+
+    TFT_eSprite sprite(&tft);
+    sprite.setColorDepth(16);
+    sprite.createSprite(40, 30);
+    sprite.loadFont(font.data());
+
+    size_t glyphs = 0;
+    for(uint8_t dither = 0; dither <= 16; dither += 16) {
+        tft.setAlphaDither(dither);
+        sprite.setAlphaDither(dither);
+        for(const auto & pair : colors) {
+            for(int fill = 0; fill < 2; fill++) {
+                for(uint16_t code : codes) {
+                    // every phase of the dither pattern
+                    for(int32_t phase = 0; phase < 16; phase++) {
+                        int32_t x = 20 + (phase & 3), y = 30 + (phase >> 2);
+
+                        panel.clear(0x1234);
+                        pixelGlyph(tft, x, y, code, pair[0], pair[1], fill, dither);
+                        std::vector<uint16_t> expected = snapshot();
+
+                        panel.clear(0x1234);
+                        tft.setTextColor(pair[0], pair[1], fill);
+                        tft.setCursor(x, y);
+                        tft.drawGlyph(code);
+                        if(snapshot() != expected) {
+                            printf("FAIL panel U+%04X at %d,%d fg %04X bg %04X%s%s\n", code, x, y, pair[0], pair[1], fill ? " filled" : "",
+                                   dither ? " dithered" : "");
+                            failures++;
+                        }
+
+                        // a redraw at the same place is identical, dithered or not
+                        tft.setCursor(x, y);
+                        tft.drawGlyph(code);
+                        if(snapshot() != expected) {
+                            printf("FAIL panel U+%04X at %d,%d: redraw differs\n", code, x, y);
+                            failures++;
+                        }
+
+                        sprite.fillSprite(0x1234);
+                        pixelGlyph(sprite, x - 16, y - 26, code, pair[0], pair[1], fill, dither);
+                        expected = snapshot(sprite);
+
+                        sprite.fillSprite(0x1234);
+                        sprite.setTextColor(pair[0], pair[1], fill);
+                        sprite.setCursor(x - 16, y - 26);
+                        sprite.drawGlyph(code);
+                        if(snapshot(sprite) != expected) {
+                            printf("FAIL sprite U+%04X at %d,%d fg %04X bg %04X%s%s\n", code, x - 16, y - 26, pair[0], pair[1], fill ? " filled" : "",
+                                   dither ? " dithered" : "");
+                            failures++;
+                        }
+                        glyphs++;
+                    }
+                }
+            }
+        }
+    }
+
+    // the dither changes the blended pixels, and only those
+    tft.setTextColor(TFT_ORANGE, TFT_NAVY, true);
+    tft.setAlphaDither(0);
+    panel.clear();
+    tft.setCursor(20, 30);
+    tft.drawGlyph(0x5B57);
+    std::vector<uint16_t> plain = snapshot();
+    tft.setAlphaDither(16);
+    panel.clear();
+    tft.setCursor(20, 30);
+    tft.drawGlyph(0x5B57);
+    std::vector<uint16_t> dithered = snapshot();
+    size_t changed = 0;
+    for(size_t i = 0; i < plain.size(); i++) {
+        bool edge = plain[i] != TFT_ORANGE && plain[i] != TFT_NAVY && plain[i] != 0;
+        if(plain[i] != dithered[i]) {
+            changed++;
+            if(!edge) {
+                printf("FAIL dither changed a solid pixel at %zu\n", i);
+                failures++;
+            }
+        }
+    }
+    if(changed == 0) {
+        printf("FAIL dither changed no pixel\n");
+        failures++;
+    }
+
+    printf("%zu glyphs on the panel and in a sprite as the per pixel path, dither changed %zu edge pixels\n", glyphs, changed);
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file textLayout.cpp
+ * layoutText() and drawTextLine() of the sketch (textlayout.h) measured
+ * through the real decodeUTF8() and textWidth(): ASCII, Latin-1, Cyrillic,
+ * CJK and emoji, embedded newlines, words longer than a line, the ellipsis
+ * and multi-byte sequences cut off, in the GLCD font at sizes 1 and 2 and in
+ * a smooth font
+ *
+ * every layout is drawn: each line must move the cursor by its width, draw
+ * its glyphs, and together the lines must draw what printing the whole text
+ * draws, spaces and newlines aside
+ */
+
+#include "Harness.h"
+
+#include "../../../textlayout.h"
+
+struct Case {
+    const char * name;
+    const char * text;
+    int maxWidth;
+    int maxLines;
+    std::vector<std::string> lines;    ///< expected, the ellipsis included
+};
+
+static int failures = 0;
+
+static void fail(const Case & c, const char * what) {
+    printf("FAIL %s: %s\n", c.name, what);
+    failures++;
+}
+
+// the code points write() draws for bytes, through the TFT's own print decoder
+static std::vector<uint16_t> printed(TFT_eSPI & tft, const char * bytes, size_t length) {
+    std::vector<uint16_t> codes;
+    for(size_t i = 0; i < length; i++) {
+        uint16_t code = tft.decodeUTF8((uint8_t)bytes[i]);
+        if(code && code != ' ' && code != '\n') codes.push_back(code);
+    }
+    tft.decodeUTF8((uint8_t)' ');    // back to the first state
+    return codes;
+}
+
+static void check(TFT_eSPI & tft, const Case & c) {
+    TextLayout layout;
+    layoutText(tft, c.text, c.maxWidth, c.maxLines, layout);
+    size_t length = strlen(c.text);
+
+    if(layout.lineCount > c.maxLines) fail(c, "too many lines");
+
+    std::vector<uint16_t> drawn;
+    size_t end = 0;
+    for(int line = 0; line < layout.lineCount; line++) {
+        const TextSpan & span = layout.lines[line];
+        bool last             = layout.truncated && line == layout.lineCount - 1;
+
+        if(span.start < end || span.start + span.length > length) {
+            fail(c, "span out of order or out of the text");
+            return;
+        }
+        end = span.start + span.length;
+        for(uint16_t i = span.start; i < end; i++) {
+            if(c.text[i] == '\n') fail(c, "newline inside a line");
+        }
+        if(span.length && (c.text[span.start] == ' ' || c.text[end - 1] == ' ')) fail(c, "line starts or ends with a space");
+        if(span.width > c.maxWidth && span.glyphs > 1) fail(c, "line wider than maxWidth");
+
+        // drawing the line moves the cursor by its width
+        tft.setCursor(10, 20);
+        drawTextLine(tft, c.text, layout, line);
+        if(tft.getCursorX() - 10 != span.width) {
+            char what[80];
+            snprintf(what, sizeof(what), "line %d drawn %d wide, layout says %d", line, tft.getCursorX() - 10, span.width);
+            fail(c, what);
+        }
+
+        std::vector<uint16_t> codes = printed(tft, c.text + span.start, span.length);
+        size_t glyphs               = codes.size();
+        for(uint16_t i = span.start; i < end; i++) glyphs += c.text[i] == ' ';
+        if(last) glyphs += strlen(TEXT_ELLIPSIS);
+        if(glyphs != span.glyphs) fail(c, "glyph count differs from the glyphs drawn");
+        drawn.insert(drawn.end(), codes.begin(), codes.end());
+
+        std::string text(c.text + span.start, span.length);
+        if(last) text += TEXT_ELLIPSIS;
+        if(line >= (int)c.lines.size() || c.lines[line] != text) {
+            printf("FAIL %s: line %d is \"%s\"\n", c.name, line, text.c_str());
+            failures++;
+        }
+    }
+    if(layout.lineCount != c.lines.size()) {
+        printf("FAIL %s: %d lines, expected %zu\n", c.name, layout.lineCount, c.lines.size());
+        failures++;
+    }
+
+    // the lines draw the text, or the start of it when it was cut
+    std::vector<uint16_t> whole = printed(tft, c.text, length);
+    if(layout.truncated ? (drawn.size() >= whole.size() || !std::equal(drawn.begin(), drawn.end(), whole.begin())) : drawn != whole) {
+        fail(c, layout.truncated ? "truncated lines are not the start of the text" : "lines don't draw the whole text");
+    }
+}
+
+int main() {
+    TFT_eSPI tft;
+    tft.init();
+    tft.setTextWrap(false);
+
+    // GLCD: every code point is a 6 pixel cell, emoji and bytes that are not
+    // UTF-8 are drawn a byte per cell
+    const Case glcd[] = {
+        { "ascii", "hello world foo", 60, 4, { "hello", "world foo" } },
+        { "newlines", "ab\ncd\n\nef", 120, 4, { "ab", "cd", "", "ef" } },
+        { "long word", "abcdefghijklmnopqrstuvwxyz", 60, 4, { "abcdefghij", "klmnopqrst", "uvwxyz" } },
+        { "long word after a word", "to abcdefghijklmnop", 60, 4, { "to", "abcdefghij", "klmnop" } },
+        { "ellipsis", "one two three four five six", 60, 2, { "one two", "three f..." } },
+        { "ellipsis after a newline", "first\nsecond line\nthird", 120, 2, { "first", "second line..." } },
+        { "latin-1", "caf\xC3\xA9 cr\xC3\xA8me br\xC3\xBBl\xC3\xA9" "e", 60, 4, { "caf\xC3\xA9 cr\xC3\xA8me", "br\xC3\xBBl\xC3\xA9" "e" } },
+        { "cyrillic", "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 \xD0\xBC\xD0\xB8\xD1\x80", 42, 4,
+          { "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82", "\xD0\xBC\xD0\xB8\xD1\x80" } },
+        { "cjk", "\xE6\xBC\xA2\xE5\xAD\x97\xE3\x83\x86\xE3\x82\xB9\xE3\x83\x88", 18, 4,
+          { "\xE6\xBC\xA2\xE5\xAD\x97\xE3\x83\x86", "\xE3\x82\xB9\xE3\x83\x88" } },
+        { "emoji", "hi \xF0\x9F\x98\x80 yo", 120, 4, { "hi \xF0\x9F\x98\x80 yo" } },
+        { "emoji split", "\xF0\x9F\x98\x80\xF0\x9F\x98\x80", 30, 4, { "\xF0\x9F\x98\x80\xF0", "\x9F\x98\x80" } },
+        { "cut 2 byte sequence", "\xD0\x9F\xD1\x80\xD0\xB8 \xD0", 120, 4, { "\xD0\x9F\xD1\x80\xD0\xB8" } },
+        { "cut 3 byte sequence", "ab \xE5\xAD\x97\xE5\xAD", 120, 4, { "ab \xE5\xAD\x97" } },
+        { "cut sequence in a word", "a\xE5" "b c", 120, 4, { "a\xE5" "b c" } },
+        { "cut sequence at the ellipsis", "aaaa bbbb cccc\xE5\xAD", 54, 1, { "aaaa b..." } },
+    };
+
+    tft.setTextFont(1);
+    for(uint8_t size = 1; size <= 2; size++) {
+        tft.setTextSize(size);
+        for(Case c : glcd) {
+            c.maxWidth *= size;
+            check(tft, c);
+        }
+    }
+    tft.setTextSize(1);
+
+    // smooth font: 7 pixels for ASCII, 8 for Latin-1, 9 for Cyrillic, 15 for
+    // CJK, spaces 4, and 5 for the missing glyphs of emoji bytes
+    std::vector<uint8_t> font = makeFont(mixedScriptCodes(5000));
+    tft.loadFont(font.data());
+    const Case smooth[] = {
+        { "smooth mixed", "Hi \xD0\xBC\xD0\xB8\xD1\x80 \xE4\xB8\xAD\xE5\xAD\x97", 60, 4, { "Hi \xD0\xBC\xD0\xB8\xD1\x80", "\xE4\xB8\xAD\xE5\xAD\x97" } },
+        { "smooth latin-1", "caf\xC3\xA9 ol\xC3\xA9", 40, 4, { "caf\xC3\xA9", "ol\xC3\xA9" } },
+        { "smooth long cjk", "\xE4\xB8\xAD\xE5\xAD\x97\xE4\xB8\xAD\xE5\xAD\x97\xE4\xB8\xAD", 50, 4,
+          { "\xE4\xB8\xAD\xE5\xAD\x97\xE4\xB8\xAD", "\xE5\xAD\x97\xE4\xB8\xAD" } },
+        { "smooth emoji", "ok \xF0\x9F\x98\x80", 60, 4, { "ok \xF0\x9F\x98\x80" } },
+        { "smooth newline", "a\nb", 60, 4, { "a", "b" } },
+        { "smooth ellipsis", "aaaa bbbb cccc dddd eeee", 60, 2, { "aaaa bbbb", "cccc d..." } },
+        { "smooth cut sequence", "\xD0\xBC\xD0\xB8\xD1", 60, 4, { "\xD0\xBC\xD0\xB8" } },
+    };
+    for(const Case & c : smooth) {
+        check(tft, c);
+    }
+    tft.unloadFont();
+
+    printf("%zu GLCD layouts at 2 sizes and %zu smooth font layouts checked\n", sizeof(glcd) / sizeof(glcd[0]), sizeof(smooth) / sizeof(smooth[0]));
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
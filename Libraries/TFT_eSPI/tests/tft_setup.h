@@ -0,0 +1,34 @@
+// The CYD setup of User_Setup.h for the host tests: the generic processor
+// driver on the mock SPI bus, and no touch controller
+#define ILI9341_2_DRIVER
+
+#define TFT_WIDTH  240
+#define TFT_HEIGHT 320
+
+#define TFT_MOSI 13
+#define TFT_MISO 12
+#define TFT_SCLK 14
+#define TFT_CS   15
+#define TFT_DC   2
+#define TFT_RST  -1
+
+#define LOAD_GLCD
+#define LOAD_FONT2
+#define LOAD_FONT4
+#define LOAD_FONT6
+#define LOAD_FONT7
+#define LOAD_FONT8
+#define LOAD_GFXFF
+#define SMOOTH_FONT
+
+#define SPI_FREQUENCY       40000000
+#define SPI_READ_FREQUENCY  16000000
+
+#define DISABLE_ALL_LIBRARY_WARNINGS
+
+// glyphCache builds the library again with font files, on the in memory file
+// system of mock/FS.h, as the ESP32 processor header does with SPIFFS
+#ifdef HOST_FONT_FS
+  #include <FS.h>
+  #define FONT_FS_AVAILABLE
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file unicodeIndex.cpp
+ * getUnicodeIndex() against the linear search it replaced, for every 16 bit
+ * code, with a font in code order (binary searched in place) and one out of
+ * order with a repeated code (searched through gSorted)
+ */
+
+#include "Harness.h"
+
+// getUnicodeIndex() before the index: the first glyph with the code
+static bool linearIndex(const TFT_eSPI & tft, uint16_t unicode, uint16_t * index) {
+    for(uint16_t i = 0; i < tft.gFont.gCount; i++) {
+        if(tft.gUnicode[i] == unicode) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main() {
+    TFT_eSPI tft;
+    tft.init();
+    int failures = 0;
+
+    std::vector<uint16_t> codes = mixedScriptCodes(5000);
+    for(int shuffled = 0; shuffled < 2; shuffled++) {
+        std::vector<uint8_t> font = makeFont(codes, shuffled);
+        tft.loadFont(font.data());
+
+        const char * name = shuffled ? "shuffled font" : "sorted font";
+        if(tft.gInOrder == (bool)shuffled || !tft.gAscii || (shuffled && !tft.gSorted)) {
+            printf("FAIL %s: gInOrder %d, gAscii %p, gSorted %p\n", name, tft.gInOrder, (void *)tft.gAscii, (void *)tft.gSorted);
+            failures++;
+        }
+
+        size_t found = 0;
+        for(uint32_t code = 0; code <= 0xFFFF; code++) {
+            uint16_t expected = 0xFFFF, index = 0xFFFF;
+            bool expectedFound = linearIndex(tft, code, &expected);
+            bool indexFound    = tft.getUnicodeIndex(code, &index);
+            if(indexFound != expectedFound || (indexFound && index != expected)) {
+                if(failures < 20) {
+                    printf("FAIL %s: U+%04X found %d at %u, linear search found %d at %u\n", name, code, indexFound, index, expectedFound, expected);
+                }
+                failures++;
+            }
+            found += indexFound;
+        }
+        printf("%s: %u glyphs, %zu codes found, all as the linear search\n", name, tft.gFont.gCount, found);
+        tft.unloadFont();
+
+        if(tft.gAscii || tft.gSorted || tft.gInOrder) {
+            printf("FAIL %s: index left after unloadFont()\n", name);
+            failures++;
+        }
+    }
+
+    printf("%s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file unicodeIndexBench.cpp
+ * glyph lookups and drawString() of a 200 code point mixed-script comment
+ * with a 5000 glyph font, with the index built by loadFont() and with the
+ * linear search it replaced (the index tables dropped after loading)
+ */
+
+#include "Harness.h"
+
+#include <chrono>
+
+// best time of 7 runs of calls, in seconds per call
+template<typename F>
+static double measure(size_t calls, F f) {
+    double best = 0;
+    for(int run = 0; run < 7; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < calls; i++) {
+            f();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / calls;
+        if(run == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+// getUnicodeIndex() falls back to the linear search without the tables
+static void dropIndex(TFT_eSPI & tft) {
+    free(tft.gAscii);
+    free(tft.gSorted);
+    tft.gAscii   = NULL;
+    tft.gSorted  = NULL;
+    tft.gInOrder = false;
+}
+
+int main() {
+    TFT_eSPI tft;
+    tft.init();
+
+    const size_t length = 200;
+    std::string comment = mixedScriptComment(length);
+    std::vector<uint16_t> comment16;
+    for(uint16_t i = 0; i < comment.size();) {
+        comment16.push_back(tft.decodeUTF8((uint8_t *)comment.data(), &i, comment.size() - i));
+    }
+
+    // the comment is drawn as 10 lines of 20 code points
+    std::vector<std::string> lines;
+    for(size_t i = 0, start = 0, count = 0; i <= comment.size(); i++) {
+        if(i == comment.size() || ((comment[i] & 0xC0) != 0x80 && count++ == 20)) {
+            lines.push_back(comment.substr(start, i - start));
+            start = i;
+            count = 1;
+        }
+    }
+
+    printf("%zu code points, %zu bytes, 5000 glyph font\n", comment16.size(), comment.size());
+    printf("%-24s %18s %20s\n", "", "lookups/comment", "drawString/comment");
+
+    std::vector<uint16_t> codes = mixedScriptCodes(5000);
+    for(int shuffled = 0; shuffled < 2; shuffled++) {
+        std::vector<uint8_t> font = makeFont(codes, shuffled);
+        for(int indexed = 0; indexed < 2; indexed++) {
+            tft.loadFont(font.data());
+            if(!indexed) dropIndex(tft);
+
+            volatile uint32_t sink = 0;
+            double lookups = measure(200, [&]() {
+                for(uint16_t code : comment16) {
+                    uint16_t index = 0;
+                    if(tft.getUnicodeIndex(code, &index)) sink = sink + index;
+                }
+            });
+            double draws = measure(20, [&]() {
+                for(size_t line = 0; line < lines.size(); line++) {
+                    tft.drawString(lines[line].c_str(), 0, line * tft.gFont.yAdvance);
+                }
+            });
+
+            char name[32];
+            snprintf(name, sizeof(name), "%s, %s", shuffled ? "shuffled font" : "sorted font", indexed ? "index" : "linear");
+            printf("%-24s %15.1f us %17.1f us\n", name, lookups * 1e6, draws * 1e6);
+            tft.unloadFont();
+        }
+    }
+    return 0;
+}
@@ -24,6 +24,10 @@
 
 #include "WebSockets.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #ifdef ESP8266
 #include <core_esp8266_features.h>
 #endif
@@ -77,10 +81,63 @@ void WebSockets::clientDisconnect(WSclient_t * client, uint16_t code, char * rea
             buffer[1] = (code & 0xFF);
             sendFrame(client, WSop_close, &buffer[0], 2);
         }
+        sendFlush(client);
+        if(client->status != WSC_CONNECTED) {
+            // a failed write of the queued frames disconnected the client already
+            return;
+        }
     }
     clientDisconnect(client);
 }
 
+/**
+ * XOR data with the 4 byte frame mask (RFC 6455 5.3), used for both directions
+ * works a machine word at a time once data is aligned, SSE2 hosts do 16 byte
+ * @param data uint8_t *        payload, masked in place
+ * @param length size_t
+ * @param maskKey uint8_t[4]
+ * @param offset size_t         position of data[0] in the frame payload
+ */
+void WebSockets::maskPayload(uint8_t * data, size_t length, const uint8_t * maskKey, size_t offset) {
+    size_t i = 0;
+
+    // single bytes up to the first word boundary
+    while(i < length && ((uintptr_t)(data + i) % sizeof(size_t)) != 0) {
+        data[i] ^= maskKey[(offset + i) % 4];
+        i++;
+    }
+
+    // key repeated in memory order, starting at the key byte for data[i]
+    size_t key;
+    uint8_t * keyBytes = (uint8_t *)&key;
+    for(size_t k = 0; k < sizeof(key); k++) {
+        keyBytes[k] = maskKey[(offset + i + k) % 4];
+    }
+
+#ifdef __SSE2__
+    int32_t key32;
+    memcpy(&key32, keyBytes, sizeof(key32));
+    __m128i key128 = _mm_set1_epi32(key32);
+    for(; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+        _mm_storeu_si128((__m128i *)(data + i), _mm_xor_si128(v, key128));
+    }
+#endif
+
+    // memcpy keeps this safe on cores that trap unaligned access
+    for(; i + sizeof(key) <= length; i += sizeof(key)) {
+        size_t v;
+        memcpy(&v, data + i, sizeof(v));
+        v ^= key;
+        memcpy(data + i, &v, sizeof(v));
+    }
+
+    // tail, the loops above advance in multiples of 4 so the key is still in phase
+    for(size_t k = 0; i < length; i++, k++) {
+        data[i] ^= keyBytes[k];
+    }
+}
+
 /**
  *
  * @param buf uint8_t *         ptr to the buffer for writing
@@ -215,6 +272,12 @@ bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * pay
         DEBUG_WEBSOCKETS("[WS][%d][sendFrame] text: %s\n", client->num, (payload + (headerToPayload ? 14 : 0)));
     }
 
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0)
+    if(queueFrame(client, opcode, (headerToPayload && payload) ? (payload + WEBSOCKETS_MAX_HEADER_SIZE) : payload, length, fin)) {
+        return true;
+    }
+#endif
+
     uint8_t maskKey[4]                         = { 0x00, 0x00, 0x00, 0x00 };
     uint8_t buffer[WEBSOCKETS_MAX_HEADER_SIZE] = { 0 };
 
@@ -279,9 +342,7 @@ bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * pay
             dataMaskPtr = payloadPtr;
         }
 
-        for(size_t x = 0; x < length; x++) {
-            dataMaskPtr[x] = (dataMaskPtr[x] ^ maskKey[x % 4]);
-        }
+        maskPayload(dataMaskPtr, length, maskKey);
     }
 
 #ifndef NODEBUG_WEBSOCKETS
@@ -320,6 +381,85 @@ bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * pay
     return ret;
 }
 
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0)
+/**
+ * append a frame to the client transmit buffer, it is written by the next sendFlush()
+ * @param client WSclient_t *   ptr to the client struct
+ * @param opcode WSopcode_t
+ * @param payload uint8_t *     ptr to the payload
+ * @param length size_t         length of the payload
+ * @param fin bool
+ * @return false if the frame does not fit the buffer, the caller sends it directly
+ */
+bool WebSockets::queueFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool fin) {
+    size_t frameSize = length + (client->cIsClient ? 4 : 0);
+    if(length < 126) {
+        frameSize += 2;
+    } else if(length < 0xFFFF) {
+        frameSize += 4;
+    } else {
+        frameSize += 10;
+    }
+
+    if(frameSize > WEBSOCKETS_TX_BUFFER_SIZE) {
+        // queued frames have to go out first
+        sendFlush(client);
+        return false;
+    }
+
+    if(client->cWsTxLen + frameSize > WEBSOCKETS_TX_BUFFER_SIZE && !sendFlush(client)) {
+        return false;
+    }
+
+    // the copy is ours, so the client side can mask it with a real key
+    uint8_t maskKey[4] = { 0x00, 0x00, 0x00, 0x00 };
+    if(client->cIsClient) {
+        for(uint8_t x = 0; x < sizeof(maskKey); x++) {
+            maskKey[x] = random(0xFF);
+        }
+    }
+
+    uint8_t * frame    = &client->cWsTxBuffer[client->cWsTxLen];
+    uint8_t headerSize = createHeader(frame, opcode, length, client->cIsClient, maskKey, fin);
+    if(payload && length > 0) {
+        memcpy(frame + headerSize, payload, length);
+        if(client->cIsClient) {
+            maskPayload(frame + headerSize, length, maskKey);
+        }
+    }
+    client->cWsTxLen += headerSize + length;
+
+    DEBUG_WEBSOCKETS("[WS][%d][sendFrame] queued %u byte (%u pending)\n", client->num, frameSize, client->cWsTxLen);
+    return true;
+}
+#endif
+
+/**
+ * write all frames queued for the client with a single write
+ * a failed write disconnects the client, so the next sendFrame() returns false
+ * @param client WSclient_t *  ptr to the client struct
+ * @return true if ok
+ */
+bool WebSockets::sendFlush(WSclient_t * client) {
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0)
+    size_t len = client->cWsTxLen;
+    if(len == 0) {
+        return true;
+    }
+    client->cWsTxLen = 0;
+    if(write(client, &client->cWsTxBuffer[0], len) != len) {
+        // sendFrame() returned true for these frames, the connection is no use without them
+        DEBUG_WEBSOCKETS("[WS][%d][sendFlush] write of %u queued byte failed\n", client->num, len);
+        clientDisconnect(client);
+        return false;
+    }
+    return true;
+#else
+    UNUSED(client);
+    return true;
+#endif
+}
+
 /**
  * callen when HTTP header is done
  * @param client WSclient_t *  ptr to the client struct
@@ -339,6 +479,13 @@ void WebSockets::headerDone(WSclient_t * client) {
  * @param client WSclient_t *  ptr to the client struct
  */
 void WebSockets::handleWebsocket(WSclient_t * client) {
+#if(WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    if(client->cWsRxOut) {
+        // resume the frame where the last call ran out of data
+        readCbContinue(client);
+        return;
+    }
+#endif
     if(client->cWsRXsize == 0) {
         handleWebsocketCb(client);
     }
@@ -364,19 +511,21 @@ bool WebSockets::handleWebsocketWaitFor(WSclient_t * client, size_t size) {
     }
 
     DEBUG_WEBSOCKETS("[WS][%d][handleWebsocketWaitFor] size: %d cWsRXsize: %d\n", client->num, size, client->cWsRXsize);
-    readCb(client, &client->cWsHeader[client->cWsRXsize], (size - client->cWsRXsize), std::bind([](WebSockets * server, size_t size, WSclient_t * client, bool ok) {
+    // callbacks capture at most two words, so std::function keeps them without a malloc
+    readCb(client, &client->cWsHeader[client->cWsRXsize], (size - client->cWsRXsize), [this, size](WSclient_t * client, bool ok) {
         DEBUG_WEBSOCKETS("[WS][%d][handleWebsocketWaitFor][readCb] size: %d ok: %d\n", client->num, size, ok);
         if(ok) {
             client->cWsRXsize = size;
-            server->handleWebsocketCb(client);
+            handleWebsocketCb(client);
         } else {
             DEBUG_WEBSOCKETS("[WS][%d][readCb] failed.\n", client->num);
             client->cWsRXsize = 0;
             // timeout or error
-            server->clientDisconnect(client, 1002);
+            if(client->status == WSC_CONNECTED) {
+                clientDisconnect(client, 1002);
+            }
         }
-    },
-                                                                                          this, size, std::placeholders::_1, std::placeholders::_2));
+    });
     return false;
 }
 
@@ -451,6 +600,23 @@ void WebSockets::handleWebsocketCb(WSclient_t * client) {
     }
 
     if(header->payloadLen > 0) {
+#if(WEBSOCKETS_RX_BUFFER_SIZE > 0)
+        if(header->payloadLen <= WEBSOCKETS_RX_BUFFER_SIZE) {
+            payload = client->cWsRxBuffer;
+            readCb(client, payload, header->payloadLen, [this, payload](WSclient_t * client, bool ok) { handleWebsocketPayloadCb(client, ok, payload); });
+            return;
+        }
+#if WEBSOCKETS_RX_STREAM
+        if(header->opCode & 0x08) {
+            // control frames are limited to 125 byte and always fit the buffer
+            clientDisconnect(client, 1002);
+            return;
+        }
+        client->cWsRxOffset = 0;
+        readCb(client, client->cWsRxBuffer, WEBSOCKETS_RX_BUFFER_SIZE, [this](WSclient_t * client, bool ok) { handleWebsocketChunkCb(client, ok); });
+        return;
+#endif
+#endif
         // if text data we need one more
         payload = (uint8_t *)malloc(header->payloadLen + 1);
 
@@ -459,12 +625,24 @@ void WebSockets::handleWebsocketCb(WSclient_t * client) {
             clientDisconnect(client, 1011);
             return;
         }
-        readCb(client, payload, header->payloadLen, std::bind(&WebSockets::handleWebsocketPayloadCb, this, std::placeholders::_1, std::placeholders::_2, payload));
+        readCb(client, payload, header->payloadLen, [this, payload](WSclient_t * client, bool ok) { handleWebsocketPayloadCb(client, ok, payload); });
     } else {
         handleWebsocketPayloadCb(client, true, NULL);
     }
 }
 
+/**
+ * payload lives in the client RX buffer and must not be freed
+ */
+static inline bool isRxBuffer(WSclient_t * client, uint8_t * payload) {
+#if(WEBSOCKETS_RX_BUFFER_SIZE > 0)
+    return payload == client->cWsRxBuffer;
+#else
+    UNUSED(client);
+    return payload == NULL;
+#endif
+}
+
 void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t * payload) {
     WSMessageHeader_t * header = &client->cWsHeaderDecode;
     if(ok) {
@@ -473,9 +651,7 @@ void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t
 
             if(header->mask) {
                 // decode XOR
-                for(size_t i = 0; i < header->payloadLen; i++) {
-                    payload[i] = (payload[i] ^ header->maskKey[i % 4]);
-                }
+                maskPayload(payload, header->payloadLen, header->maskKey);
             }
         }
 
@@ -519,7 +695,7 @@ void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t
                 break;
         }
 
-        if(payload) {
+        if(payload && !isRxBuffer(client, payload)) {
             free(payload);
         }
 
@@ -532,10 +708,65 @@ void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t
 
     } else {
         DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] missing data!\n", client->num);
-        free(payload);
-        clientDisconnect(client, 1002);
+        if(!isRxBuffer(client, payload)) {
+            free(payload);
+        }
+        if(client->status == WSC_CONNECTED) {
+            clientDisconnect(client, 1002);
+        }
+    }
+}
+
+#if(WEBSOCKETS_RX_BUFFER_SIZE > 0) && WEBSOCKETS_RX_STREAM
+/**
+ * deliver one chunk of a frame bigger than the RX buffer and read the next one
+ * the first chunk keeps the frame opcode, the rest are continuations
+ * @param client WSclient_t *  ptr to the client struct
+ * @param ok bool  chunk read complete
+ */
+void WebSockets::handleWebsocketChunkCb(WSclient_t * client, bool ok) {
+    WSMessageHeader_t * header = &client->cWsHeaderDecode;
+    if(!ok) {
+        DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] missing data!\n", client->num);
+        if(client->status == WSC_CONNECTED) {
+            clientDisconnect(client, 1002);
+        }
+        return;
+    }
+
+    uint8_t * payload = client->cWsRxBuffer;
+    size_t offset     = client->cWsRxOffset;
+    size_t len        = std::min(header->payloadLen - offset, (size_t)WEBSOCKETS_RX_BUFFER_SIZE);
+    payload[len]      = 0x00;
+
+    if(header->mask) {
+        // decode XOR, the key position continues from the previous chunk
+        maskPayload(payload, len, header->maskKey, offset);
+    }
+
+    client->cWsRxOffset = offset + len;
+    bool last           = (client->cWsRxOffset == header->payloadLen);
+    DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] chunk %u of %u\n", client->num, client->cWsRxOffset, header->payloadLen);
+    messageReceived(client, offset == 0 ? header->opCode : WSop_continuation, payload, len, last && header->fin);
+
+    if(!last) {
+        if(!client->tcp) {
+            // callback disconnected the client
+            return;
+        }
+        len = std::min(header->payloadLen - client->cWsRxOffset, (size_t)WEBSOCKETS_RX_BUFFER_SIZE);
+        readCb(client, payload, len, [this](WSclient_t * client, bool ok) { handleWebsocketChunkCb(client, ok); });
+        return;
     }
+
+    // reset input
+    client->cWsRXsize = 0;
+#if(WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
+    // register callback for next message
+    handleWebsocketWaitFor(client, 2);
+#endif
 }
+#endif
 
 /**
  * generate the key for Sec-WebSocket-Accept
@@ -588,10 +819,11 @@ String WebSockets::base64_encode(uint8_t * data, size_t length) {
 
 /**
  * read x byte from tcp or get timeout
+ * sync backends do not wait, a partial read is resumed by handleWebsocket()
  * @param client WSclient_t *
  * @param out  uint8_t * data buffer
  * @param n size_t byte count
- * @return true if ok
+ * @return true if the read completed (async: was started)
  */
 bool WebSockets::readCb(WSclient_t * client, uint8_t * out, size_t n, WSreadWaitCb cb) {
 #if(WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
@@ -607,59 +839,84 @@ bool WebSockets::readCb(WSclient_t * client, uint8_t * out, size_t n, WSreadWait
                                        client, std::placeholders::_1, cb));
 
 #else
-    unsigned long t = millis();
-    ssize_t len;
-    DEBUG_WEBSOCKETS("[readCb] n: %zu t: %lu\n", n, t);
-    while(n > 0) {
+    // the read completes in the callback, now or from a later handleWebsocket() call
+    client->cWsRxOut      = out;
+    client->cWsRxLeft     = n;
+    client->cWsRxCb       = std::move(cb);
+    client->cWsRxLastData = millis();
+    DEBUG_WEBSOCKETS("[readCb] n: %zu t: %lu\n", n, client->cWsRxLastData);
+    return readCbContinue(client);
+#endif
+    return true;
+}
+
+#if(WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+/**
+ * take what the network has for the pending read, never waits for more
+ * @param client WSclient_t *
+ * @return true if the read completed
+ */
+bool WebSockets::readCbContinue(WSclient_t * client) {
+    while(client->cWsRxLeft > 0) {
         if(client->tcp == NULL) {
             DEBUG_WEBSOCKETS("[readCb] tcp is null!\n");
-            if(cb) {
-                cb(client, false);
-            }
-            return false;
+            return readCbDone(client, false);
         }
 
         if(!client->tcp->connected()) {
             DEBUG_WEBSOCKETS("[readCb] not connected!\n");
-            if(cb) {
-                cb(client, false);
-            }
-            return false;
+            return readCbDone(client, false);
         }
 
-        if((millis() - t) > WEBSOCKETS_TCP_TIMEOUT) {
-            DEBUG_WEBSOCKETS("[readCb] receive TIMEOUT! %lu\n", (millis() - t));
-            if(cb) {
-                cb(client, false);
+        if(!client->tcp->available()) {
+            if((millis() - client->cWsRxLastData) > WEBSOCKETS_TCP_TIMEOUT) {
+                DEBUG_WEBSOCKETS("[readCb] receive TIMEOUT! %lu\n", (millis() - client->cWsRxLastData));
+                return readCbDone(client, false);
             }
+            // come back on the next loop()
             return false;
         }
 
-        if(!client->tcp->available()) {
-            WEBSOCKETS_YIELD_MORE();
-            continue;
-        }
-
-        len = client->tcp->read((uint8_t *)out, n);
-        if(len > 0) {
-            t = millis();
-            out += len;
-            n -= len;
-            // DEBUG_WEBSOCKETS("Receive %d left %d!\n", len, n);
-        } else {
-            // DEBUG_WEBSOCKETS("Receive %d left %d!\n", len, n);
-        }
-        if(n > 0) {
-            WEBSOCKETS_YIELD();
+        ssize_t len = client->tcp->read(client->cWsRxOut, client->cWsRxLeft);
+        if(len <= 0) {
+            return false;
         }
+        client->cWsRxLastData = millis();
+        client->cWsRxOut += len;
+        client->cWsRxLeft -= len;
     }
+    return readCbDone(client, true);
+}
+
+/**
+ * finish the pending read and run its callback
+ * the callback may start the next read
+ * @param client WSclient_t *
+ * @param ok bool
+ * @return ok
+ */
+bool WebSockets::readCbDone(WSclient_t * client, bool ok) {
+    WSreadWaitCb cb = std::move(client->cWsRxCb);
+    client->cWsRxCb   = nullptr;
+    client->cWsRxOut  = NULL;
+    client->cWsRxLeft = 0;
     if(cb) {
-        cb(client, true);
+        cb(client, ok);
     }
-    WEBSOCKETS_YIELD();
-#endif
-    return true;
+    return ok;
+}
+
+/**
+ * fail a read still waiting for data, called on disconnect so its buffer is released
+ * @param client WSclient_t *
+ */
+void WebSockets::readCbAbort(WSclient_t * client) {
+    if(client->cWsRxOut) {
+        readCbDone(client, false);
+    }
+    client->cWsRXsize = 0;
 }
+#endif
 
 /**
  * write x byte to tcp or get timeout
@@ -673,6 +930,10 @@ size_t WebSockets::write(WSclient_t * client, uint8_t * out, size_t n) {
         return 0;
     if(client == NULL)
         return 0;
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0)
+    // direct writes have to follow the queued frames
+    sendFlush(client);
+#endif
     unsigned long t = millis();
     size_t len      = 0;
     size_t total    = 0;
@@ -139,6 +139,27 @@
 // max size of the WS Message Header
 #define WEBSOCKETS_MAX_HEADER_SIZE (14)
 
+// size of the per client payload buffer, 0 allocates every frame from the heap
+#ifndef WEBSOCKETS_RX_BUFFER_SIZE
+#define WEBSOCKETS_RX_BUFFER_SIZE (0)
+#endif
+
+// deliver frames bigger than the payload buffer in chunks (WStype_FRAGMENT_*)
+// instead of allocating them whole
+#ifndef WEBSOCKETS_RX_STREAM
+#define WEBSOCKETS_RX_STREAM (0)
+#endif
+
+// size of the per client transmit buffer, 0 writes every frame right away
+// frames that fit are queued and flushed in one write at the end of loop()
+#ifndef WEBSOCKETS_TX_BUFFER_SIZE
+#define WEBSOCKETS_TX_BUFFER_SIZE (0)
+#endif
+
+#if(WEBSOCKETS_RX_BUFFER_SIZE > 0) && (WEBSOCKETS_RX_BUFFER_SIZE < 125)
+#error "WEBSOCKETS_RX_BUFFER_SIZE must hold a control frame (125 byte)"
+#endif
+
 #if !defined(WEBSOCKETS_NETWORK_TYPE)
 // select Network type based
 #if defined(ESP8266) || defined(ESP31B)
@@ -294,6 +315,10 @@
 #define HAS_SSL
 #endif
 
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0) && (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
+#error "WEBSOCKETS_TX_BUFFER_SIZE is flushed from loop() and needs a sync network type"
+#endif
+
 // moves all Header strings to Flash (~300 Byte)
 #ifdef WEBSOCKETS_SAVE_RAM
 #define WEBSOCKETS_STRING(var) F(var)
@@ -347,7 +372,7 @@ typedef struct {
     uint8_t * maskKey;
 } WSMessageHeader_t;
 
-typedef struct {
+typedef struct WSclient_t {
     void init(uint8_t num,
         uint32_t pingInterval,
         uint32_t pongTimeout,
@@ -389,6 +414,23 @@ typedef struct {
     uint8_t cWsHeader[WEBSOCKETS_MAX_HEADER_SIZE];    ///< RX WS Message buffer
     WSMessageHeader_t cWsHeaderDecode;
 
+#if(WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    uint8_t * cWsRxOut = NULL;                                   ///< destination of the pending read, NULL if none
+    size_t cWsRxLeft   = 0;                                      ///< bytes the pending read still waits for
+    uint32_t cWsRxLastData = 0;                                  ///< millis when the pending read last got data
+    std::function<void(WSclient_t * client, bool ok)> cWsRxCb;    ///< runs when the pending read completes or fails
+#endif
+
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0)
+    uint8_t cWsTxBuffer[WEBSOCKETS_TX_BUFFER_SIZE];    ///< queued outgoing frames
+    size_t cWsTxLen = 0;                               ///< bytes queued in cWsTxBuffer
+#endif
+
+#if(WEBSOCKETS_RX_BUFFER_SIZE > 0)
+    uint8_t cWsRxBuffer[WEBSOCKETS_RX_BUFFER_SIZE + 1];    ///< RX payload buffer, reused for every frame
+    size_t cWsRxOffset = 0;                                ///< payload bytes delivered of a streamed frame
+#endif
+
     String base64Authorization;    ///< Base64 encoded Auth request
     String plainAuthorization;     ///< Base64 encoded Auth request
 
@@ -426,8 +468,13 @@ class WebSockets {
     virtual void messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool fin) = 0;
 
     uint8_t createHeader(uint8_t * buf, WSopcode_t opcode, size_t length, bool mask, uint8_t maskKey[4], bool fin);
+    static void maskPayload(uint8_t * data, size_t length, const uint8_t * maskKey, size_t offset = 0);
     bool sendFrameHeader(WSclient_t * client, WSopcode_t opcode, size_t length = 0, bool fin = true);
     bool sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * payload = NULL, size_t length = 0, bool fin = true, bool headerToPayload = false);
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0)
+    bool queueFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool fin);
+#endif
+    bool sendFlush(WSclient_t * client);
 
     void headerDone(WSclient_t * client);
 
@@ -436,11 +483,19 @@ class WebSockets {
     bool handleWebsocketWaitFor(WSclient_t * client, size_t size);
     void handleWebsocketCb(WSclient_t * client);
     void handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t * payload);
+#if(WEBSOCKETS_RX_BUFFER_SIZE > 0) && WEBSOCKETS_RX_STREAM
+    void handleWebsocketChunkCb(WSclient_t * client, bool ok);
+#endif
 
     String acceptKey(String & clientKey);
     String base64_encode(uint8_t * data, size_t length);
 
     bool readCb(WSclient_t * client, uint8_t * out, size_t n, WSreadWaitCb cb);
+#if(WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    bool readCbContinue(WSclient_t * client);
+    bool readCbDone(WSclient_t * client, bool ok);
+    void readCbAbort(WSclient_t * client);
+#endif
     virtual size_t write(WSclient_t * client, uint8_t * out, size_t n);
     size_t write(WSclient_t * client, const char * out);
 
@@ -329,6 +329,7 @@ void WebSocketsClient::loop(void) {
         if(_client.status == WSC_CONNECTED) {
             handleHBPing();
             handleHBTimeout(&_client);
+            sendFlush(&_client);
         }
     }
 }
@@ -569,6 +570,13 @@ void WebSocketsClient::clientDisconnect(WSclient_t * client) {
     client->status      = WSC_NOT_CONNECTED;
     _lastConnectionFail = millis();
 
+#if(WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    readCbAbort(client);
+#endif
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0)
+    client->cWsTxLen = 0;
+#endif
+
     DEBUG_WEBSOCKETS("[WS-Client] client disconnected.\n");
     if(event) {
         runCbEvent(WStype_DISCONNECTED, NULL, 0);
@@ -637,6 +645,9 @@ void WebSocketsClient::handleClientData(void) {
                 WebSockets::clientDisconnect(&_client, 1002);
                 break;
         }
+    } else if(_client.status == WSC_CONNECTED && _client.cWsRxOut) {
+        // no data for a started frame, check its timeout
+        WebSockets::handleWebsocket(&_client);
     }
     WEBSOCKETS_YIELD();
 }
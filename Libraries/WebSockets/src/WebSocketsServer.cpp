@@ -596,6 +596,13 @@ void WebSocketsServerCore::clientDisconnect(WSclient_t * client) {
 
     client->status = WSC_NOT_CONNECTED;
 
+#if(WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    readCbAbort(client);
+#endif
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0)
+    client->cWsTxLen = 0;
+#endif
+
     DEBUG_WEBSOCKETS("[WS-Server][%d] client disconnected.\n", client->num);
 
     runCbEvent(client->num, WStype_DISCONNECTED, NULL, 0);
@@ -713,10 +720,14 @@ void WebSocketsServerCore::handleClientData(void) {
                         WebSockets::clientDisconnect(client, 1002);
                         break;
                 }
+            } else if(client->status == WSC_CONNECTED && client->cWsRxOut) {
+                // no data for a started frame, check its timeout
+                WebSockets::handleWebsocket(client);
             }
 
             handleHBPing(client);
             handleHBTimeout(client);
+            sendFlush(client);
         }
         WEBSOCKETS_YIELD();
     }
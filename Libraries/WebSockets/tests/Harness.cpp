@@ -0,0 +1,112 @@
+/**
+ * @file Harness.cpp
+ */
+
+#include "Harness.h"
+
+#include <malloc.h>
+
+unsigned long hostMillis = 0;
+
+// glibc: the process wide malloc() is replaced, operator new goes through it
+extern "C" void * __libc_malloc(size_t size);
+extern "C" void __libc_free(void * ptr);
+
+static bool counting = false;
+static HeapStats stats;
+
+extern "C" void * malloc(size_t size) {
+    void * ptr = __libc_malloc(size);
+    if(counting && ptr) {
+        stats.allocations++;
+        stats.live += malloc_usable_size(ptr);
+        stats.peak = std::max(stats.peak, stats.live);
+    }
+    return ptr;
+}
+
+extern "C" void free(void * ptr) {
+    if(counting && ptr) {
+        stats.live -= std::min(stats.live, malloc_usable_size(ptr));
+    }
+    __libc_free(ptr);
+}
+
+void heapCountStart() {
+    stats    = HeapStats();
+    counting = true;
+}
+
+HeapStats heapCountStop() {
+    counting = false;
+    return stats;
+}
+
+void appendFrame(std::vector<uint8_t> & out, WSopcode_t opcode, const uint8_t * payload, size_t length, bool fin, const uint8_t * maskKey) {
+    out.push_back((fin ? 0x80 : 0x00) | opcode);
+    uint8_t mask = maskKey ? 0x80 : 0x00;
+    if(length < 126) {
+        out.push_back(mask | length);
+    } else if(length < 0x10000) {
+        out.push_back(mask | 126);
+        out.push_back(length >> 8);
+        out.push_back(length & 0xFF);
+    } else {
+        out.push_back(mask | 127);
+        for(int shift = 56; shift >= 0; shift -= 8) {
+            out.push_back((uint64_t)length >> shift);
+        }
+    }
+    if(maskKey) {
+        out.insert(out.end(), maskKey, maskKey + 4);
+    }
+    for(size_t i = 0; i < length; i++) {
+        out.push_back(payload[i] ^ (maskKey ? maskKey[i % 4] : 0));
+    }
+}
+
+HostSocket::HostSocket(bool isClient, size_t reserve) {
+    client.tcp       = &tcp;
+    client.status    = WSC_CONNECTED;
+    client.cIsClient = isClient;
+    delivered.reserve(reserve);
+    messageEnds.reserve(reserve);
+    tcp.tx.reserve(reserve);
+}
+
+void HostSocket::loopOnce() {
+    if(client.status != WSC_CONNECTED) {
+        return;
+    }
+    if(tcp.available() > 0 || client.cWsRxOut) {
+        handleWebsocket(&client);
+    }
+}
+
+void HostSocket::clientDisconnect(WSclient_t * client) {
+    disconnects++;
+    client->status = WSC_NOT_CONNECTED;
+    client->tcp    = NULL;
+    readCbAbort(client);
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0)
+    client->cWsTxLen = 0;
+#endif
+}
+
+bool HostSocket::clientIsConnected(WSclient_t * client) {
+    return client->status == WSC_CONNECTED;
+}
+
+void HostSocket::messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool fin) {
+    UNUSED(client);
+    calls++;
+    if(opcode & 0x08) {
+        // may come between the frames of a message
+        controls++;
+        return;
+    }
+    delivered.insert(delivered.end(), payload, payload + length);
+    if(fin) {
+        messageEnds.push_back(delivered.size());
+    }
+}
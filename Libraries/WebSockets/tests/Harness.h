@@ -0,0 +1,63 @@
+/**
+ * @file Harness.h
+ * host harness: a WebSockets endpoint on a fake TCP connection
+ * (mock/Ethernet.h), heap counters and a frame writer
+ */
+
+#ifndef HARNESS_H_
+#define HARNESS_H_
+
+#include <WebSockets.h>
+
+#include <vector>
+
+// heap use of the whole process while counting (Harness.cpp replaces malloc)
+struct HeapStats {
+    size_t allocations;
+    size_t live;
+    size_t peak;
+};
+
+void heapCountStart();
+HeapStats heapCountStop();
+
+/**
+ * append one frame, as the peer would send it
+ * @param maskKey uint8_t[4]  NULL sends the payload unmasked
+ */
+void appendFrame(std::vector<uint8_t> & out, WSopcode_t opcode, const uint8_t * payload, size_t length, bool fin, const uint8_t * maskKey);
+
+/**
+ * one connected endpoint, it keeps what messageReceived() delivers
+ * the storage, and what is written to tcp, is reserved up front so it
+ * doesn't count as heap use
+ */
+class HostSocket : public WebSockets {
+  public:
+    WSclient_t client;
+    EthernetClient tcp;
+
+    std::vector<uint8_t> delivered;    ///< payload bytes of all text and binary messages
+    std::vector<size_t> messageEnds;    ///< offset in delivered where each message ends
+    size_t calls        = 0;            ///< messageReceived() calls
+    size_t controls     = 0;            ///< ping and pong frames
+    size_t disconnects  = 0;
+
+    explicit HostSocket(bool isClient = false, size_t reserve = 0);
+
+    // one loop() of a sync backend, like WebSocketsClient::handleClientData()
+    void loopOnce();
+
+    using WebSockets::clientDisconnect;
+    using WebSockets::handleWebsocket;
+    using WebSockets::maskPayload;
+    using WebSockets::sendFlush;
+    using WebSockets::sendFrame;
+
+  protected:
+    void clientDisconnect(WSclient_t * client) override;
+    bool clientIsConnected(WSclient_t * client) override;
+    void messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool fin) override;
+};
+
+#endif /* HARNESS_H_ */
@@ -0,0 +1,67 @@
+/**
+ * @file mask.cpp
+ * maskPayload() against a byte at a time reference, for every alignment of
+ * the data and every key phase, so the byte, word and SSE2 loops all run at
+ * each of their boundaries
+ *
+ * built twice (see CMakeLists.txt): as is, and with __SSE2__ undefined so
+ * the word loop does the work the SSE2 loop does on this host
+ */
+
+#include "Harness.h"
+
+#include <vector>
+
+static void referenceMask(uint8_t * data, size_t length, const uint8_t * maskKey, size_t offset) {
+    for(size_t i = 0; i < length; i++) {
+        data[i] ^= maskKey[(offset + i) % 4];
+    }
+}
+
+int main() {
+    const uint8_t maskKey[4] = { 0x9a, 0x13, 0x77, 0xe1 };
+    std::vector<uint8_t> data(512), expected(512);
+    int failures = 0;
+
+#ifdef __SSE2__
+    printf("maskPayload: byte, word and SSE2 loops\n");
+#else
+    printf("maskPayload: byte and word loops\n");
+#endif
+
+    for(size_t align = 0; align < 16; align++) {
+        for(size_t length = 0; length <= 256; length++) {
+            for(size_t offset = 0; offset < 8; offset++) {
+                for(size_t i = 0; i < data.size(); i++) {
+                    data[i] = expected[i] = (uint8_t)rand();
+                }
+                HostSocket::maskPayload(&data[align], length, maskKey, offset);
+                referenceMask(&expected[align], length, maskKey, offset);
+                // the bytes around the payload must be left alone too
+                if(data != expected) {
+                    printf("MISMATCH alignment %zu length %zu key phase %zu\n", align, length, offset);
+                    failures++;
+                }
+            }
+        }
+    }
+
+    // a frame unmasked in chunks, as WEBSOCKETS_RX_STREAM does, with the
+    // key phase carried from one chunk to the next
+    for(size_t chunk = 1; chunk <= 64; chunk++) {
+        for(size_t i = 0; i < data.size(); i++) {
+            data[i] = expected[i] = (uint8_t)rand();
+        }
+        for(size_t offset = 0; offset < 500; offset += chunk) {
+            HostSocket::maskPayload(&data[3 + offset], std::min(chunk, 500 - offset), maskKey, offset);
+        }
+        referenceMask(&expected[3], 500, maskKey, 0);
+        if(data != expected) {
+            printf("MISMATCH chunks of %zu\n", chunk);
+            failures++;
+        }
+    }
+
+    printf("%s\n", failures ? "failed" : "ok");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file maskBench.cpp
+ * maskPayload() throughput on frames of 1 KB to 15 KB, against the byte at a
+ * time loop it replaced, with the data starting off a word boundary as a
+ * payload after a 2 or 6 byte header does
+ *
+ * built twice (see CMakeLists.txt): as is, and with the word loop only
+ */
+
+#include "Harness.h"
+
+#include <chrono>
+#include <vector>
+
+static void byteMask(uint8_t * data, size_t length, const uint8_t * maskKey, size_t offset) {
+    for(size_t i = 0; i < length; i++) {
+        data[i] ^= maskKey[(offset + i) % 4];
+    }
+}
+
+// best time of 7 runs of calls masks, in seconds per mask
+template<typename F>
+static double measure(size_t calls, F f) {
+    double best = 0;
+    for(int run = 0; run < 7; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < calls; i++) {
+            f(i);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / calls;
+        if(run == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+int main() {
+    const uint8_t maskKey[4] = { 0x9a, 0x13, 0x77, 0xe1 };
+    std::vector<uint8_t> buffer(16 * 1024 + 16);
+    uint8_t * data = &buffer[6];
+
+#ifdef __SSE2__
+    printf("maskPayload with the SSE2 loop\n");
+#else
+    printf("maskPayload with the word loop\n");
+#endif
+    printf("%8s %14s %14s %8s\n", "bytes", "byte GB/s", "maskPayload", "speedup");
+
+    const size_t sizes[] = { 1024, 4096, 15 * 1024 };
+    for(size_t length : sizes) {
+        size_t calls = 100000000 / length;
+        double bytewise = measure(calls, [&](size_t i) {
+            byteMask(data, length, maskKey, i);
+            asm volatile("" : : "r"(data) : "memory");
+        });
+        double masked = measure(calls, [&](size_t i) {
+            HostSocket::maskPayload(data, length, maskKey, i);
+            asm volatile("" : : "r"(data) : "memory");
+        });
+        printf("%8zu %14.2f %14.2f %7.1fx\n", length, length / bytewise / 1e9, length / masked / 1e9, bytewise / masked);
+    }
+    return 0;
+}
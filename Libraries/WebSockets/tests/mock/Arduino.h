@@ -0,0 +1,76 @@
+/**
+ * Arduino.h for the host tests, only what WebSockets.cpp needs
+ */
+
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+// time runs only when the test moves it
+extern unsigned long hostMillis;
+
+inline unsigned long millis() {
+    return hostMillis;
+}
+
+inline unsigned long micros() {
+    return hostMillis * 1000;
+}
+
+inline void delay(unsigned long ms) {
+    hostMillis += ms;
+}
+
+inline void yield() {
+}
+
+inline long random(long max) {
+    return rand() % max;
+}
+
+#define bit(b) (1UL << (b))
+#define F(string_literal) (string_literal)
+
+class String {
+  public:
+    String(const char * cstr = "")
+        : s(cstr ? cstr : "") {
+    }
+
+    const char * c_str() const {
+        return s.c_str();
+    }
+
+    unsigned int length() const {
+        return s.length();
+    }
+
+    void trim() {
+        size_t first = s.find_first_not_of(" \t\r\n");
+        size_t last  = s.find_last_not_of(" \t\r\n");
+        s            = first == std::string::npos ? "" : s.substr(first, last - first + 1);
+    }
+
+    String & operator+=(const char * cstr) {
+        s += cstr;
+        return *this;
+    }
+
+    friend String operator+(const String & a, const char * b) {
+        String r(a);
+        r += b;
+        return r;
+    }
+
+  private:
+    std::string s;
+};
+
+#endif /* HOST_ARDUINO_H_ */
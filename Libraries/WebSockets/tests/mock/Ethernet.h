@@ -0,0 +1,69 @@
+/**
+ * Ethernet.h for the host tests
+ * EthernetClient is a fake TCP connection: it hands out a recorded byte stream
+ * in segments no bigger than readSegment, and records what is written
+ */
+
+#ifndef HOST_ETHERNET_H_
+#define HOST_ETHERNET_H_
+
+#include <Arduino.h>
+
+#include <vector>
+
+class EthernetClient {
+  public:
+    std::vector<uint8_t> rx;    ///< bytes the peer sends
+    size_t rxPos       = 0;
+    size_t readSegment = 1460;    ///< most bytes one read() returns
+    size_t rxPerMs     = 0;       ///< bytes arriving per millisecond, 0 = all at once
+
+    std::vector<uint8_t> tx;    ///< bytes written, in order
+    size_t writes       = 0;    ///< write() calls, one syscall each
+    size_t segments     = 0;    ///< TCP segments the writes need (no Nagle)
+    size_t mss          = 1460;
+    size_t failWritesAt = 0;    ///< write() fails once tx holds this many bytes, 0 = never
+
+    bool open = true;
+
+    int connected() {
+        return open;
+    }
+
+    int available() {
+        return (int)(arrived() - rxPos);
+    }
+
+    int read(uint8_t * buf, size_t size) {
+        size_t n = std::min(std::min(arrived() - rxPos, size), readSegment);
+        memcpy(buf, rx.data() + rxPos, n);
+        rxPos += n;
+        return (int)n;
+    }
+
+    size_t write(const uint8_t * buf, size_t size) {
+        writes++;
+        if(failWritesAt && tx.size() + size > failWritesAt) {
+            open = false;
+            return 0;
+        }
+        segments += (size + mss - 1) / mss;
+        tx.insert(tx.end(), buf, buf + size);
+        return size;
+    }
+
+    void flush() {
+    }
+
+    void stop() {
+        open = false;
+    }
+
+  private:
+    size_t arrived() const {
+        size_t n = rxPerMs ? hostMillis * rxPerMs : rx.size();
+        return std::min(n, rx.size());
+    }
+};
+
+#endif /* HOST_ETHERNET_H_ */
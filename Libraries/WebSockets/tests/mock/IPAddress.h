@@ -0,0 +1,3 @@
+/**
+ * IPAddress.h for the host tests
+ */
@@ -0,0 +1,3 @@
+/**
+ * SPI.h for the host tests
+ */
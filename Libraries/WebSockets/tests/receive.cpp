@@ -0,0 +1,232 @@
+/**
+ * @file receive.cpp
+ * replays a long session of relay events into handleWebsocket() and checks
+ * that every message is delivered intact, under several ways the bytes can
+ * arrive, while counting the heap use of the receive path
+ *
+ * built once per receive mode (see CMakeLists.txt):
+ *   heap:   WEBSOCKETS_RX_BUFFER_SIZE 0, every frame is malloc()ed
+ *   buffer: frames that fit the per client buffer are read into it
+ *   stream: bigger frames are delivered in chunks of the buffer size
+ *
+ * then a peer that stops sending inside a frame: loop() must return at once
+ * on every call while it waits, deliver the frame when the rest comes, and
+ * disconnect once nothing arrived for WEBSOCKETS_TCP_TIMEOUT
+ */
+
+#include "Harness.h"
+
+#include <random>
+#include <string>
+
+struct Session {
+    std::vector<uint8_t> stream;         ///< what the server sends
+    std::vector<uint8_t> messages;       ///< payload of every message
+    std::vector<size_t> messageEnds;
+    size_t controls  = 0;        ///< pings
+    size_t frames    = 0;
+    size_t bigFrames = 0;    ///< frames bigger than WEBSOCKETS_RX_BUFFER_SIZE
+};
+
+static void addFrame(Session & s, WSopcode_t opcode, const uint8_t * payload, size_t length, bool fin, const uint8_t * maskKey) {
+    appendFrame(s.stream, opcode, payload, length, fin, maskKey);
+    s.frames++;
+    if(length > WEBSOCKETS_RX_BUFFER_SIZE) {
+        s.bigFrames++;
+    }
+}
+
+static void addMessage(Session & s, std::mt19937 & rng, WSopcode_t opcode, const std::string & payload, bool masked) {
+    uint8_t key[4] = { (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng() };
+
+    // one in 40 comes in 2 or 3 frames, with a ping in between
+    size_t parts = (opcode != WSop_ping && rng() % 40 == 0) ? 2 + rng() % 2 : 1;
+    size_t start = 0;
+    for(size_t i = 0; i < parts; i++) {
+        size_t end    = (i + 1 == parts) ? payload.size() : start + rng() % (payload.size() - start + 1);
+        WSopcode_t op = i ? WSop_continuation : opcode;
+        addFrame(s, op, (const uint8_t *)payload.data() + start, end - start, i + 1 == parts, masked ? key : NULL);
+        start = end;
+        if(i + 1 < parts) {
+            addFrame(s, WSop_ping, (const uint8_t *)"hb", 2, true, NULL);
+            s.controls++;
+        }
+    }
+    if(opcode == WSop_ping) {
+        s.controls++;
+        return;
+    }
+    s.messages.insert(s.messages.end(), payload.begin(), payload.end());
+    s.messageEnds.push_back(s.messages.size());
+}
+
+// chat, gift and like events as the relay sends them, and raw events up to
+// the 1 KB frame limit of the host build (WEBSOCKETS_MAX_DATA_SIZE)
+static Session recordSession(size_t events) {
+    Session s;
+    std::mt19937 rng(42);
+    for(size_t i = 0; i < events; i++) {
+        std::string user = "viewer_" + std::to_string(rng() % 5000);
+        std::string payload;
+        switch(rng() % 8) {
+            case 0:
+                payload = "{\"type\":\"gift\",\"username\":\"" + user + "\",\"giftName\":\"Rose\",\"giftId\":5655,\"repeatCount\":" + std::to_string(rng() % 100) + "}";
+                break;
+            case 1:
+                payload = "{\"type\":\"like\",\"username\":\"" + user + "\",\"likeCount\":" + std::to_string(rng() % 20) + "}";
+                break;
+            case 2: {
+                payload = "{\"type\":\"member\",\"data\":{\"user\":\"" + user + "\",\"urls\":[";
+                size_t size = 200 + rng() % 800;
+                while(payload.size() < size) {
+                    payload += "\"https://p16-sign-va.tiktokcdn.com/avt/" + std::to_string(rng()) + ".jpeg\",";
+                }
+                payload.resize(size - 3);
+                payload += "\"]}";
+                break;
+            }
+            default:
+                payload = "{\"type\":\"chat\",\"username\":\"" + user + "\",\"message\":\"";
+                for(size_t n = rng() % 150; n > 0; n--) {
+                    payload += (char)('a' + rng() % 26);
+                }
+                payload += "\"}";
+                break;
+        }
+        addMessage(s, rng, (rng() % 4) ? WSop_text : WSop_binary, payload, rng() % 2);
+        if(i % 1000 == 999) {
+            addMessage(s, rng, WSop_ping, "keepalive", false);
+        }
+    }
+    return s;
+}
+
+struct Arrival {
+    const char * name;
+    size_t readSegment;
+    size_t rxPerMs;
+};
+
+// a 200 byte text frame, cut after its first sent bytes
+static std::vector<uint8_t> stalledFrame(std::vector<uint8_t> & rest, size_t sent, std::string & payload) {
+    payload.clear();
+    for(size_t i = 0; i < 200; i++) {
+        payload += (char)('a' + i % 26);
+    }
+    const uint8_t key[4] = { 0x12, 0x34, 0x56, 0x78 };
+    std::vector<uint8_t> frame;
+    appendFrame(frame, WSop_text, (const uint8_t *)payload.data(), payload.size(), true, key);
+    rest.assign(frame.begin() + sent, frame.end());
+    frame.resize(sent);
+    return frame;
+}
+
+// the peer stops after sent bytes for a while, then sends the rest
+static bool stallCase(size_t sent) {
+    std::vector<uint8_t> rest;
+    std::string payload;
+    HostSocket socket(false, 256);
+    socket.tcp.rx = stalledFrame(rest, sent, payload);
+    hostMillis    = 0;
+
+    bool ok = true;
+    for(int i = 0; i < 1000; i++) {
+        unsigned long before = hostMillis;
+        socket.loopOnce();
+        if(hostMillis != before) {
+            // a loop() that waits for the rest of the frame moves the mock clock
+            printf("stall after %zu byte: loop() %d took %lu ms\n", sent, i, hostMillis - before);
+            ok = false;
+            break;
+        }
+        hostMillis++;
+    }
+    ok = ok && socket.client.status == WSC_CONNECTED && socket.calls == 0;
+
+    socket.tcp.rx.insert(socket.tcp.rx.end(), rest.begin(), rest.end());
+    socket.loopOnce();
+    ok = ok && socket.disconnects == 0 && socket.delivered == std::vector<uint8_t>(payload.begin(), payload.end());
+    printf("%-24s %s\n", ("stall after " + std::to_string(sent) + " byte").c_str(), ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+// the peer stops after sent bytes for good
+static bool timeoutCase(size_t sent) {
+    std::vector<uint8_t> rest;
+    std::string payload;
+    HostSocket socket(false, 256);
+    socket.tcp.rx = stalledFrame(rest, sent, payload);
+    hostMillis    = 0;
+
+    heapCountStart();
+    socket.loopOnce();
+    while(hostMillis <= WEBSOCKETS_TCP_TIMEOUT) {
+        hostMillis++;
+        socket.loopOnce();
+        if(socket.disconnects != 0) {
+            break;
+        }
+    }
+    HeapStats heap = heapCountStop();
+
+    // connected up to the timeout, disconnected right after it, with the
+    // payload buffer released
+    bool ok = socket.disconnects == 1 && hostMillis == WEBSOCKETS_TCP_TIMEOUT + 1 && socket.calls == 0 && heap.live == 0;
+    printf("%-24s disconnect at %lu ms, %zu byte held  %s\n", ("timeout after " + std::to_string(sent) + " byte").c_str(), hostMillis, heap.live,
+        ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+int main() {
+    const size_t events = 20000;
+    Session session     = recordSession(events);
+
+    const Arrival arrivals[] = {
+        { "1460 byte segments", 1460, 0 },
+        { "1 byte reads", 1, 0 },
+        { "trickle, 7 byte reads", 7, 5 },
+    };
+
+    printf("receive mode: %s, RX buffer %d byte, %zu events, %zu frames (%zu bigger than the buffer), %zu byte\n",
+        WEBSOCKETS_RX_BUFFER_SIZE == 0 ? "heap" : (WEBSOCKETS_RX_STREAM ? "stream" : "buffer"),
+        WEBSOCKETS_RX_BUFFER_SIZE, events, session.frames, session.bigFrames, session.stream.size());
+    printf("%-24s %9s %11s %11s %10s %10s  %s\n", "arrival", "messages", "callbacks", "mallocs", "per frame", "peak heap", "result");
+
+    int failures = 0;
+    for(const Arrival & arrival : arrivals) {
+        HostSocket socket(false, session.messages.size());
+        socket.tcp.rx          = session.stream;
+        socket.tcp.readSegment = arrival.readSegment;
+        socket.tcp.rxPerMs     = arrival.rxPerMs;
+        hostMillis             = 0;
+
+        heapCountStart();
+        while(socket.client.status == WSC_CONNECTED && (socket.tcp.rxPos < socket.tcp.rx.size() || socket.client.cWsRxOut)) {
+            socket.loopOnce();
+            hostMillis++;
+        }
+        HeapStats heap = heapCountStop();
+
+        // a malloc() per frame that doesn't fit the buffer, none when streaming
+        size_t expectedAllocations = WEBSOCKETS_RX_STREAM ? 0 : session.bigFrames;
+
+        bool ok = heap.allocations == expectedAllocations && socket.disconnects == 0 && socket.controls == session.controls && socket.delivered == session.messages && socket.messageEnds == session.messageEnds;
+        if(!ok) {
+            failures++;
+        }
+        printf("%-24s %9zu %11zu %11zu %10.2f %10zu  %s\n", arrival.name, socket.messageEnds.size(), socket.calls, heap.allocations,
+            (double)heap.allocations / session.frames, heap.peak, ok ? "ok" : "MISMATCH");
+    }
+
+    // inside the 8 byte header, right after it, and inside the payload
+    const size_t stalls[] = { 1, 8, 60 };
+    for(size_t sent : stalls) {
+        if(!stallCase(sent)) {
+            failures++;
+        }
+        if(!timeoutCase(sent)) {
+            failures++;
+        }
+    }
+    return failures ? 1 : 0;
+}
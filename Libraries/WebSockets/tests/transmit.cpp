@@ -0,0 +1,99 @@
+/**
+ * @file transmit.cpp
+ * writes and TCP segments per message for bursts of small frames sent from
+ * one loop(), checks the peer receives them as sent, and that a failed write
+ * of queued frames is reported
+ *
+ * built once per transmit mode (see CMakeLists.txt):
+ *   direct: WEBSOCKETS_TX_BUFFER_SIZE 0, header and payload written per frame
+ *   buffer: frames are queued and written once per loop() by sendFlush()
+ */
+
+#include "Harness.h"
+
+#include <random>
+
+// a client sends masked bursts: pongs, subscriptions, acks, now and then a
+// bigger message; one burst per loop()
+static int measure() {
+    std::mt19937 rng(2);
+    HostSocket sender(true, 1 << 20);
+    HostSocket receiver(false, 1 << 20);
+
+    std::vector<uint8_t> expected;
+    std::vector<size_t> expectedEnds;
+    expected.reserve(1 << 20);
+    expectedEnds.reserve(1 << 14);
+    size_t messages = 0, pings = 0;
+    uint8_t payload[1000], copy[1000];
+
+    heapCountStart();
+    for(int loop = 0; loop < 2000; loop++) {
+        for(size_t k = 1 + rng() % 6; k > 0; k--) {
+            bool ping  = rng() % 4 == 0;
+            size_t len = ping ? 4 + rng() % 100 : ((rng() % 50 == 0) ? 1000 : 10 + rng() % 150);
+            for(size_t i = 0; i < len; i++) {
+                payload[i] = (uint8_t)('a' + rng() % 26);
+            }
+            // sendFrame() may mask in place
+            memcpy(copy, payload, len);
+            if(!sender.sendFrame(&sender.client, ping ? WSop_ping : WSop_text, copy, len)) {
+                printf("sendFrame failed\n");
+                return 1;
+            }
+            messages++;
+            if(ping) {
+                pings++;
+            } else {
+                expected.insert(expected.end(), payload, payload + len);
+                expectedEnds.push_back(expected.size());
+            }
+        }
+        sender.sendFlush(&sender.client);
+    }
+    HeapStats heap = heapCountStop();
+
+    receiver.tcp.rx = sender.tcp.tx;
+    while(receiver.client.status == WSC_CONNECTED && receiver.tcp.available() > 0) {
+        receiver.loopOnce();
+    }
+
+    bool ok = receiver.delivered == expected && receiver.messageEnds == expectedEnds && receiver.controls == pings && sender.disconnects == 0;
+    printf("transmit mode: %s, TX buffer %d byte, %zu messages in 2000 loops, %zu byte\n", WEBSOCKETS_TX_BUFFER_SIZE ? "buffer" : "direct",
+        WEBSOCKETS_TX_BUFFER_SIZE, messages, sender.tcp.tx.size());
+    printf("%10s %10s %10s %10s %10s %10s  %s\n", "writes", "per msg", "segments", "per msg", "mallocs", "peak heap", "received");
+    printf("%10zu %10.2f %10zu %10.2f %10zu %10zu  %s\n", sender.tcp.writes, (double)sender.tcp.writes / messages, sender.tcp.segments,
+        (double)sender.tcp.segments / messages, heap.allocations, heap.peak, ok ? "ok" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+
+// the connection breaks while frames wait in the buffer
+static int writeFailure() {
+    HostSocket socket(true);
+    socket.tcp.failWritesAt = 1;
+
+    uint8_t payload[] = "event";
+    bool sent         = socket.sendFrame(&socket.client, WSop_text, payload, 5);
+#if(WEBSOCKETS_TX_BUFFER_SIZE > 0)
+    // queued, the write happens in sendFlush() which disconnects
+    bool ok = sent && !socket.sendFlush(&socket.client);
+    ok      = ok && socket.disconnects == 1 && socket.client.status == WSC_NOT_CONNECTED;
+#else
+    // written right away, the caller sees the failure
+    bool ok = !sent;
+#endif
+    ok = ok && !socket.sendFrame(&socket.client, WSop_text, payload, 5);
+
+    // closing: the close frame is queued, its flush fails and disconnects once
+    HostSocket closing(true);
+    closing.tcp.failWritesAt = 1;
+    closing.clientDisconnect(&closing.client, 1000);
+    ok = ok && closing.disconnects == 1;
+
+    printf("failed write: %s\n", ok ? "ok" : "NOT REPORTED");
+    return ok ? 0 : 1;
+}
+
+int main() {
+    return measure() | writeFailure();
+}
@@ -12,6 +12,45 @@ const wss = new WebSocket.Server({
 });
 
 const esp32Clients = new Set();
+
+// Relay tuning, each one overridable with a positive number in the environment,
+// e.g. COALESCE_WINDOW_MS=500 CLIENT_RATE_PER_SEC=6 node server.js
+function envNumber(name, fallback) {
+    const value = Number(process.env[name]);
+    return process.env[name] && Number.isFinite(value) && value > 0 ? value : fallback;
+}
+// Likes and gifts from the same user within this window after the first are merged into one event
+const COALESCE_WINDOW_MS = envNumber('COALESCE_WINDOW_MS', 1000);
+// Token bucket per client: sustained events per second and the largest back-to-back burst
+const CLIENT_RATE_PER_SEC = envNumber('CLIENT_RATE_PER_SEC', 4);
+const CLIENT_BURST = envNumber('CLIENT_BURST', 8);
+// Chats over a client's rate wait for a token instead of being dropped, up to this many
+const CLIENT_CHAT_QUEUE = envNumber('CLIENT_CHAT_QUEUE', 16);
+// Largest frame sent to a client that did not ask for another limit, the device's
+// WEBSOCKETS_MAX_DATA_SIZE: a bigger one makes it disconnect with code 1009
+const DEFAULT_MAX_FRAME_BYTES = 15 * 1024;
+// Connection state changes always go through, whatever the client's rate or subscription
+const CONTROL_EVENTS = new Set(['connection', 'tiktok_connected', 'tiktok_disconnected', 'error']);
+
+// Relay counters, served at GET /stats
+const relayStats = { merged: 0, sent: 0, dropped: 0, oversize: 0, unencodable: 0 };
+// Coalescing windows open per key, with the events merged since the last broadcast
+const pendingEvents = new Map();
+
+// Compact binary schema: each event is a MsgPack array [typeId, username, value, count].
+// The count is only present for types that define one.
+// The ids and value fields must match EventType in tiktok_events.h, tests/compactEvents checks them.
+const COMPACT_EVENTS = {
+    connection:          { id: 0, value: 'status' },
+    tiktok_connected:    { id: 1, value: 'roomId' },
+    tiktok_disconnected: { id: 2 },
+    chat:                { id: 3, value: 'message' },
+    gift:                { id: 4, value: 'giftName', count: 'repeatCount' },
+    like:                { id: 5, value: 'likeCount' },
+    follow:              { id: 6 },
+    viewers:             { id: 7, value: 'count' },
+    error:               { id: 8, value: 'message' }
+};
 const tiktokUsername = 'uradatiktok'; // Replace with actual username
 
 const tiktokConnection = new TikTokLiveConnection(tiktokUsername, {
@@ -36,36 +75,267 @@ const pingInterval = setInterval(() => {
 
 server.on('close', () => clearInterval(pingInterval));
 
-wss.on('connection', (ws) => {
+wss.on('connection', (ws, req) => {
     ws.isAlive = true;
+    // Clients opt into compact binary events with ?format=msgpack, others get JSON text
+    const query = new URL(req.url, 'http://localhost').searchParams;
+    ws.format = query.get('format') === 'msgpack' ? 'msgpack' : 'json';
+    ws.tokens = CLIENT_BURST;
+    ws.lastRefill = Date.now();
+    ws.chatQueue = [];
+    ws.chatTimer = null;
     esp32Clients.add(ws);
     
-    ws.send(JSON.stringify({
+    const welcome = encodeForClient(ws, projectEvent(ws, {
         type: 'connection',
         status: 'connected',
         timestamp: Date.now()
-    }));
+    }), {});
+    if (welcome !== null) ws.send(welcome);
+    
+    ws.on('message', (message, isBinary) => {
+        // A malformed message must never take the relay down
+        try {
+            if (!isBinary) handleClientMessage(ws, message.toString());
+        } catch (e) {}
+    });
     
     ws.on('pong', () => ws.isAlive = true);
     
-    ws.on('close', () => esp32Clients.delete(ws));
+    ws.on('close', () => removeClient(ws));
     
-    ws.on('error', (error) => esp32Clients.delete(ws));
+    ws.on('error', (error) => removeClient(ws));
 });
 
+// Minimal MsgPack encoder covering the types used by the compact schema
+function encodeMsgPack(value) {
+    const chunks = [];
+    const write = (bytes) => chunks.push(Buffer.from(bytes));
+    const encode = (v) => {
+        if (v === null || v === undefined) {
+            write([0xc0]);
+        } else if (typeof v === 'boolean') {
+            write([v ? 0xc3 : 0xc2]);
+        } else if (typeof v === 'number' && Number.isInteger(v) && Math.abs(v) <= 0xffffffff) {
+            if (v >= 0 && v < 0x80) write([v]);
+            else if (v < 0 && v >= -32) write([v & 0xff]);
+            else {
+                const b = Buffer.alloc(5);
+                if (v >= 0) { b[0] = 0xce; b.writeUInt32BE(v, 1); }
+                else if (v >= -0x80000000) { b[0] = 0xd2; b.writeInt32BE(v, 1); }
+                else return encode(String(v));
+                chunks.push(b);
+            }
+        } else if (typeof v === 'number') {
+            const b = Buffer.alloc(9);
+            b[0] = 0xcb;
+            b.writeDoubleBE(v, 1);
+            chunks.push(b);
+        } else if (Array.isArray(v)) {
+            if (v.length < 16) write([0x90 | v.length]);
+            else { const b = Buffer.alloc(3); b[0] = 0xdc; b.writeUInt16BE(v.length, 1); chunks.push(b); }
+            v.forEach(encode);
+        } else {
+            const str = Buffer.from(String(v), 'utf8');
+            if (str.length < 32) write([0xa0 | str.length]);
+            else if (str.length < 0x100) write([0xd9, str.length]);
+            else if (str.length < 0x10000) { const b = Buffer.alloc(3); b[0] = 0xda; b.writeUInt16BE(str.length, 1); chunks.push(b); }
+            else { const b = Buffer.alloc(5); b[0] = 0xdb; b.writeUInt32BE(str.length, 1); chunks.push(b); }
+            chunks.push(str);
+        }
+    };
+    encode(value);
+    return Buffer.concat(chunks);
+}
+
+// Returns the MsgPack frame for an event, or null if the compact schema has no id for it
+function toCompactEvent(data) {
+    const schema = COMPACT_EVENTS[data.type];
+    if (!schema) return null;
+    const event = [schema.id, data.username];
+    if (schema.value) event.push(data[schema.value]);
+    if (schema.count) event.push(data[schema.count]);
+    return encodeMsgPack(event);
+}
+
+// A client may replace the default "everything" feed with a subscription:
+//   {"type": "subscribe", "events": {"chat": ["username", "message"], "member": ["data.user.uniqueId"]},
+//    "maxFrameBytes": 15360}
+// Each event type maps to the fields to forward (dotted paths reach into nested data,
+// an empty list forwards the whole event). Control events are always delivered.
+// A client that has not subscribed gets every event, raw payloads included, so that
+// clients that never subscribe keep working. Its frames are still capped at
+// DEFAULT_MAX_FRAME_BYTES, so the window between connect and subscribe can't overflow the device.
+function handleClientMessage(ws, text) {
+    let message;
+    try {
+        message = JSON.parse(text);
+    } catch (e) {
+        return;
+    }
+    if (!message || message.type !== 'subscribe') return;
+    const requested = message.events;
+    if (!requested || typeof requested !== 'object' || Array.isArray(requested)) return;
+
+    const events = new Map();
+    Object.entries(requested).forEach(([type, fields]) => {
+        const list = Array.isArray(fields) ? fields.filter(f => typeof f === 'string') : [];
+        events.set(type, { fields: list, key: list.join(',') });
+    });
+    ws.subscription = {
+        events,
+        maxFrameBytes: Number.isInteger(message.maxFrameBytes) ? message.maxFrameBytes : DEFAULT_MAX_FRAME_BYTES
+    };
+}
+
+// Returns the event as this client should see it, or null if it is not subscribed.
+// The key identifies the projection so clients sharing one also share the encoding.
+function projectEvent(client, data) {
+    if (!client.subscription || CONTROL_EVENTS.has(data.type)) return { key: '*', event: data };
+    const subscribed = client.subscription.events.get(data.type);
+    if (!subscribed) return null;
+    if (subscribed.fields.length === 0) return { key: '*', event: data };
+
+    const event = { type: data.type };
+    subscribed.fields.forEach(path => {
+        const value = path.split('.').reduce((obj, key) => (obj == null ? undefined : obj[key]), data);
+        if (value !== undefined) event[path] = value;
+    });
+    return { key: subscribed.key, event };
+}
+
+// Returns the frame for this client, or null if its format has no encoding for the
+// event, the event can't be encoded or the frame is over its size limit.
+// Each format and projection is encoded at most once per event, however many clients receive it
+function encodeForClient(client, view, encoded) {
+    const cacheKey = `${client.format}:${view.key}`;
+    if (encoded[cacheKey] === undefined) {
+        // A payload that can't be serialized (cycles, BigInt...) skips the event, not the client
+        try {
+            encoded[cacheKey] = client.format === 'msgpack' ? toCompactEvent(view.event) : JSON.stringify(view.event);
+        } catch (e) {
+            encoded[cacheKey] = null;
+            relayStats.unencodable++;
+        }
+    }
+    const message = encoded[cacheKey];
+    if (message === null) return null;
+    const maxFrameBytes = client.subscription ? client.subscription.maxFrameBytes : DEFAULT_MAX_FRAME_BYTES;
+    if (Buffer.byteLength(message) > maxFrameBytes) {
+        relayStats.oversize++;
+        return null;
+    }
+    return message;
+}
+
+// Refills the client's bucket for the time elapsed and takes one token if available
+function takeToken(client) {
+    const now = Date.now();
+    client.tokens = Math.min(CLIENT_BURST, client.tokens + (now - client.lastRefill) * CLIENT_RATE_PER_SEC / 1000);
+    client.lastRefill = now;
+    if (client.tokens < 1) return false;
+    client.tokens -= 1;
+    return true;
+}
+
+function removeClient(client) {
+    esp32Clients.delete(client);
+    clearTimeout(client.chatTimer);
+    client.chatQueue = [];
+}
+
+function sendToClient(client, message) {
+    // Only a failed send means the client is gone
+    try {
+        client.send(message);
+        relayStats.sent++;
+    } catch (error) {
+        removeClient(client);
+    }
+}
+
+// Queues a chat over the client's rate, the oldest one is dropped when the queue is full
+function queueChat(client, message) {
+    if (client.chatQueue.length >= CLIENT_CHAT_QUEUE) {
+        client.chatQueue.shift();
+        relayStats.dropped++;
+    }
+    client.chatQueue.push(message);
+    scheduleChatQueue(client);
+}
+
+// Sends the queued chats, in order, as the client's bucket refills
+function scheduleChatQueue(client) {
+    if (client.chatTimer || client.chatQueue.length === 0) return;
+    const wait = Math.max(0, (1 - client.tokens) * 1000 / CLIENT_RATE_PER_SEC);
+    client.chatTimer = setTimeout(() => {
+        client.chatTimer = null;
+        while (client.chatQueue.length > 0 && client.readyState === WebSocket.OPEN && takeToken(client)) {
+            sendToClient(client, client.chatQueue.shift());
+        }
+        scheduleChatQueue(client);
+    }, Math.ceil(wait));
+}
+
 function broadcastToESP32(data) {
-    const message = JSON.stringify(data);
+    const encoded = {};
     esp32Clients.forEach(client => {
-        try {
-            if (client.readyState === WebSocket.OPEN) {
-                client.send(message);
-            }
-        } catch (error) {
-            esp32Clients.delete(client);
+        if (client.readyState !== WebSocket.OPEN) return;
+        const view = projectEvent(client, data);
+        if (!view) return;
+        // Only a frame that is actually sent costs a token
+        const message = encodeForClient(client, view, encoded);
+        if (message === null) return;
+        if (CONTROL_EVENTS.has(data.type)) {
+            sendToClient(client, message);
+        } else if (data.type === 'chat') {
+            // Behind the chats already waiting, so they stay in order
+            if (client.chatQueue.length === 0 && takeToken(client)) sendToClient(client, message);
+            else queueChat(client, message);
+        } else if (client.chatQueue.length === 0 && takeToken(client)) {
+            // Waiting chats get the tokens first
+            sendToClient(client, message);
+        } else {
+            relayStats.dropped++;
         }
     });
 }
 
+// Broadcasts the first event for a key at once and opens a coalescing window.
+// Later events for the key are folded into the first of them with
+// merge(pending, data), and only that aggregate is broadcast when the window
+// closes; then a new window opens. A window in which nothing arrived sends
+// nothing and ends the coalescing of the key.
+function coalesceToESP32(key, data, merge) {
+    const current = pendingEvents.get(key);
+    if (current) {
+        if (current.pending) {
+            merge(current.pending, data);
+            relayStats.merged++;
+        } else {
+            current.pending = data;
+        }
+        return;
+    }
+    broadcastToESP32(data);
+    const opened = { pending: null };
+    pendingEvents.set(key, opened);
+    const close = () => {
+        if (!opened.pending) {
+            pendingEvents.delete(key);
+            return;
+        }
+        broadcastToESP32(opened.pending);
+        opened.pending = null;
+        setTimeout(close, COALESCE_WINDOW_MS);
+    };
+    setTimeout(close, COALESCE_WINDOW_MS);
+}
+
+app.get('/stats', (req, res) => {
+    res.json({ ...relayStats, pending: pendingEvents.size, clients: esp32Clients.size });
+});
+
 let reconnectAttempts = 0;
 const maxReconnectAttempts = 15; // Increased max attempts
 let reconnectTimeout;
@@ -107,20 +377,29 @@ allEvents.forEach(eventName => {
             });
         }
         else if (eventName === WebcastEvent.GIFT) {
-            broadcastToESP32({
+            // Streakable gifts report a running total, other gifts count once per event
+            const streakable = data.giftDetails && data.giftDetails.giftType === 1;
+            coalesceToESP32(`gift:${data.user.uniqueId}:${data.giftId}`, {
                 type: 'gift',
                 username: data.user.uniqueId,
                 giftName: data.giftName || `Gift ${data.giftId}`,
                 giftId: data.giftId,
+                repeatCount: data.repeatCount || 1,
                 timestamp: Date.now()
+            }, (pending, gift) => {
+                pending.repeatCount = streakable
+                    ? Math.max(pending.repeatCount, gift.repeatCount)
+                    : pending.repeatCount + gift.repeatCount;
             });
         }
         else if (eventName === WebcastEvent.LIKE) {
-            broadcastToESP32({
+            coalesceToESP32(`like:${data.user.uniqueId}`, {
                 type: 'like',
                 username: data.user.uniqueId,
-                likeCount: data.likeCount,
+                likeCount: data.likeCount || 1,
                 timestamp: Date.now()
+            }, (pending, like) => {
+                pending.likeCount += like.likeCount;
             });
         }
         else if (eventName === WebcastEvent.FOLLOW) {
@@ -131,14 +410,18 @@ allEvents.forEach(eventName => {
             });
         }
         else if (eventName === WebcastEvent.ROOMUSER) {
-            broadcastToESP32({
+            // Only the latest viewer count in a window matters
+            coalesceToESP32('viewers', {
                 type: 'viewers',
                 count: data.viewerCount,
                 timestamp: Date.now()
+            }, (pending, viewers) => {
+                pending.count = viewers.count;
             });
         }
         else {
-            // Broadcast any other events with generic format
+            // Broadcast any other events with generic format, only clients that
+            // subscribed to them (or never subscribed) receive the raw payload
             try {
                 broadcastToESP32({
                     type: eventName.toLowerCase(),
@@ -0,0 +1,90 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// Delta-encoded 1-bpp animation, built on the PC by tools/encode_intro.cpp.
+// Each frame only stores the pixels that changed since the previous one
+// (the first frame is compared against a black screen).
+//
+// All numbers after the header are LEB128 varints:
+//   header: 'D' 'A' version width(u16 LE) height(u16 LE) frames(u16 LE)
+//   frame:  rowCount, then per row:
+//             yStep   rows since the previous changed row (first row: y)
+//             runCount, then per run:
+//               xGap   pixels since the end of the previous run (first run: x)
+//               len << 1 | color   color 1 = foreground, 0 = background
+const uint8_t ANIMATION_VERSION = 1;
+const int ANIMATION_HEADER_SIZE = 9;
+
+struct AnimationPlayer {
+  const uint8_t* data = nullptr;
+  const uint8_t* pos = nullptr;
+  uint16_t width = 0;
+  uint16_t height = 0;
+  uint16_t frames = 0;
+  uint16_t frame = 0;
+  uint32_t runs = 0; // Runs drawn for the last frame
+};
+
+// Function declarations
+bool beginAnimation(AnimationPlayer& player, const uint8_t* data);
+bool drawAnimationFrame(AnimationPlayer& player, TFT_eSPI& gfx, int x, int y, uint16_t fgColor, uint16_t bgColor);
+
+uint32_t readAnimationVarint(const uint8_t*& pos) {
+  uint32_t value = 0;
+  uint8_t shift = 0;
+  uint8_t b;
+  do {
+    b = pgm_read_byte(pos++);
+    value |= (uint32_t)(b & 0x7F) << shift;
+    shift += 7;
+  } while (b & 0x80);
+  return value;
+}
+
+bool beginAnimation(AnimationPlayer& player, const uint8_t* data) {
+  if (pgm_read_byte(data) != 'D' || pgm_read_byte(data + 1) != 'A' || pgm_read_byte(data + 2) != ANIMATION_VERSION) {
+    Serial.println("Animation: unknown format");
+    player.frames = 0;
+    return false;
+  }
+
+  player.data = data;
+  player.pos = data + ANIMATION_HEADER_SIZE;
+  player.width = pgm_read_byte(data + 3) | pgm_read_byte(data + 4) << 8;
+  player.height = pgm_read_byte(data + 5) | pgm_read_byte(data + 6) << 8;
+  player.frames = pgm_read_byte(data + 7) | pgm_read_byte(data + 8) << 8;
+  player.frame = 0;
+  return true;
+}
+
+// Applies the next frame's changes at x,y. Returns false once every frame has been drawn.
+bool drawAnimationFrame(AnimationPlayer& player, TFT_eSPI& gfx, int x, int y, uint16_t fgColor, uint16_t bgColor) {
+  if (player.frame >= player.frames) return false;
+
+  gfx.startWrite(); // One transaction for all runs of the frame
+  player.runs = 0;
+  uint32_t rowCount = readAnimationVarint(player.pos);
+  int row = 0;
+  for (uint32_t r = 0; r < rowCount; r++) {
+    row += readAnimationVarint(player.pos);
+    uint32_t runCount = readAnimationVarint(player.pos);
+    int col = 0;
+    for (uint32_t i = 0; i < runCount; i++) {
+      col += readAnimationVarint(player.pos);
+      uint32_t run = readAnimationVarint(player.pos);
+      int len = run >> 1;
+      gfx.drawFastHLine(x + col, y + row, len, (run & 1) ? fgColor : bgColor);
+      col += len;
+    }
+    player.runs += runCount;
+  }
+  gfx.endWrite();
+
+  player.frame++;
+  return true;
+}
+
+#endif
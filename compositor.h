@@ -0,0 +1,217 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// External TFT reference
+extern TFT_eSPI tft;
+
+// Set to 1 to render each screen band into its own off-screen sprite and
+// flush only the bands that changed with DMA at the end of every loop()
+#ifndef USE_COMPOSITOR
+#define USE_COMPOSITOR 0
+#endif
+
+// Set to 1 to print a frame-time histogram over Serial (on by default with the compositor)
+#ifndef FRAME_STATS
+#define FRAME_STATS USE_COMPOSITOR
+#endif
+
+// Screen bands, top to bottom. Each one is owned by a single module.
+enum Layer {
+  LAYER_KAOMOJI,
+  LAYER_TIME,
+  LAYER_TIKTOK,
+  LAYER_COUNT
+};
+
+// Function declarations
+void compositorAddLayer(Layer layer, int y, int h);
+void initializeCompositor();
+TFT_eSPI& beginLayer(Layer layer);
+void compositorMarkDirty(Layer layer, int x, int y, int w, int h);
+void compositorFlush();
+
+#if USE_COMPOSITOR
+// Layers are full-width bands so text wrapping behaves exactly as on the TFT.
+// Drawing uses screen coordinates; the sprite origin is shifted to the band.
+struct CompositorLayer {
+  TFT_eSprite sprite = TFT_eSprite(&tft);
+  int y = 0;
+  int h = 0;
+  bool ready = false; // Sprite allocated, otherwise the layer draws straight to the TFT
+  // Screen rectangle drawn since the last flush, empty while x0 >= x1
+  int dirtyX0 = 0;
+  int dirtyY0 = 0;
+  int dirtyX1 = 0;
+  int dirtyY1 = 0;
+};
+
+CompositorLayer layers[LAYER_COUNT];
+int dmaLayer = -1; // Layer whose buffer the DMA engine may still be reading
+bool flushWriting = false; // The TFT is selected for the transfers of the last flush
+
+// A dirty rectangle narrower than its band is not contiguous in the sprite.
+// Up to this many pixels it is pushed at once through a clip window, larger
+// ones go out as whole band rows with DMA so the CPU stays free.
+const int32_t compositorDirectPixels = 4096;
+#endif
+
+#if FRAME_STATS
+// Frame time buckets in milliseconds, the last bucket collects everything slower
+const uint16_t frameBuckets[] = {10, 16, 20, 33, 50, 100};
+const int frameBucketCount = sizeof(frameBuckets) / sizeof(frameBuckets[0]) + 1;
+uint32_t frameHistogram[frameBucketCount];
+uint32_t frameMaxMicros = 0;
+unsigned long lastFrameMicros = 0;
+unsigned long lastFrameReport = 0;
+const unsigned long frameReportInterval = 10000; // Report every 10 seconds
+#endif
+
+void compositorAddLayer(Layer layer, int y, int h) {
+#if USE_COMPOSITOR
+  layers[layer].y = y;
+  layers[layer].h = h;
+#endif
+}
+
+void initializeCompositor() {
+#if USE_COMPOSITOR
+  tft.initDMA();
+
+  for (int i = 0; i < LAYER_COUNT; i++) {
+    CompositorLayer& layer = layers[i];
+    layer.sprite.setColorDepth(16);
+    if (layer.h > 0 && layer.sprite.createSprite(tft.width(), layer.h)) {
+      layer.sprite.fillSprite(TFT_BLACK);
+      layer.sprite.setOrigin(0, -layer.y);
+      layer.ready = true;
+      compositorMarkDirty((Layer)i, 0, layer.y, tft.width(), layer.h);
+    } else {
+      Serial.printf("Compositor: no memory for layer %d, drawing directly\n", i);
+    }
+  }
+#endif
+}
+
+#if USE_COMPOSITOR
+// Ends the SPI write of the last flush once its transfers are done, or after
+// waiting for them with wait set
+void compositorEndWrite(bool wait) {
+  if (!flushWriting || (!wait && tft.dmaBusy())) return;
+  tft.dmaWait();
+  tft.endWrite();
+  flushWriting = false;
+  dmaLayer = -1;
+}
+#endif
+
+// Returns the surface a module should draw into for this band. Waits only if
+// the band is still being transferred, or to draw straight to the TFT. What
+// was drawn must be passed to compositorMarkDirty() to reach the screen.
+TFT_eSPI& beginLayer(Layer layer) {
+#if USE_COMPOSITOR
+  CompositorLayer& l = layers[layer];
+  compositorEndWrite(dmaLayer == layer || !l.ready);
+  if (l.ready) return l.sprite;
+#endif
+  return tft;
+}
+
+// Adds a rectangle drawn into the band, in screen coordinates, to what the
+// next flush pushes
+void compositorMarkDirty(Layer layer, int x, int y, int w, int h) {
+#if USE_COMPOSITOR
+  CompositorLayer& l = layers[layer];
+  int x0 = max(x, 0);
+  int y0 = max(y, l.y);
+  int x1 = min(x + w, (int)tft.width());
+  int y1 = min(y + h, l.y + l.h);
+  if (!l.ready || x0 >= x1 || y0 >= y1) return;
+
+  if (l.dirtyX0 < l.dirtyX1) {
+    x0 = min(x0, l.dirtyX0);
+    y0 = min(y0, l.dirtyY0);
+    x1 = max(x1, l.dirtyX1);
+    y1 = max(y1, l.dirtyY1);
+  }
+  l.dirtyX0 = x0;
+  l.dirtyY0 = y0;
+  l.dirtyX1 = x1;
+  l.dirtyY1 = y1;
+#endif
+}
+
+void compositorFlush() {
+#if USE_COMPOSITOR
+  compositorEndWrite(false);
+
+  // Small rectangles first: the CPU pushes them, and can't share the bus with
+  // a running transfer
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < LAYER_COUNT; i++) {
+      CompositorLayer& layer = layers[i];
+      if (!layer.ready || layer.dirtyX0 >= layer.dirtyX1) continue;
+
+      int32_t width = layer.sprite.width();
+      int32_t w = layer.dirtyX1 - layer.dirtyX0;
+      int32_t h = layer.dirtyY1 - layer.dirtyY0;
+      bool direct = w < width && w * h <= compositorDirectPixels;
+      if (direct != (pass == 0)) continue;
+
+      if (!flushWriting) {
+        tft.startWrite();
+        flushWriting = true;
+      }
+
+      // Sprite pixels are already byte swapped for the panel
+      uint16_t* pixels = (uint16_t*)layer.sprite.getPointer();
+      if (direct) {
+        if (dmaLayer >= 0) {
+          tft.dmaWait();
+          dmaLayer = -1;
+        }
+        tft.setViewport(layer.dirtyX0, layer.dirtyY0, w, h, false);
+        tft.pushImage(0, layer.y, width, layer.h, pixels);
+        tft.resetViewport();
+      } else {
+        // pushImageDMA waits for the previous transfer, then returns while
+        // these rows stream out
+        tft.pushImageDMA(0, layer.dirtyY0, width, h, pixels + (layer.dirtyY0 - layer.y) * width);
+        dmaLayer = i;
+      }
+      layer.dirtyX0 = layer.dirtyX1 = 0;
+    }
+  }
+
+  // Nothing in flight, so the TFT is released now
+  if (dmaLayer < 0) compositorEndWrite(true);
+#endif
+
+#if FRAME_STATS
+  unsigned long now = micros();
+  if (lastFrameMicros != 0) {
+    uint32_t frameMicros = now - lastFrameMicros;
+    int bucket = 0;
+    while (bucket < frameBucketCount - 1 && frameMicros >= frameBuckets[bucket] * 1000UL) bucket++;
+    frameHistogram[bucket]++;
+    if (frameMicros > frameMaxMicros) frameMaxMicros = frameMicros;
+  }
+  lastFrameMicros = now;
+
+  if (millis() - lastFrameReport >= frameReportInterval) {
+    Serial.print("Frame ms:");
+    for (int i = 0; i < frameBucketCount; i++) {
+      if (i < frameBucketCount - 1) Serial.printf(" <%u:%lu", frameBuckets[i], (unsigned long)frameHistogram[i]);
+      else Serial.printf(" >=%u:%lu", frameBuckets[i - 1], (unsigned long)frameHistogram[i]);
+      frameHistogram[i] = 0;
+    }
+    Serial.printf(" max:%.1f\n", frameMaxMicros / 1000.0);
+    frameMaxMicros = 0;
+    lastFrameReport = millis();
+  }
+#endif
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef GLYPHS_H
+#define GLYPHS_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// Built-in GLCD font cells are 6x8 pixels before scaling
+const int GLYPH_CELL_W = 6;
+const int GLYPH_CELL_H = 8;
+
+// What one character cell of a fixed-position text line currently shows
+struct GlyphCell {
+  uint16_t c = 0; // 0 = unknown, always redrawn
+  uint8_t size = 0;
+  uint16_t fg = 0;
+  uint16_t bg = 0;
+};
+
+// Function declarations
+void resetGlyphLine(GlyphCell* cells, int cellCount);
+int drawGlyphLine(TFT_eSPI& gfx, GlyphCell* cells, int cellCount, int x, int y, const char* text, uint8_t size, uint16_t fgColor, uint16_t bgColor);
+
+// Forget what is on screen, e.g. after the caller cleared the area
+void resetGlyphLine(GlyphCell* cells, int cellCount) {
+  for (int i = 0; i < cellCount; i++) cells[i] = GlyphCell();
+}
+
+// Draws text with the GLCD font, one cell per character, skipping cells that
+// already show the same character at the same size and colours. Each glyph is
+// drawn over its own background (bgColor must differ from fgColor), so nothing
+// has to be cleared first. Returns the number of glyphs drawn.
+int drawGlyphLine(TFT_eSPI& gfx, GlyphCell* cells, int cellCount, int x, int y, const char* text, uint8_t size, uint16_t fgColor, uint16_t bgColor) {
+  int drawn = 0;
+  for (int i = 0; i < cellCount && text[i]; i++) {
+    GlyphCell& cell = cells[i];
+    uint8_t c = text[i];
+    if (cell.c == c && cell.size == size && cell.fg == fgColor && cell.bg == bgColor) continue;
+
+    gfx.drawChar(x + i * GLYPH_CELL_W * size, y, c, fgColor, bgColor, size);
+    cell.c = c;
+    cell.size = size;
+    cell.fg = fgColor;
+    cell.bg = bgColor;
+    drawn++;
+  }
+  return drawn;
+}
+
+#endif
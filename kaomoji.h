@@ -3,10 +3,18 @@
 
 #include <Arduino.h>
 #include <TFT_eSPI.h>
+#include "compositor.h"
+#include "glyphs.h"
 
 // External TFT reference
 extern TFT_eSPI tft;
 
+// Set to 1 to wipe from one face to the next and blink now and then.
+// The glyph atlas makes each animation frame a small partial push.
+#ifndef KAOMOJI_ANIMATE
+#define KAOMOJI_ANIMATE 0
+#endif
+
 // Arrays of simple ASCII kaomoji parts
 const char* leftSides[] = {"(", "(", "(", "(", "("};
 const char* rightSides[] = {")", ")", ")", ")", ")"};
@@ -22,48 +30,241 @@ const int mouthSize = sizeof(mouths) / sizeof(mouths[0]);
 // Display position for kaomoji
 const int KAOMOJI_Y = 15;
 
+// Faces are drawn at text size 6 into a full-width 1-bpp line buffer
+const int KAOMOJI_SIZE = 6;
+const int KAOMOJI_CELL_W = GLYPH_CELL_W * KAOMOJI_SIZE;
+const int KAOMOJI_CELL_H = GLYPH_CELL_H * KAOMOJI_SIZE;
+const int KAOMOJI_MAX_CHARS = 8;
+const int KAOMOJI_ROW_BYTES = 240 / 8;
+const int KAOMOJI_FACE_BYTES = KAOMOJI_ROW_BYTES * KAOMOJI_CELL_H;
+
 // Previous kaomoji to avoid unnecessary redrawing
-String prevKaomoji = "";
+char prevKaomoji[KAOMOJI_MAX_CHARS + 1] = "";
+// Glyphs on screen when there is no memory for the atlas
+GlyphCell kaomojiCells[KAOMOJI_MAX_CHARS];
+
+// Every distinct part character rasterized once, one 36x48 cell below the other
+TFT_eSprite kaomojiAtlas = TFT_eSprite(&tft);
+char atlasChars[32];
+int atlasCount = 0;
+bool atlasReady = false;
+const int ATLAS_CELL_BYTES = (KAOMOJI_CELL_W + 7) / 8 * KAOMOJI_CELL_H;
+
+// What the screen shows and what it should show. Only the rectangle where
+// they differ is pushed, so a new face costs about the glyphs that changed.
+uint8_t faceShown[KAOMOJI_FACE_BYTES];
+uint8_t faceTarget[KAOMOJI_FACE_BYTES];
+uint8_t facePatch[KAOMOJI_FACE_BYTES]; // Changed rectangle packed for drawBitmap
 
 // Time of last kaomoji change
 unsigned long lastKaomojiChange = 0;
 const unsigned long kaomojiChangeInterval = 5000; // Change every 5 seconds
 
-String generateFace() {
-  String face = "";
-  face += leftSides[random(leftSize)];
-  String eye = eyes[random(eyeSize)];
-  face += eye + mouths[random(mouthSize)] + eye;
-  face += rightSides[random(rightSize)];
-  return face;
+#if KAOMOJI_ANIMATE
+const unsigned long kaomojiFrameInterval = 20; // Wipe and blink frame time
+const int kaomojiWipeRows = 6; // Rows revealed per wipe frame, a full wipe takes 8 frames
+const unsigned long blinkDuration = 150;
+unsigned long lastKaomojiFrame = 0;
+// Times are compared as millis() - start, which stays right when millis() wraps
+unsigned long blinkStart = 0; // Start of the wait for the next blink, or of the blink
+unsigned long blinkWait = 0; // Time from blinkStart to the next blink
+bool blinking = false;
+#endif
+
+// Function declarations
+void initializeKaomoji();
+void displayKaomoji();
+void buildFace(char* face, const char* left, const char* eye, const char* mouth, const char* right);
+void generateFace(char* face);
+void composeKaomoji(const char* face, uint8_t* buffer);
+bool syncKaomoji(int maxRows);
+
+// Parts of the face on screen, so a blink can rebuild it with closed eyes
+int faceLeft = 0, faceEye = 0, faceMouth = 0, faceRight = 0;
+
+void buildFace(char* face, const char* left, const char* eye, const char* mouth, const char* right) {
+  face[0] = '\0';
+  strlcat(face, left, KAOMOJI_MAX_CHARS + 1);
+  strlcat(face, eye, KAOMOJI_MAX_CHARS + 1);
+  strlcat(face, mouth, KAOMOJI_MAX_CHARS + 1);
+  strlcat(face, eye, KAOMOJI_MAX_CHARS + 1);
+  strlcat(face, right, KAOMOJI_MAX_CHARS + 1);
+}
+
+void generateFace(char* face) {
+  faceLeft = random(leftSize);
+  faceEye = random(eyeSize);
+  faceMouth = random(mouthSize);
+  faceRight = random(rightSize);
+  buildFace(face, leftSides[faceLeft], eyes[faceEye], mouths[faceMouth], rightSides[faceRight]);
+}
+
+void addAtlasChars(const char* const* parts, int count) {
+  for (int i = 0; i < count; i++) {
+    for (const char* p = parts[i]; *p; p++) {
+      if (!memchr(atlasChars, *p, atlasCount) && atlasCount < (int)sizeof(atlasChars)) {
+        atlasChars[atlasCount++] = *p;
+      }
+    }
+  }
+}
+
+// Rasterizes every part character into the atlas. Without memory for it the
+// faces are drawn glyph by glyph instead.
+void initializeKaomoji() {
+  addAtlasChars(leftSides, leftSize);
+  addAtlasChars(eyes, eyeSize);
+  addAtlasChars(mouths, mouthSize);
+  addAtlasChars(rightSides, rightSize);
+  
+  kaomojiAtlas.setColorDepth(1);
+  if (!kaomojiAtlas.createSprite(KAOMOJI_CELL_W, KAOMOJI_CELL_H * atlasCount)) {
+    Serial.println("Kaomoji: no memory for the glyph atlas, drawing glyphs directly");
+    return;
+  }
+  kaomojiAtlas.fillSprite(TFT_BLACK);
+  for (int i = 0; i < atlasCount; i++) {
+    kaomojiAtlas.drawChar(0, i * KAOMOJI_CELL_H, atlasChars[i], TFT_WHITE, TFT_BLACK, KAOMOJI_SIZE);
+  }
+  
+  // The band is cleared when the first face is shown
+  memset(faceShown, 0, sizeof(faceShown));
+  atlasReady = true;
+}
+
+// Copies the atlas cells of a face, centered, into a 240 pixel wide 1-bpp buffer
+void composeKaomoji(const char* face, uint8_t* buffer) {
+  memset(buffer, 0, KAOMOJI_FACE_BYTES);
+  const uint8_t* atlas = (const uint8_t*)kaomojiAtlas.getPointer();
+  const int cellBytes = (KAOMOJI_CELL_W + 7) / 8;
+  const uint8_t lastMask = (uint8_t)(0xFF << (cellBytes * 8 - KAOMOJI_CELL_W));
+  int len = strlen(face);
+  int left = (240 - len * KAOMOJI_CELL_W) / 2;
+  
+  for (int i = 0; i < len; i++) {
+    const char* slot = (const char*)memchr(atlasChars, face[i], atlasCount);
+    if (!slot) continue; // Only part characters are in the atlas
+    const uint8_t* cell = atlas + (slot - atlasChars) * ATLAS_CELL_BYTES;
+    int cellX = left + i * KAOMOJI_CELL_W;
+    
+    // Whole bytes when the cell starts on a byte, otherwise each byte is
+    // split over two. Bits past the cell width are masked off.
+    int shift = cellX & 7;
+    for (int y = 0; y < KAOMOJI_CELL_H; y++) {
+      const uint8_t* src = cell + y * cellBytes;
+      uint8_t* dst = buffer + y * KAOMOJI_ROW_BYTES + (cellX >> 3);
+      for (int b = 0; b < cellBytes; b++) {
+        uint8_t bits = b == cellBytes - 1 ? src[b] & lastMask : src[b];
+        if (shift == 0) {
+          dst[b] |= bits;
+          continue;
+        }
+        dst[b] |= bits >> shift;
+        uint8_t spill = bits << (8 - shift);
+        if (spill) dst[b + 1] |= spill; // Never past the row when the cell fits in it
+      }
+    }
+  }
+}
+
+// Pushes the target face rows that differ from the screen, top to bottom and at
+// most maxRows of them, as one bitmap covering the changed columns. Returns true
+// once the screen shows the target.
+bool syncKaomoji(int maxRows) {
+  int firstRow = 0;
+  while (firstRow < KAOMOJI_CELL_H &&
+         memcmp(faceShown + firstRow * KAOMOJI_ROW_BYTES, faceTarget + firstRow * KAOMOJI_ROW_BYTES, KAOMOJI_ROW_BYTES) == 0) {
+    firstRow++;
+  }
+  if (firstRow == KAOMOJI_CELL_H) return true;
+  
+  int lastRow = min(firstRow + maxRows, KAOMOJI_CELL_H);
+  int firstByte = KAOMOJI_ROW_BYTES;
+  int lastByte = 0;
+  for (int y = firstRow; y < lastRow; y++) {
+    for (int b = 0; b < KAOMOJI_ROW_BYTES; b++) {
+      int i = y * KAOMOJI_ROW_BYTES + b;
+      if (faceShown[i] != faceTarget[i]) {
+        firstByte = min(firstByte, b);
+        lastByte = max(lastByte, b + 1);
+      }
+    }
+  }
+  
+  // Pack the changed rectangle so drawBitmap can send it in one window
+  int patchBytes = lastByte - firstByte;
+  int rows = lastRow - firstRow;
+  for (int y = 0; y < rows; y++) {
+    int i = (firstRow + y) * KAOMOJI_ROW_BYTES + firstByte;
+    memcpy(facePatch + y * patchBytes, faceTarget + i, patchBytes);
+    memcpy(faceShown + i, faceTarget + i, patchBytes);
+  }
+  beginLayer(LAYER_KAOMOJI).drawBitmap(firstByte * 8, KAOMOJI_Y + firstRow, facePatch,
+                                       patchBytes * 8, rows, TFT_YELLOW, TFT_BLACK);
+  compositorMarkDirty(LAYER_KAOMOJI, firstByte * 8, KAOMOJI_Y + firstRow, patchBytes * 8, rows);
+  
+  return memcmp(faceShown, faceTarget, KAOMOJI_FACE_BYTES) == 0;
 }
 
 void displayKaomoji() {
   unsigned long currentMillis = millis();
   
   // Only update kaomoji every 5 seconds or if it's the first time
-  if (currentMillis - lastKaomojiChange >= kaomojiChangeInterval || prevKaomoji == "") {
-    String kaomoji = generateFace();
-    
-    // Calculate positions for better centering
-    tft.setTextSize(6);
-    int kaomojiWidth = kaomoji.length() * 36; // Approximate width for size 6
-    int kaomojiX = (240 - kaomojiWidth) / 2;
-    
-    // Clear the entire kaomoji area with an even larger margin
-    // Extend the clearing area in all directions
-    tft.fillRect(0, KAOMOJI_Y - 10, 240, 55, TFT_BLACK);
+  if (currentMillis - lastKaomojiChange >= kaomojiChangeInterval || prevKaomoji[0] == '\0') {
+    char kaomoji[KAOMOJI_MAX_CHARS + 1];
+    generateFace(kaomoji);
     
-    delay(5);
+    if (prevKaomoji[0] == '\0' || (!atlasReady && strlen(kaomoji) != strlen(prevKaomoji))) {
+      TFT_eSPI& gfx = beginLayer(LAYER_KAOMOJI);
+      // Clear the entire kaomoji area with an even larger margin
+      gfx.fillRect(0, KAOMOJI_Y - 10, 240, 55, TFT_BLACK);
+      compositorMarkDirty(LAYER_KAOMOJI, 0, KAOMOJI_Y - 10, 240, 55);
+      resetGlyphLine(kaomojiCells, KAOMOJI_MAX_CHARS);
+    }
     
-    // Display new kaomoji
-    tft.setTextColor(TFT_YELLOW);
-    tft.setCursor(kaomojiX, KAOMOJI_Y);
-    tft.print(kaomoji);
+    if (atlasReady) {
+      composeKaomoji(kaomoji, faceTarget);
+#if KAOMOJI_ANIMATE
+      if (prevKaomoji[0] == '\0') syncKaomoji(KAOMOJI_CELL_H);
+      blinkStart = currentMillis;
+      blinkWait = random(1500, 4000);
+      blinking = false;
+#else
+      syncKaomoji(KAOMOJI_CELL_H);
+#endif
+    } else {
+      // Display new kaomoji, each glyph over its own background
+      int kaomojiX = (240 - (int)strlen(kaomoji) * KAOMOJI_CELL_W) / 2;
+      if (drawGlyphLine(beginLayer(LAYER_KAOMOJI), kaomojiCells, KAOMOJI_MAX_CHARS, kaomojiX, KAOMOJI_Y, kaomoji, KAOMOJI_SIZE, TFT_YELLOW, TFT_BLACK) > 0) {
+        compositorMarkDirty(LAYER_KAOMOJI, kaomojiX, KAOMOJI_Y, (int)strlen(kaomoji) * KAOMOJI_CELL_W, KAOMOJI_CELL_H);
+      }
+    }
     
-    prevKaomoji = kaomoji;
+    strlcpy(prevKaomoji, kaomoji, sizeof(prevKaomoji));
     lastKaomojiChange = currentMillis;
   }
+
+#if KAOMOJI_ANIMATE
+  if (!atlasReady || currentMillis - lastKaomojiFrame < kaomojiFrameInterval) return;
+  lastKaomojiFrame = currentMillis;
+  
+  // Blink: swap the eyes for closed ones, then back to the face
+  if (!blinking && currentMillis - blinkStart >= blinkWait) {
+    char closed[KAOMOJI_MAX_CHARS + 1];
+    buildFace(closed, leftSides[faceLeft], "-", mouths[faceMouth], rightSides[faceRight]);
+    composeKaomoji(closed, faceTarget);
+    blinkStart = currentMillis;
+    blinking = true;
+  } else if (blinking && currentMillis - blinkStart >= blinkDuration) {
+    composeKaomoji(prevKaomoji, faceTarget);
+    blinkStart = currentMillis;
+    blinkWait = random(2000, 6000);
+    blinking = false;
+  }
+  
+  // Reveal the target a few rows per frame, a top-down wipe between faces
+  syncKaomoji(kaomojiWipeRows);
+#endif
 }
 
-#endif
\ No newline at end of file
+#endif
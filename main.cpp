@@ -1,23 +1,90 @@
+#include "compositor.h"
 #include "time.h"
 #include "kaomoji.h"
 #include "tiktok_live.h"
+#include "animation.h"
+
+// Set to 1 after running tools/encode_intro.cpp to play the delta-encoded intro_anim.h
+#ifndef USE_DELTA_INTRO
+#define USE_DELTA_INTRO 0
+#endif
+
+#if USE_DELTA_INTRO
+#include "intro_anim.h" // Generated from intro.h
+const unsigned long introFrameInterval = 50; // Deltas are small enough for 20 frames per second
+#else
 #include "intro.h" // Include the intro header file
+#endif
 
 TFT_eSPI tft = TFT_eSPI(); // Create TFT instance
 
+// Boot phase timestamps (millis), printed once the clock and the server are both up
+unsigned long introDoneAt = 0;
+bool bootReported = false;
+bool firstEventReported = false;
+
+// Cooperative scheduler for the network bring-up. Each step only polls, so
+// WiFi, NTP and the WebSocket handshake overlap instead of running back to back.
+void runBackgroundTasks() {
+  updateTimeSync();
+  if (!isTikTokLiveInitialized && WiFi.status() == WL_CONNECTED) {
+    startTikTokLive(); // The server is only reachable once WiFi is up
+  }
+  updateTikTokLive();
+}
+
+// Replaces delay() during boot: keeps the background tasks running until the deadline
+void waitUntil(unsigned long deadline) {
+  do {
+    runBackgroundTasks();
+    delay(1);
+  } while ((long)(deadline - millis()) > 0);
+}
+
+void reportBootTimings() {
+  if (!bootReported && introDoneAt && timeSyncedAt && liveConnectedAt) {
+    Serial.println("Boot timings (ms since power on):");
+    Serial.printf("  intro done:     %lu\n", introDoneAt);
+    Serial.printf("  WiFi connected: %lu\n", wifiConnectedAt);
+    Serial.printf("  time synced:    %lu\n", timeSyncedAt);
+    Serial.printf("  server ready:   %lu\n", liveConnectedAt);
+    bootReported = true;
+  }
+  if (!firstEventReported && firstEventAt) {
+    Serial.printf("First live event after %lu ms\n", firstEventAt);
+    firstEventReported = true;
+  }
+}
+
 // Function to display the intro animation using all bitmap frames
 void displayIntro() {
   Serial.println("Displaying intro animation...");
   tft.fillScreen(TFT_BLACK);
   
+#if USE_DELTA_INTRO
+  // Each frame only redraws the pixels that changed since the previous one
+  AnimationPlayer intro;
+  beginAnimation(intro, intro_anim);
+  unsigned long nextFrame = millis();
+  while (drawAnimationFrame(intro, tft, 0, 0, TFT_WHITE, TFT_BLACK)) {
+    if (intro.frame % 10 == 1) {
+      Serial.printf("Displaying frame %d (%lu runs)\n", intro.frame - 1, (unsigned long)intro.runs);
+    }
+    // Keep a steady frame rate regardless of how long the frame took to draw
+    nextFrame += introFrameInterval;
+    waitUntil(nextFrame);
+  }
+#else
   // Loop through all 64 frames in the animation
+  unsigned long nextFrame = millis();
   for (int i = 0; i < epd_bitmap_allArray_LEN; i++) {
     // Display current frame without clearing the screen between frames
     // This reduces flickering significantly
     tft.drawBitmap(0, 0, epd_bitmap_allArray[i], 240, 320, TFT_WHITE);
     
     // Slow down the animation to reduce eye strain
-    delay(100); // 100ms delay = 10 frames per second (more comfortable)
+    nextFrame += 100; // 100ms per frame = 10 frames per second (more comfortable)
+    waitUntil(nextFrame);
     
     // Optional: Print debug info
     if (i % 10 == 0) { // Print only every 10 frames to reduce serial overhead
@@ -25,9 +92,10 @@ void displayIntro() {
       Serial.println(i);
     }
   }
+#endif
   
   Serial.println("Animation complete");
-  delay(1000); // Pause at the end of animation
+  waitUntil(millis() + 1000); // Pause at the end of animation
   
   Serial.println("Clearing screen...");
   tft.fillScreen(TFT_BLACK);
@@ -40,19 +108,33 @@ void setup() {
   tft.init();
   tft.setRotation(0); // Landscape mode for 2.8" CYD
   
-  // Show intro screen first
+  // Start WiFi association first so it runs while the intro plays
+  initializeTime();
+  
+  // Show intro screen
   displayIntro();
+  introDoneAt = millis();
   
-  // Then initialize other components
-  initializeTime(); // Initialize WiFi and NTP
-  initializeTikTokLive(); // Initialize TikTok Live connection
+  // Screen bands the modules draw into (only buffered when USE_COMPOSITOR is set)
+  compositorAddLayer(LAYER_KAOMOJI, KAOMOJI_Y - 10, 55);
+  compositorAddLayer(LAYER_TIME, DISPLAY_Y, DISPLAY_HEIGHT);
+  compositorAddLayer(LAYER_TIKTOK, TIKTOK_Y, TIKTOK_HEIGHT);
+  initializeCompositor();
+  initializeKaomoji(); // Rasterize the face parts once
+  
+  // Draw the TikTok panel with anything that arrived during the intro.
+  // If WiFi is still down the connection is started later from loop().
+  showTikTokLive();
 }
 
 void loop() {
+  runBackgroundTasks(); // WiFi/NTP retries, WebSocket connection and TikTok Live updates
+  reportBootTimings();
+  
   if (isTimeInitialized()) {
     displayKaomoji(); // Display random kaomoji above the clock
     displayTime();    // Update the time display
   }
-  updateTikTokLive(); // Update TikTok Live display
+  compositorFlush();  // Push the bands that changed this frame
   delay(10); // Short delay for responsiveness
 }
\ No newline at end of file
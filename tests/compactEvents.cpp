@@ -0,0 +1,77 @@
+/**
+ * @file compactEvents.cpp
+ * Checks that COMPACT_EVENTS of Server/server.js and the tables of
+ * tiktok_events.h give every event type the same id, value and count fields.
+ * The server sends the id alone, so a mismatch shows the wrong event.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <string>
+
+#include "../tiktok_events.h"
+
+static int failures = 0;
+
+// The quoted value of field in a line like "gift: { id: 4, value: 'giftName' }"
+static std::string field(const std::string& line, const char* name) {
+  size_t at = line.find(std::string(name) + ": ");
+  if (at == std::string::npos)
+    return std::string();
+  at += strlen(name) + 2;
+  if (line[at] != '\'')
+    return line.substr(at, line.find_first_of(",} ", at) - at);
+  return line.substr(at + 1, line.find('\'', at + 1) - at - 1);
+}
+
+static void check(const char* type, const std::string& expected,
+                  const char* actual, const char* what) {
+  if (expected != (actual ? actual : "")) {
+    printf("FAIL %s: %s is '%s' on the server, '%s' on the display\n", type,
+           what, expected.c_str(), actual ? actual : "");
+    failures++;
+  }
+}
+
+int main() {
+  std::ifstream file(SERVER_JS);
+  if (!file) {
+    printf("FAIL can't open %s\n", SERVER_JS);
+    return 1;
+  }
+
+  std::string line;
+  while (std::getline(file, line) &&
+         line.find("const COMPACT_EVENTS = {") == std::string::npos) {
+  }
+
+  int types = 0;
+  while (std::getline(file, line) && line.find("};") == std::string::npos) {
+    size_t nameStart = line.find_first_not_of(' ');
+    std::string type = line.substr(nameStart, line.find(':') - nameStart);
+    int id = atoi(field(line, "id").c_str());
+    types++;
+
+    if (id < 0 || id >= EVENT_UNKNOWN) {
+      printf("FAIL %s: id %d has no type on the display\n", type.c_str(), id);
+      failures++;
+      continue;
+    }
+    check(type.c_str(), type, eventTypeNames[id], "the name of its id");
+    check(type.c_str(), field(line, "value"), eventValueKeys[id], "value");
+    check(type.c_str(), field(line, "count"), eventCountKeys[id], "count");
+  }
+
+  if (types != EVENT_UNKNOWN) {
+    printf("FAIL the server has %d types, the display %d\n", types,
+           int(EVENT_UNKNOWN));
+    failures++;
+  }
+
+  printf("%d event types\n", types);
+  printf(failures ? "FAILED\n" : "passed\n");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file relayAllocations.cpp
+ * Replays the recorded relay events through the decoders of the display and
+ * counts the heap allocations per event: the old handleMessage(), a
+ * DynamicJsonDocument and String copies per event, against
+ * decodeJsonEvent() and decodeBinaryEvent(), which parse in place into the
+ * long-lived document. Fails if the in-place decoders allocate.
+ */
+
+#include <stdlib.h>
+
+#include <new>
+#include <vector>
+
+#include "relayEvents.h"
+
+static size_t allocations = 0;
+
+// Every operator new of the process is counted
+void* operator new(size_t size) {
+  allocations++;
+  void* p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+// And so is every allocation of a BasicJsonDocument
+struct CountingAllocator {
+  void* allocate(size_t size) {
+    allocations++;
+    return malloc(size);
+  }
+
+  void deallocate(void* p) {
+    free(p);
+  }
+
+  void* reallocate(void* p, size_t size) {
+    allocations++;
+    return realloc(p, size);
+  }
+};
+
+static size_t sink;
+
+// handleMessage() before it decoded in place: the payload copied to a
+// String, a document per event and the fields copied to Strings
+static void decodeWithCopies(const char* payload, size_t length) {
+  std::string message(payload, length);
+  BasicJsonDocument<CountingAllocator> doc(1024);
+  if (deserializeJson(doc, message))
+    return;
+  std::string type = doc["type"] | "";
+  std::string username = doc["username"] | "";
+  std::string content = doc["message"] | "";
+  std::string giftName = doc["giftName"] | "";
+  int count = doc["count"] | 0;
+  sink += type.size() + username.size() + content.size() + giftName.size() +
+          size_t(count);
+}
+
+int main() {
+  initializeEventFilter();
+  std::vector<std::string> jsonFrames, msgPackFrames;
+  for (size_t i = 0; i < recordedFrameCount; i++) {
+    jsonFrames.push_back(recordedFrames[i]);
+    msgPackFrames.push_back(toCompactEvent(recordedFrames[i]));
+  }
+  std::vector<char> buffer(1024);  // the payload, decoded in place
+  TikTokEvent event;
+
+  size_t copies = 0, inPlaceJson = 0, inPlaceMsgPack = 0;
+  for (size_t i = 0; i < recordedFrameCount; i++) {
+    const std::string& json = jsonFrames[i];
+    const std::string& msgPack = msgPackFrames[i];
+
+    size_t before = allocations;
+    decodeWithCopies(json.data(), json.size());
+    copies += allocations - before;
+
+    memcpy(buffer.data(), json.data(), json.size());
+    before = allocations;
+    decodeJsonEvent(buffer.data(), json.size(), event);
+    sink += eventChecksum(event);
+    inPlaceJson += allocations - before;
+
+    memcpy(buffer.data(), msgPack.data(), msgPack.size());
+    before = allocations;
+    decodeBinaryEvent(buffer.data(), msgPack.size(), event);
+    sink += eventChecksum(event);
+    inPlaceMsgPack += allocations - before;
+  }
+
+  printf("%zu events\n", recordedFrameCount);
+  printf("%-34s %18s\n", "decoder", "allocations/event");
+  printf("%-34s %18.2f\n", "String copies, document per event",
+         double(copies) / recordedFrameCount);
+  printf("%-34s %18.2f\n", "JSON in place with the filter",
+         double(inPlaceJson) / recordedFrameCount);
+  printf("%-34s %18.2f\n", "MsgPack in place",
+         double(inPlaceMsgPack) / recordedFrameCount);
+  bool failed = inPlaceJson || inPlaceMsgPack;
+  printf(failed ? "FAILED\n" : "passed\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,141 @@
+#ifndef RELAY_EVENTS_H
+#define RELAY_EVENTS_H
+
+// A recorded stream of relay events, as Server/server.js sends them in each
+// format, for the host tests of tiktok_events.h.
+
+#include <ArduinoJson.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+
+#include "../tiktok_events.h"
+
+// The JSON text frames, in the order they arrived
+static const char* const recordedFrames[] = {
+    "{\"type\":\"connection\",\"status\":\"connected\",\"timestamp\":"
+    "1792251139950}",
+    "{\"type\":\"tiktok_connected\",\"roomId\":\"7432109876543210987\","
+    "\"timestamp\":1792251140012}",
+    "{\"type\":\"viewers\",\"count\":1532,\"timestamp\":1792251141003}",
+    "{\"type\":\"chat\",\"username\":\"tiktok_user123\",\"message\":\"this "
+    "stream is amazing, love it! \\ud83d\\udd25\",\"timestamp\":"
+    "1792251141250}",
+    "{\"type\":\"like\",\"username\":\"night.owl\",\"likeCount\":15,"
+    "\"timestamp\":1792251141502}",
+    "{\"type\":\"chat\",\"username\":\"anna_k\",\"message\":\"hi from "
+    "Berlin!\",\"timestamp\":1792251141877}",
+    "{\"type\":\"follow\",\"username\":\"new_fan\",\"timestamp\":"
+    "1792251142104}",
+    "{\"type\":\"gift\",\"username\":\"generous.viewer\",\"giftName\":"
+    "\"Rose\",\"giftId\":5655,\"repeatCount\":37,\"timestamp\":"
+    "1792251142330}",
+    "{\"type\":\"chat\",\"username\":\"\\u30bf\\u30ed\\u30a6\",\"message\":"
+    "\"\\u3053\\u3093\\u3070\\u3093\\u306f\",\"timestamp\":1792251142611}",
+    "{\"type\":\"like\",\"username\":\"tiktok_user123\",\"likeCount\":3,"
+    "\"timestamp\":1792251142950}",
+    "{\"type\":\"chat\",\"username\":\"m.ivanov\",\"message\":\"\\u041f\\u0440"
+    "\\u0438\\u0432\\u0435\\u0442 \\u0432\\u0441\\u0435\\u043c\",\"timestamp\":"
+    "1792251143204}",
+    "{\"type\":\"viewers\",\"count\":1547,\"timestamp\":1792251144001}",
+    "{\"type\":\"gift\",\"username\":\"anna_k\",\"giftName\":\"TikTok\","
+    "\"giftId\":5269,\"repeatCount\":1,\"timestamp\":1792251144380}",
+    "{\"type\":\"chat\",\"username\":\"gamer_4life\",\"message\":\"what game "
+    "is this? can you play it again tomorrow at the same time?\","
+    "\"timestamp\":1792251144702}",
+    "{\"type\":\"like\",\"username\":\"anna_k\",\"likeCount\":120,"
+    "\"timestamp\":1792251145033}",
+    "{\"type\":\"follow\",\"username\":\"someone.new\",\"timestamp\":"
+    "1792251145561}",
+    "{\"type\":\"error\",\"message\":\"Rate limited, retrying\","
+    "\"timestamp\":1792251146105}",
+};
+
+const size_t recordedFrameCount =
+    sizeof(recordedFrames) / sizeof(recordedFrames[0]);
+
+// encodeMsgPack() of server.js, for the types a compact event holds
+inline void encodeMsgPack(std::string& out, JsonVariantConst value) {
+  if (value.isNull()) {
+    out += '\xc0';
+  } else if (value.is<unsigned long>() && value.as<unsigned long>() < 0x80) {
+    out += char(value.as<unsigned long>());
+  } else if (value.is<unsigned long>()) {
+    unsigned long v = value.as<unsigned long>();
+    out += '\xce';
+    for (int shift = 24; shift >= 0; shift -= 8)
+      out += char(v >> shift);
+  } else {
+    const char* s = value.as<const char*>();
+    size_t n = strlen(s);
+    if (n < 32) {
+      out += char(0xa0 | n);
+    } else if (n < 0x100) {
+      out += '\xd9';
+      out += char(n);
+    } else {
+      out += '\xda';
+      out += char(n >> 8);
+      out += char(n);
+    }
+    out += s;
+  }
+}
+
+// toCompactEvent() of server.js: [type id, username, value, count]. It reads
+// the tables of the display, compactEvents checks they match the server's.
+inline std::string toCompactEvent(const std::string& json) {
+  DynamicJsonDocument data(1024);
+  deserializeJson(data, json);
+  for (int id = 0; id < EVENT_UNKNOWN; id++) {
+    if (strcmp(data["type"] | "", eventTypeNames[id]) != 0)
+      continue;
+    int size = 2 + (eventValueKeys[id] != nullptr) +
+               (eventCountKeys[id] != nullptr);
+    std::string frame(1, char(0x90 | size));
+    frame += char(id);
+    encodeMsgPack(frame, data["username"]);
+    if (eventValueKeys[id])
+      encodeMsgPack(frame, data[eventValueKeys[id]]);
+    if (eventCountKeys[id])
+      encodeMsgPack(frame, data[eventCountKeys[id]]);
+    return frame;
+  }
+  return std::string();
+}
+
+// Sums what handleEvent() reads of an event, so that decodes can be compared
+inline size_t eventChecksum(const TikTokEvent& event) {
+  return size_t(event.type) + strlen(event.username) +
+         strlen(event.value | "") + (event.value | 0u) + size_t(event.count);
+}
+
+// Returns the best time of one call to f(), in seconds, over 7 batches of at
+// least 10 ms
+template <typename TFunction>
+double measure(TFunction f) {
+  typedef std::chrono::steady_clock clock;
+  long calls = 1;
+  double best = 0;
+  for (int batch = 0; batch < 7;) {
+    clock::time_point start = clock::now();
+    for (long i = 0; i < calls; i++)
+      f();
+    double seconds =
+        std::chrono::duration<double>(clock::now() - start).count();
+    if (seconds < 0.01) {
+      calls *= 2;
+      continue;
+    }
+    double perCall = seconds / double(calls);
+    if (batch == 0 || perCall < best)
+      best = perCall;
+    batch++;
+  }
+  return best;
+}
+
+#endif
@@ -0,0 +1,83 @@
+/**
+ * @file relayReplay.cpp
+ * Replays the recorded relay events through the two decoders of the display,
+ * decodeJsonEvent() on the JSON text frame parsed in place with the filter,
+ * and decodeBinaryEvent() on the MsgPack array of the compact protocol.
+ * Both must hand the same fields to handleEvent(). Prints the bytes and the
+ * decode time of each event.
+ */
+
+#include <vector>
+
+#include "relayEvents.h"
+
+struct Frame {
+  std::string bytes;
+  std::vector<char> buffer;  // the payload, decoded in place
+
+  explicit Frame(const std::string& b) : bytes(b), buffer(b.size()) {}
+
+  char* payload() {
+    memcpy(buffer.data(), bytes.data(), bytes.size());
+    return buffer.data();
+  }
+};
+
+static size_t sink;
+
+int main() {
+  initializeEventFilter();
+  size_t jsonBytes = 0, msgPackBytes = 0;
+  double jsonSeconds = 0, msgPackSeconds = 0;
+  int failures = 0;
+
+  // the copy back is part of both times, but it's a memcpy of a few bytes
+  printf("%-20s %10s %10s %10s %10s\n", "event", "JSON B", "MsgPack B",
+         "JSON ns", "MsgPack ns");
+  for (size_t i = 0; i < recordedFrameCount; i++) {
+    Frame json(recordedFrames[i]);
+    Frame msgPack(toCompactEvent(json.bytes));
+    TikTokEvent event;
+
+    DeserializationError jsonError =
+        decodeJsonEvent(json.payload(), json.bytes.size(), event);
+    EventType type = event.type;
+    size_t fromJson = eventChecksum(event);
+    DeserializationError msgPackError =
+        decodeBinaryEvent(msgPack.payload(), msgPack.bytes.size(), event);
+    if (jsonError || msgPackError || type == EVENT_UNKNOWN ||
+        event.type != type || eventChecksum(event) != fromJson) {
+      printf("FAIL %s\n", recordedFrames[i]);
+      failures++;
+      continue;
+    }
+
+    double jsonTime = measure([&]() {
+      decodeJsonEvent(json.payload(), json.bytes.size(), event);
+      sink += eventChecksum(event);
+    });
+    double msgPackTime = measure([&]() {
+      decodeBinaryEvent(msgPack.payload(), msgPack.bytes.size(), event);
+      sink += eventChecksum(event);
+    });
+
+    printf("%-20s %10zu %10zu %10.0f %10.0f\n", eventTypeNames[type],
+           json.bytes.size(), msgPack.bytes.size(), jsonTime * 1e9,
+           msgPackTime * 1e9);
+    jsonBytes += json.bytes.size();
+    msgPackBytes += msgPack.bytes.size();
+    jsonSeconds += jsonTime;
+    msgPackSeconds += msgPackTime;
+  }
+
+  printf("%-20s %10.1f %10.1f %10.0f %10.0f\n", "per event",
+         double(jsonBytes) / recordedFrameCount,
+         double(msgPackBytes) / recordedFrameCount,
+         jsonSeconds * 1e9 / recordedFrameCount,
+         msgPackSeconds * 1e9 / recordedFrameCount);
+  printf("MsgPack is %.1fx smaller and decodes %.1fx faster\n",
+         double(jsonBytes) / double(msgPackBytes),
+         jsonSeconds / msgPackSeconds);
+  printf(failures ? "FAILED\n" : "passed\n");
+  return failures ? 1 : 0;
+}
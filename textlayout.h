@@ -0,0 +1,166 @@
+#ifndef TEXTLAYOUT_H
+#define TEXTLAYOUT_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// Width-based word wrapping of UTF-8 text for whatever font the TFT has
+// selected (GLCD, built-in, free or smooth fonts). A message is laid out once
+// when it arrives; the resulting byte spans are kept with it, so a redraw
+// only rasterizes. Fonts are drawn without kerning, so a line is as wide as
+// the sum of its glyph advances.
+const int TEXT_LAYOUT_MAX_LINES = 4;
+
+// One wrapped line: a run of bytes in the source text
+struct TextSpan {
+  uint16_t start = 0;  // Byte offset into the text
+  uint16_t length = 0; // Bytes on this line, surrounding spaces excluded
+  int16_t width = 0;   // Pixels, including the ellipsis of a truncated line
+  uint8_t glyphs = 0;  // Code points drawn, including the ellipsis
+};
+
+struct TextLayout {
+  TextSpan lines[TEXT_LAYOUT_MAX_LINES];
+  uint8_t lineCount = 0;
+  bool truncated = false; // The text did not fit, the last line ends in "..."
+};
+
+const char TEXT_ELLIPSIS[] = "...";
+
+// Function declarations
+int textGlyphWidth(TFT_eSPI& gfx, uint16_t code);
+uint16_t nextCodePoint(TFT_eSPI& gfx, const char* text, uint16_t* index, uint16_t length);
+void layoutText(TFT_eSPI& gfx, const char* text, int maxWidth, int maxLines, TextLayout& layout);
+void drawTextLine(TFT_eSPI& gfx, const char* text, const TextLayout& layout, int line);
+
+// Cursor advance of one code point in the current font and text size
+int textGlyphWidth(TFT_eSPI& gfx, uint16_t code) {
+#ifdef SMOOTH_FONT
+  if (gfx.fontLoaded) {
+    if (code == ' ') return gfx.gFont.spaceWidth;
+    uint16_t gNum = 0;
+    if (gfx.getUnicodeIndex(code, &gNum)) return gfx.gxAdvance[gNum];
+    return gfx.gFont.spaceWidth + 1; // drawGlyph() draws a box for missing glyphs
+  }
+#endif
+  // Other fonts draw one cell per code point. textWidth() of a single character
+  // is its ink width, so the advance is taken from a pair of them.
+  char pair[3] = {' ', ' ', '\0'};
+  if (code > ' ' && code < 0x80) pair[0] = pair[1] = code;
+  return gfx.textWidth(pair) - gfx.textWidth(pair + 1);
+}
+
+// Decodes the next code point from *index like write() does when printing,
+// so the layout counts the same glyphs that are drawn. Lead bytes of a
+// sequence that is cut short draw nothing and are skipped, bytes that start
+// no sequence draw as extended ASCII. Returns 0 if only skipped bytes are left.
+uint16_t nextCodePoint(TFT_eSPI& gfx, const char* text, uint16_t* index, uint16_t length) {
+  uint8_t pending = 0; // Continuation bytes still expected
+  uint16_t code = 0;
+  while (*index < length) {
+    uint8_t c = text[(*index)++];
+    if (!gfx.getAttribute(UTF8_SWITCH) || c < 0x80) return c;
+    if (pending == 0) {
+      if ((c & 0xE0) == 0xC0) { code = (c & 0x1F) << 6; pending = 1; }
+      else if ((c & 0xF0) == 0xE0) { code = (c & 0x0F) << 12; pending = 2; }
+      else return c;
+    }
+    else if (--pending) code |= (c & 0x3F) << 6;
+    else return code | (c & 0x3F);
+  }
+  return 0;
+}
+
+// Breaks text into at most maxLines lines no wider than maxWidth pixels.
+// Lines break at spaces and newlines; a word longer than a line is split
+// between glyphs. If the text does not fit, the last line is cut so that "..."
+// fits behind it.
+void layoutText(TFT_eSPI& gfx, const char* text, int maxWidth, int maxLines, TextLayout& layout) {
+  uint16_t length = strlen(text);
+  uint16_t pos = 0;
+  layout = TextLayout();
+  maxLines = min(maxLines, TEXT_LAYOUT_MAX_LINES);
+
+  while (layout.lineCount < maxLines) {
+    while (pos < length && text[pos] == ' ') pos++;
+    if (pos >= length) break;
+
+    // fit ends at the last glyph placed, wrap at the last word followed by a space
+    TextSpan& line = layout.lines[layout.lineCount++];
+    line.start = pos;
+    TextSpan fit = line;
+    TextSpan wrap = line;
+    int width = 0;
+    int glyphs = 0;
+    bool full = false;
+
+    while (pos < length) {
+      uint16_t next = pos;
+      uint16_t code = nextCodePoint(gfx, text, &next, length);
+      if (code == '\n' || code == 0) {
+        pos = next;
+        break;
+      }
+
+      int glyphWidth = textGlyphWidth(gfx, code);
+      if (code != ' ' && width + glyphWidth > maxWidth && glyphs > 0) {
+        full = true;
+        break;
+      }
+
+      width += glyphWidth;
+      glyphs++;
+      if (code == ' ') {
+        if (fit.length > wrap.length) wrap = fit;
+      } else {
+        fit.length = next - line.start;
+        fit.width = width;
+        fit.glyphs = glyphs;
+      }
+      pos = next;
+    }
+
+    // A full line goes back to the last space unless one word fills it
+    if (full && wrap.length > 0) fit = wrap;
+    if (full) pos = fit.start + fit.length;
+    line = fit;
+  }
+
+  while (pos < length && (text[pos] == ' ' || text[pos] == '\n')) pos++;
+  if (pos >= length || layout.lineCount == 0) return;
+
+  // Text is left over: refill the last line glyph by glyph up to the ellipsis
+  TextSpan& last = layout.lines[layout.lineCount - 1];
+  int ellipsisWidth = strlen(TEXT_ELLIPSIS) * textGlyphWidth(gfx, '.');
+  TextSpan fit = last;
+  fit.length = 0;
+  fit.width = 0;
+  fit.glyphs = 0;
+  int width = 0;
+  int glyphs = 0;
+  for (uint16_t i = last.start; i < length; ) {
+    uint16_t code = nextCodePoint(gfx, text, &i, length);
+    if (code == '\n' || code == 0) break;
+    width += textGlyphWidth(gfx, code);
+    glyphs++;
+    if (width + ellipsisWidth > maxWidth) break;
+    if (code != ' ') {
+      fit.length = i - last.start;
+      fit.width = width;
+      fit.glyphs = glyphs;
+    }
+  }
+  last = fit;
+  last.width += ellipsisWidth;
+  last.glyphs += strlen(TEXT_ELLIPSIS);
+  layout.truncated = true;
+}
+
+// Prints one laid out line at the cursor, adding the ellipsis where the text was cut
+void drawTextLine(TFT_eSPI& gfx, const char* text, const TextLayout& layout, int line) {
+  const TextSpan& span = layout.lines[line];
+  for (uint16_t i = 0; i < span.length; i++) gfx.write(text[span.start + i]);
+  if (layout.truncated && line == layout.lineCount - 1) gfx.print(TEXT_ELLIPSIS);
+}
+
+#endif
@@ -0,0 +1,95 @@
+    #ifndef TIKTOK_EVENTS_H
+    #define TIKTOK_EVENTS_H
+
+    #include <ArduinoJson.h>
+    #include <string.h>
+
+    // Decoding of the relay's events, apart from the display so the host
+    // tests in tests/ replay recorded events through the same code.
+
+    // Event types understood by the display. The ids are the type field of the
+    // compact binary events and must match COMPACT_EVENTS in Server/server.js.
+    enum EventType {
+        EVENT_CONNECTION,
+        EVENT_TIKTOK_CONNECTED,
+        EVENT_TIKTOK_DISCONNECTED,
+        EVENT_CHAT,
+        EVENT_GIFT,
+        EVENT_LIKE,
+        EVENT_FOLLOW,
+        EVENT_VIEWERS,
+        EVENT_ERROR,
+        EVENT_UNKNOWN
+    };
+    // JSON name of each type and the JSON fields carrying its value and repeat count
+    const char* const eventTypeNames[] = {"connection", "tiktok_connected", "tiktok_disconnected", "chat", "gift", "like", "follow", "viewers", "error"};
+    const char* const eventValueKeys[] = {"status", "roomId", nullptr, "message", "giftName", "likeCount", nullptr, "count", "message"};
+    const char* const eventCountKeys[] = {nullptr, nullptr, nullptr, nullptr, "repeatCount", nullptr, nullptr, nullptr, nullptr};
+
+    // A decoded event. Its strings point into the payload it was decoded from,
+    // so it is only valid until the payload buffer is reused.
+    struct TikTokEvent {
+        EventType type = EVENT_UNKNOWN;
+        const char* username = "";
+        JsonVariantConst value;
+        int count = 1; // Likes and gifts may arrive merged by the server
+    };
+
+    // Incoming events are parsed in place from the WebSocket payload into this
+    // long-lived document; the filter keeps only the fields the display uses
+    StaticJsonDocument<JSON_OBJECT_SIZE(9)> eventDoc;
+    StaticJsonDocument<JSON_OBJECT_SIZE(9)> eventFilter;
+
+    // Function declarations
+    void initializeEventFilter();
+    DeserializationError decodeJsonEvent(char* payload, size_t length, TikTokEvent& event);
+    DeserializationError decodeBinaryEvent(char* payload, size_t length, TikTokEvent& event);
+
+    // Fields kept when decoding events, everything else is skipped by the parser
+    void initializeEventFilter() {
+        eventFilter.clear();
+        eventFilter["type"] = true;
+        eventFilter["username"] = true;
+        for (int i = 0; i < EVENT_UNKNOWN; i++) {
+            if (eventValueKeys[i]) eventFilter[eventValueKeys[i]] = true;
+            if (eventCountKeys[i]) eventFilter[eventCountKeys[i]] = true;
+        }
+    }
+
+    // Decodes in place: strings in eventDoc point into the payload buffer
+    DeserializationError decodeJsonEvent(char* payload, size_t length, TikTokEvent& event) {
+        event = TikTokEvent();
+        DeserializationError error = deserializeJson(eventDoc, payload, length,
+                                                     DeserializationOption::Filter(eventFilter));
+        if (error) return error;
+
+        const char* typeName = eventDoc["type"] | "";
+        for (int i = 0; i < EVENT_UNKNOWN; i++) {
+            if (strcmp(typeName, eventTypeNames[i]) == 0) {
+                event.type = (EventType)i;
+                break;
+            }
+        }
+
+        if (event.type != EVENT_UNKNOWN && eventValueKeys[event.type]) event.value = eventDoc[eventValueKeys[event.type]];
+        if (event.type != EVENT_UNKNOWN && eventCountKeys[event.type]) event.count = eventDoc[eventCountKeys[event.type]] | 1;
+        event.username = eventDoc["username"] | "";
+        return error;
+    }
+
+    // Compact events are a MsgPack array [type id, username, value, count], decoded in place like JSON
+    DeserializationError decodeBinaryEvent(char* payload, size_t length, TikTokEvent& event) {
+        event = TikTokEvent();
+        DeserializationError error = deserializeMsgPack(eventDoc, payload, length);
+        if (error) return error;
+
+        JsonArrayConst fields = eventDoc.as<JsonArrayConst>();
+        int typeId = fields[0] | -1;
+        if (typeId >= 0 && typeId < EVENT_UNKNOWN) event.type = (EventType)typeId;
+        event.username = fields[1] | "";
+        event.value = fields[2];
+        event.count = fields[3] | 1;
+        return error;
+    }
+
+    #endif
@@ -6,13 +6,32 @@
     #include <WebSocketsClient.h>
     #include <ArduinoJson.h>
     #include <TFT_eSPI.h>
+    #include "compositor.h"
+    #include "textlayout.h"
+    #include "tiktok_events.h"
 
     // External TFT reference
     extern TFT_eSPI tft;
 
+    // Set to 1 to log the pixels and SPI bytes each panel update pushes
+    #ifndef TIKTOK_PANEL_STATS
+    #define TIKTOK_PANEL_STATS 0
+    #endif
+
     // WebSocket server details (your Node.js server)
     const char* websocket_server = "REPLACE_IP_ADDRESS"; // Replace with your server IP
     const int websocket_port = 3000;
+    // Asks the server for compact MsgPack events; servers without binary support ignore it and send JSON
+    const char* websocket_path = "/?format=msgpack";
+    // Events and fields the display uses; the server forwards nothing else to this client
+    const char* eventSubscription =
+        "{\"type\":\"subscribe\",\"events\":{"
+        "\"chat\":[\"username\",\"message\"],"
+        "\"gift\":[\"username\",\"giftName\",\"repeatCount\"],"
+        "\"like\":[\"username\",\"likeCount\"],"
+        "\"follow\":[\"username\"],"
+        "\"viewers\":[\"count\"]},"
+        "\"maxFrameBytes\":%d}";
 
     // WebSocket client
     WebSocketsClient webSocket;
@@ -32,14 +51,62 @@
     int scrollY = 0;
     const int lineHeight = 25; // Reduced from 30 to fit better on screen
     const int maxLines = 4; // Keeping the same number of lines
-    String displayLines[maxLines][2]; // Changed to 2D array to store username and content separately
+    const int maxContentLines = 3; // Maximum number of content lines to display
+    const int panelTextCells = 35; // GLCD cells per text row, one per code point
+    // UTF-8 of one code point more than the content lines hold, at 3 bytes
+    // each, so content cut to fit still overflows the layout and ends in "..."
+    const int maxContentBytes = (maxContentLines * panelTextCells + 1) * 3;
+    const int usernameWidth = 15 * 6; // Pixels, longer usernames are truncated with "..."
+    const int maxUsernameBytes = (usernameWidth / 6 + 1) * 3; // As maxContentBytes, for its one line
+    
+    // Fixed buffers hold only what the panel can show, so entries never touch the heap.
+    // Each entry is wrapped once when it is added; redraws reuse its layout.
+    struct PanelEntry {
+        uint32_t id = 0; // 0 marks a free slot
+        char username[maxUsernameBytes + 1];
+        char content[maxContentBytes + 1];
+        uint16_t color; // Content colour
+        TextLayout usernameLayout;
+        TextLayout contentLayout;
+        bool opaque; // Every glyph paints its whole cell, see panelTextOpaque()
+    };
+    PanelEntry panelEntries[maxLines];
+    uint32_t nextEntryId = 1;
     int currentLine = 0;
 
+    // Retained panel state: the text rows currently on screen, so a new entry
+    // only re-rasterizes the rows that actually changed. Entry texts never
+    // change, so the entry id and line stand for the text of a row.
+    struct PanelRow {
+        int16_t y;
+        int16_t width; // Pixels covered by the row's glyph cells
+        uint16_t color;
+        uint32_t entryId;
+        uint8_t slot; // Index in panelEntries
+        int8_t line; // Content line, or -1 for the username
+        uint8_t glyphs;
+        bool opaque;
+    };
+    const int maxPanelRows = maxLines * 4; // Up to 3 content rows plus the username per entry
+    PanelRow shownRows[maxPanelRows];
+    int shownRowCount = 0;
+    bool panelNeedsClear = true;
+
+    #if TIKTOK_PANEL_STATS
+    const uint32_t PANEL_WINDOW_BYTES = 11; // CASET + RASET + RAMWR commands and arguments
+    struct PanelStats {
+        uint32_t pixels = 0;
+        uint32_t windows = 0;
+    };
+    PanelStats panelStats;
+    #endif
+
     // TikTok display position (on the left side)
     const int TIKTOK_X = 5; // Position on the left side
     const int TIKTOK_Y = 210; // Moved down further from 190 to avoid overlap with time display
     const int TIKTOK_WIDTH = 230; // Width of the TikTok section
     const int TIKTOK_HEIGHT = 100; // Further reduced height to fit better on screen
+    const int panelTextWidth = panelTextCells * 6; // Pixels per text row
 
     // Colors
     #define TL_BLACK 0x0000
@@ -53,27 +120,40 @@
 
     // Function declarations
     void webSocketEvent(WStype_t type, uint8_t * payload, size_t length);
-    void handleMessage(String message);
-    void addLine(String username, String content, uint16_t color); // Updated function declaration
+    void handleMessage(uint8_t * payload, size_t length);
+    void handleBinaryMessage(uint8_t * payload, size_t length);
+    void handleEvent(EventType type, const char* username, JsonVariantConst value, int count);
+    void addLine(const char* username, const char* content, uint16_t color); // Updated function declaration
+    void setPanelFont(TFT_eSPI& gfx);
+    void renderPanel();
+    void startTikTokLive();
+    void showTikTokLive();
     void initializeTikTokLive();
     void updateTikTokLive();
     bool isTikTokLiveInitialized = false;
+    bool isTikTokPanelShown = false; // Until then entries are only buffered, the intro owns the screen
 
-    void initializeTikTokLive() {
+    // Boot phase timestamps (millis), 0 until the phase completes
+    unsigned long liveConnectedAt = 0;
+    unsigned long firstEventAt = 0;
+
+    // Opens the WebSocket connection without touching the screen, so the
+    // handshake can run while the intro is still playing
+    void startTikTokLive() {
+        if (isTikTokLiveInitialized) return;
+        
         // Clear display lines
         for(int i = 0; i < maxLines; i++) {
-            displayLines[i][0] = ""; // Initialize first dimension
-            displayLines[i][1] = ""; // Initialize second dimension
+            panelEntries[i].id = 0;
         }
         
-        // Draw border around TikTok section
-        tft.drawRect(TIKTOK_X, TIKTOK_Y, TIKTOK_WIDTH, TIKTOK_HEIGHT, TL_WHITE);
+        initializeEventFilter();
         
         // Show startup message - simplified
         addLine("System", "Waiting for Server", TL_YELLOW);
         
         // Setup WebSocket with improved settings
-        webSocket.begin(websocket_server, websocket_port, "/");
+        webSocket.begin(websocket_server, websocket_port, websocket_path);
         webSocket.onEvent(webSocketEvent);
         webSocket.setReconnectInterval(reconnectBaseDelay);
         
@@ -88,6 +168,24 @@
         isTikTokLiveInitialized = true;
     }
 
+    // Draws the panel with whatever arrived so far
+    void showTikTokLive() {
+        shownRowCount = 0;
+        panelNeedsClear = true;
+        
+        // Draw border around TikTok section
+        beginLayer(LAYER_TIKTOK).drawRect(TIKTOK_X, TIKTOK_Y, TIKTOK_WIDTH, TIKTOK_HEIGHT, TL_WHITE);
+        compositorMarkDirty(LAYER_TIKTOK, TIKTOK_X, TIKTOK_Y, TIKTOK_WIDTH, TIKTOK_HEIGHT);
+        
+        isTikTokPanelShown = true;
+        renderPanel();
+    }
+
+    void initializeTikTokLive() {
+        startTikTokLive();
+        showTikTokLive();
+    }
+
     void updateTikTokLive() {
         if (isTikTokLiveInitialized) {
             // Handle WebSocket loop
@@ -106,7 +204,7 @@
                         Serial.printf("Attempting to reconnect (Attempt %d/%d)...\n", reconnectAttempts + 1, maxReconnectAttempts);
                         addLine("System", "Reconnecting...", TL_YELLOW); // Fixed: added username parameter
                         
-                        webSocket.begin(websocket_server, websocket_port, "/");
+                        webSocket.begin(websocket_server, websocket_port, websocket_path);
                         isConnecting = true;
                         lastReconnectAttempt = currentTime;
                         reconnectAttempts++;
@@ -144,12 +242,24 @@
                 addLine("System", "Connected", TL_GREEN);
                 isConnecting = false;
                 reconnectAttempts = 0; // Reset reconnect attempts on successful connection
+                if (liveConnectedAt == 0) liveConnectedAt = millis();
+                {
+                    // Subscribe so the server never sends frames the library would reject
+                    char subscription[256];
+                    snprintf(subscription, sizeof(subscription), eventSubscription, WEBSOCKETS_MAX_DATA_SIZE);
+                    webSocket.sendTXT(subscription);
+                }
                 break;
                 
             case WStype_TEXT:
                 // Process the message and update display for chat messages
                 Serial.printf("Received: %s\n", payload);
-                handleMessage((char*)payload);
+                handleMessage(payload, length);
+                break;
+                
+            case WStype_BIN:
+                // Compact MsgPack event
+                handleBinaryMessage(payload, length);
                 break;
                 
             case WStype_PING:
@@ -172,113 +282,148 @@
     }
 
     // Modified to display chat messages
-    void handleMessage(String message) {
-        DynamicJsonDocument doc(1024);
-        deserializeJson(doc, message);
+    // Strings of the event point into the payload buffer, which the WebSocket
+    // library keeps alive until this callback returns
+    void handleMessage(uint8_t * payload, size_t length) {
+        TikTokEvent event;
+        DeserializationError error = decodeJsonEvent((char*)payload, length, event);
+        if (error) {
+            Serial.printf("Invalid event: %s\n", error.c_str());
+            return;
+        }
+        handleEvent(event.type, event.username, event.value, event.count);
+    }
+
+    void handleBinaryMessage(uint8_t * payload, size_t length) {
+        TikTokEvent event;
+        DeserializationError error = decodeBinaryEvent((char*)payload, length, event);
+        if (error) {
+            Serial.printf("Invalid binary event: %s\n", error.c_str());
+            return;
+        }
+        handleEvent(event.type, event.username, event.value, event.count);
+    }
+
+    // Likes and gifts may arrive merged by the server, count says how many
+    void handleEvent(EventType type, const char* username, JsonVariantConst value, int count) {
+        char content[maxContentBytes + 1];
         
-        String type = doc["type"];
+        if (firstEventAt == 0 && type >= EVENT_CHAT && type <= EVENT_VIEWERS) firstEventAt = millis();
         
         // Display all message types with username above and content below
-        if (type == "chat") {
-            String username = doc["username"];
-            String msg = doc["message"];
-            addLine(username, "Comment: " + msg, TL_WHITE);
-        }
-        else if (type == "gift") {
-            String username = doc["username"];
-            String giftName = doc["giftName"];
-            addLine(username, "Gift: " + giftName, TL_MAGENTA);
-            Serial.println("Gift: " + username + " sent " + giftName);
-        }
-        else if (type == "like") {
-            String username = doc["username"];
-            addLine(username, "Like", TL_CYAN);
-            Serial.println("Like: " + username);
-        }
-        else if (type == "follow") {
-            String username = doc["username"];
-            addLine(username, "Follow", TL_YELLOW);
-            Serial.println("Follow: " + username);
-        }
-        else {
+        switch (type) {
+            case EVENT_CHAT:
+                snprintf(content, sizeof(content), "Comment: %s", value | "");
+                addLine(username, content, TL_WHITE);
+                break;
+                
+            case EVENT_GIFT:
+                if (count > 1) snprintf(content, sizeof(content), "Gift: %s x%d", value | "", count);
+                else snprintf(content, sizeof(content), "Gift: %s", value | "");
+                addLine(username, content, TL_MAGENTA);
+                Serial.printf("Gift: %s sent %s x%d\n", username, value | "", count);
+                break;
+                
+            case EVENT_LIKE:
+                // The like value is the number of likes
+                count = value | 1;
+                if (count > 1) snprintf(content, sizeof(content), "Like x%d", count);
+                else snprintf(content, sizeof(content), "Like");
+                addLine(username, content, TL_CYAN);
+                Serial.printf("Like: %s x%d\n", username, count);
+                break;
+                
+            case EVENT_FOLLOW:
+                addLine(username, "Follow", TL_YELLOW);
+                Serial.printf("Follow: %s\n", username);
+                break;
+                
             // Log other events to Serial only
-            if (type == "connection") {
+            case EVENT_CONNECTION:
                 Serial.println("ESP32 connected!");
-            }
-            else if (type == "tiktok_connected") {
-                String roomId = doc["roomId"];
-                Serial.println("TikTok Live connected to room: " + roomId);
+                break;
+                
+            case EVENT_TIKTOK_CONNECTED:
+                Serial.printf("TikTok Live connected to room: %s\n", value | "");
                 addLine("TikTok Live", "Connected", TL_GREEN);
-            }
-            else if (type == "tiktok_disconnected") {
+                break;
+                
+            case EVENT_TIKTOK_DISCONNECTED:
                 Serial.println("TikTok Live disconnected");
                 addLine("TikTok Live", "Disconnected", TL_RED);
-            }
-            else if (type == "viewers") {
-                int count = doc["count"];
-                Serial.println("Viewers: " + String(count));
-            }
-            else if (type == "error") {
-                String errorMsg = doc["message"];
-                Serial.println("Error: " + errorMsg);
-                addLine("Error", errorMsg, TL_RED);
-            }
+                break;
+                
+            case EVENT_VIEWERS:
+                Serial.printf("Viewers: %d\n", value.as<int>());
+                break;
+                
+            case EVENT_ERROR:
+                Serial.printf("Error: %s\n", value | "");
+                addLine("Error", value | "", TL_RED);
+                break;
+                
+            default:
+                break;
         }
     }
 
-    void addLine(String username, String content, uint16_t color) {
-        // Add new line to buffer
-        displayLines[currentLine][0] = username;
-        displayLines[currentLine][1] = content;
-        currentLine = (currentLine + 1) % maxLines;
-        
-        // Clear TikTok area (inside the border)
-        tft.fillRect(TIKTOK_X + 1, TIKTOK_Y + 1, TIKTOK_WIDTH - 2, TIKTOK_HEIGHT - 2, TL_BLACK);
-        
+    // Panel text is GLCD font at size 1, set before measuring or drawing it
+    void setPanelFont(TFT_eSPI& gfx) {
+        gfx.setTextFont(1);
+        gfx.setTextSize(1);
+    }
+
+    // The GLCD font has no glyphs above code point 255; those cells are skipped
+    // without painting their background, so they cannot cover older text
+    bool panelTextOpaque(const char* text) {
+        uint16_t length = strlen(text);
+        for (uint16_t i = 0; i < length; ) {
+            if (nextCodePoint(tft, text, &i, length) > 255) return false;
+        }
+        return true;
+    }
+
+    void setPanelRow(PanelRow& row, const PanelEntry& entry, int slot, int line, int y, uint16_t color) {
+        const TextSpan& span = line < 0 ? entry.usernameLayout.lines[0] : entry.contentLayout.lines[line];
+        row.y = y;
+        row.width = span.width;
+        row.color = color;
+        row.entryId = entry.id;
+        row.slot = slot;
+        row.line = line;
+        row.glyphs = span.glyphs;
+        row.opaque = entry.opaque;
+    }
+
+    // Build the list of text rows the panel should show, oldest entry first.
+    // Positions follow the original immediate-mode layout.
+    int layoutPanel(PanelRow* rows) {
+        int count = 0;
         int y = TIKTOK_Y + 5;
         int maxY = TIKTOK_Y + TIKTOK_HEIGHT - 5; // Maximum Y position to stay inside border
         
         for(int i = 0; i < maxLines; i++) {
-            int lineIndex = (currentLine + i) % maxLines;
-            if(displayLines[lineIndex][0] != "") {
+            int slot = (currentLine + i) % maxLines;
+            const PanelEntry& entry = panelEntries[slot];
+            if(entry.id != 0) {
                 // Check if we have enough space for at least the username
                 if(y + 10 > maxY) break; // Stop if we're about to exceed the border
                 
-                // Get content and determine if it's long
-                String displayContent = displayLines[lineIndex][1];
-                int maxCharsPerLine = 35; // Maximum characters per line
-                bool isLongContent = displayContent.length() > maxCharsPerLine;
+                uint16_t color = entry.color;
+                int contentLines = entry.contentLayout.lineCount;
+                bool isLongContent = contentLines > 1;
                 
                 // For long content, display content first then username
                 if(isLongContent) {
-                    // Display content first
-                    tft.setTextColor(color, TL_BLACK);
-                    tft.setCursor(TIKTOK_X + 5, y); // Align text to the left with a small margin
-                    tft.setTextSize(1); // Normal font for content
-                    
-                    // Handle long content by wrapping to new lines
-                    int startPos = 0;
                     int linesDisplayed = 0;
-                    int maxContentLines = 3; // Maximum number of content lines to display
                     
-                    while(startPos < displayContent.length() && linesDisplayed < maxContentLines) {
+                    while(linesDisplayed < contentLines) {
                         // Check if we have enough space for this line
                         if(y + 10 > maxY) break; // Stop if we're about to exceed the border
                         
-                        int charsToShow = min(maxCharsPerLine, (int)displayContent.length() - startPos);
-                        String lineContent = displayContent.substring(startPos, startPos + charsToShow);
-                        tft.println(lineContent);
-                        
-                        startPos += charsToShow;
+                        setPanelRow(rows[count++], entry, slot, linesDisplayed, y, color);
                         y += 10; // Add space for each additional line
                         linesDisplayed++;
-                        
-                        // If there's more content to show, set cursor for next line
-                        if(startPos < displayContent.length() && linesDisplayed < maxContentLines) {
-                            // Check if we have enough space for another line
-                            if(y + 10 > maxY) break; // Stop if we're about to exceed the border
-                            tft.setCursor(TIKTOK_X + 5, y);
-                        }
                     }
                     
                     // Add extra spacing between content and username to prevent overlap
@@ -286,18 +431,7 @@
                     
                     // Now display username below content if there's space
                     if(y + 10 <= maxY) {
-                        // Display username with smaller font
-                        tft.setTextColor(TL_YELLOW, TL_BLACK); // Username in yellow
-                        tft.setCursor(TIKTOK_X + 5, y); // Align text to the left with a small margin
-                        tft.setTextSize(1); // Smaller username font
-                        
-                        // Truncate long usernames
-                        String displayUsername = displayLines[lineIndex][0];
-                        if(displayUsername.length() > 15) {
-                            displayUsername = displayUsername.substring(0, 12) + "...";
-                        }
-                        
-                        tft.println(displayUsername);
+                        setPanelRow(rows[count++], entry, slot, -1, y, TL_YELLOW); // Username in yellow
                         y += 10; // Space after username
                     }
                     
@@ -305,34 +439,168 @@
                     y += lineHeight - 10 - (linesDisplayed * 10) - 10; // Adjusted spacing
                 } else {
                     // For short content, keep username above content (original behavior)
-                    // Display username with smaller font
-                    tft.setTextColor(TL_YELLOW, TL_BLACK); // Username in yellow
-                    tft.setCursor(TIKTOK_X + 5, y); // Align text to the left with a small margin
-                    tft.setTextSize(1); // Smaller username font
-                    
-                    // Truncate long usernames
-                    String displayUsername = displayLines[lineIndex][0];
-                    if(displayUsername.length() > 15) {
-                        displayUsername = displayUsername.substring(0, 12) + "...";
-                    }
-                    
-                    tft.println(displayUsername);
+                    setPanelRow(rows[count++], entry, slot, -1, y, TL_YELLOW); // Username in yellow
                     y += 10; // Reduced space after username
                     
                     // Check if we have enough space for content
                     if(y + 10 > maxY) break; // Stop if we're about to exceed the border
                     
-                    // Display content
-                    tft.setTextColor(color, TL_BLACK);
-                    tft.setCursor(TIKTOK_X + 5, y); // Align text to the left with a small margin
-                    tft.setTextSize(1); // Normal font for content
-                    tft.println(displayContent);
+                    setPanelRow(rows[count++], entry, slot, 0, y, color);
                     y += lineHeight - 10; // Adjusted for next entry
                 }
             }
         }
+        return count;
+    }
+
+    bool panelRowsEqual(const PanelRow& a, const PanelRow& b) {
+        return a.y == b.y && a.color == b.color && a.entryId == b.entryId && a.line == b.line;
+    }
+
+    bool panelRectsOverlap(int ax, int ay, int aw, int bx, int by, int bw) {
+        return aw > 0 && bw > 0 && ax < bx + bw && bx < ax + aw && ay < by + 8 && by < ay + 8;
+    }
+
+    void panelFillRect(TFT_eSPI& gfx, int32_t x, int32_t y, int32_t w, int32_t h) {
+        gfx.fillRect(x, y, w, h, TL_BLACK);
+        compositorMarkDirty(LAYER_TIKTOK, x, y, w, h);
+    #if TIKTOK_PANEL_STATS
+        panelStats.pixels += w * h;
+        panelStats.windows++;
+    #endif
+    }
+
+    // Bring the glass in line with the current entries. Rows that are already
+    // on screen with the same text, colour and position are left untouched;
+    // stale rows are erased and only the damaged rows are re-rasterized.
+    void renderPanel() {
+        PanelRow nextRows[maxPanelRows];
+        int nextCount = layoutPanel(nextRows);
+        const int rowX = TIKTOK_X + 5;
+        TFT_eSPI& gfx = beginLayer(LAYER_TIKTOK);
+        
+        if (panelNeedsClear) {
+            // Clear TikTok area (inside the border)
+            panelFillRect(gfx, TIKTOK_X + 1, TIKTOK_Y + 1, TIKTOK_WIDTH - 2, TIKTOK_HEIGHT - 2);
+            shownRowCount = 0;
+            panelNeedsClear = false;
+        }
+        
+        // A new row is dirty unless the identical row is already shown on the same baseline
+        bool dirty[maxPanelRows];
+        bool kept[maxPanelRows];
+        for (int o = 0; o < shownRowCount; o++) kept[o] = false;
+        for (int n = 0; n < nextCount; n++) {
+            dirty[n] = true;
+            for (int o = 0; o < shownRowCount; o++) {
+                if (!kept[o] && panelRowsEqual(shownRows[o], nextRows[n])) {
+                    dirty[n] = false;
+                    kept[o] = true;
+                    break;
+                }
+            }
+        }
+        
+        // Erase what the stale rows leave behind. When a dirty row takes over the
+        // same baseline its glyph cells overwrite the prefix, so only the tail goes.
+        // Rows with cells that paint nothing cannot do that and get a full erase.
+        for (int o = 0; o < shownRowCount; o++) {
+            if (kept[o]) continue;
+            const PanelRow& old = shownRows[o];
+            int keepWidth = 0;
+            for (int n = 0; n < nextCount; n++) {
+                if (dirty[n] && nextRows[n].opaque && nextRows[n].y == old.y) keepWidth = max(keepWidth, (int)nextRows[n].width);
+            }
+            
+            int clearX = rowX + keepWidth;
+            int clearWidth = old.width - keepWidth;
+            if (clearWidth <= 0) continue;
+            panelFillRect(gfx, clearX, old.y, clearWidth, 8);
+            
+            // Retained rows touched by the erase must be drawn again
+            for (int n = 0; n < nextCount; n++) {
+                if (panelRectsOverlap(clearX, old.y, clearWidth, rowX, nextRows[n].y, nextRows[n].width)) {
+                    dirty[n] = true;
+                }
+            }
+        }
+        
+        // Rows may overlap, so anything sharing pixels with a dirty row is redrawn
+        // too, in layout order, to give the same result as a full repaint
+        bool grew = true;
+        while (grew) {
+            grew = false;
+            for (int a = 0; a < nextCount; a++) {
+                if (!dirty[a]) continue;
+                for (int b = 0; b < nextCount; b++) {
+                    if (!dirty[b] && panelRectsOverlap(rowX, nextRows[a].y, nextRows[a].width,
+                                                       rowX, nextRows[b].y, nextRows[b].width)) {
+                        dirty[b] = true;
+                        grew = true;
+                    }
+                }
+            }
+        }
+        
+        setPanelFont(gfx);
+        for (int n = 0; n < nextCount; n++) {
+            if (!dirty[n]) continue;
+            const PanelRow& row = nextRows[n];
+            const PanelEntry& entry = panelEntries[row.slot];
+            gfx.setTextColor(row.color, TL_BLACK);
+            gfx.setCursor(rowX, row.y); // Align text to the left with a small margin
+            if (row.line < 0) drawTextLine(gfx, entry.username, entry.usernameLayout, 0);
+            else drawTextLine(gfx, entry.content, entry.contentLayout, row.line);
+            compositorMarkDirty(LAYER_TIKTOK, rowX, row.y, row.width, 8);
+    #if TIKTOK_PANEL_STATS
+            panelStats.pixels += row.glyphs * 48;
+            panelStats.windows += row.glyphs;
+    #endif
+        }
+        
+        memcpy(shownRows, nextRows, nextCount * sizeof(PanelRow));
+        shownRowCount = nextCount;
+    }
+
+    void addLine(const char* username, const char* content, uint16_t color) {
+        // Add new line to buffer, keeping only what the panel can show
+        if (*username == '\0') username = "Unknown";
+        PanelEntry& entry = panelEntries[currentLine];
+        entry.id = nextEntryId++;
+        strlcpy(entry.username, username, sizeof(entry.username));
+        strlcpy(entry.content, content, sizeof(entry.content));
+        entry.color = color;
+        
+        // Wrap once here, drawing only prints the spans
+        setPanelFont(tft);
+        layoutText(tft, entry.username, usernameWidth, 1, entry.usernameLayout);
+        layoutText(tft, entry.content, panelTextWidth, maxContentLines, entry.contentLayout);
+        entry.opaque = panelTextOpaque(entry.username) && panelTextOpaque(entry.content);
+        currentLine = (currentLine + 1) % maxLines;
+        
+        if (!isTikTokPanelShown) {
+            Serial.printf("%s: %s\n", username, content);
+            return;
+        }
+        
+    #if TIKTOK_PANEL_STATS
+        panelStats = PanelStats();
+    #endif
+        renderPanel();
+    #if TIKTOK_PANEL_STATS
+        // Cost of the old clear-and-reprint path for the same content
+        uint32_t fullPixels = (TIKTOK_WIDTH - 2) * (TIKTOK_HEIGHT - 2);
+        uint32_t fullWindows = 1;
+        for (int i = 0; i < shownRowCount; i++) {
+            fullPixels += shownRows[i].glyphs * 48;
+            fullWindows += shownRows[i].glyphs;
+        }
+        Serial.printf("Panel: %u px, %u SPI bytes (full redraw: %u px, %u SPI bytes)\n",
+                      panelStats.pixels, panelStats.pixels * 2 + panelStats.windows * PANEL_WINDOW_BYTES,
+                      fullPixels, fullPixels * 2 + fullWindows * PANEL_WINDOW_BYTES);
+    #endif
         
-        Serial.println(username + ": " + content);
+        Serial.printf("%s: %s\n", username, content);
     }
 
     #endif
\ No newline at end of file
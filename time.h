@@ -3,7 +3,10 @@
 
 #include <WiFi.h>
 #include <time.h>
+#include <sys/time.h>
 #include <TFT_eSPI.h>
+#include "compositor.h"
+#include "glyphs.h"
 
 // WiFi credentials
 const char* ssid = "REPLACE_SSID";
@@ -19,19 +22,45 @@ extern TFT_eSPI tft;
 
 // Function declarations
 void initializeTime();
+void updateTimeSync();
 void displayTime();
+bool updateTimeText();
 bool isTimeInitialized();
-String getCurrentTimeString();
-String getCurrentDateString();
-String getCurrentDayString();
 
 // Global variables
 bool timeInitialized = false;
 
-// Store previous values to avoid unnecessary redrawing
-String prevDayStr = "";
-String prevTimeStr = "";
-String prevDateStr = "";
+// WiFi and NTP bring-up runs as a state machine polled from the main loop,
+// so the intro and the WebSocket handshake keep running while it waits
+enum TimeSyncState {
+  TIME_IDLE,
+  TIME_WIFI_CONNECTING,
+  TIME_NTP_SYNCING,
+  TIME_READY,
+  TIME_FAILED
+};
+TimeSyncState timeSyncState = TIME_IDLE;
+unsigned long timeStateStart = 0;
+const unsigned long wifiTimeout = 30000; // Same limits the blocking version used
+const unsigned long ntpTimeout = 30000;
+const unsigned long timeRetryDelay = 10000; // Wait before starting over after a failure
+
+// Boot phase timestamps (millis), 0 until the phase completes
+unsigned long wifiConnectedAt = 0;
+unsigned long timeSyncedAt = 0;
+
+// Clock text, re-formatted only when a second boundary passes
+char dayText[16] = "";
+char timeText[16] = "";
+char dateText[32] = "";
+int textYday = -1; // Day of the year dayText and dateText were formatted for
+unsigned long nextTimeUpdate = 0; // millis() of the next second boundary, 0 to format at once
+
+// Text currently on screen, to redraw only what changed
+char prevDayText[16] = "";
+char prevDateText[32] = "";
+GlyphCell timeCells[16];
+int shownTimeLen = 0;
 
 // Flag to track if initial drawing is done
 bool initialDrawDone = false;
@@ -49,148 +78,168 @@ bool isTimeInitialized() {
   return timeInitialized;
 }
 
-String getCurrentTimeString() {
-  if (!timeInitialized) return "--:--:--";
-  
-  struct tm timeinfo;
-  if (!getLocalTime(&timeinfo)) {
-    return "--:--:--";
-  }
-  
-  char timeStr[16];
-  strftime(timeStr, sizeof(timeStr), "%H:%M:%S", &timeinfo);
-  return String(timeStr);
-}
-
-String getCurrentDateString() {
-  if (!timeInitialized) return "--/--/----";
-  
-  struct tm timeinfo;
-  if (!getLocalTime(&timeinfo)) {
-    return "--/--/----";
-  }
-  
-  char dateStr[32];
-  strftime(dateStr, sizeof(dateStr), "%B | %d | %Y", &timeinfo);
-  return String(dateStr);
-}
-
-String getCurrentDayString() {
-  if (!timeInitialized) return "-------";
-  
-  struct tm timeinfo;
-  if (!getLocalTime(&timeinfo)) {
-    return "-------";
-  }
-  
-  char dayStr[16];
-  strftime(dayStr, sizeof(dayStr), "%A", &timeinfo);
-  return String(dayStr);
-}
-
+// Starts WiFi association and returns at once; updateTimeSync() does the rest
 void initializeTime() {
-  if (timeInitialized) return;
+  if (timeSyncState != TIME_IDLE && timeSyncState != TIME_FAILED) return;
   
   Serial.println("Initializing time...");
+  timeStateStart = millis();
   
   // Connect to WiFi if not connected
   if (WiFi.status() != WL_CONNECTED) {
     WiFi.mode(WIFI_STA);
     WiFi.begin(ssid, password);
-    int wifi_attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && wifi_attempts < 60) {
-      delay(500);
-      Serial.print(".");
-      wifi_attempts++;
-    }
-    if (WiFi.status() != WL_CONNECTED) {
-      Serial.println("\nWiFi connection failed!");
-      return;
-    }
-    Serial.println("\nWiFi connected");
+    timeSyncState = TIME_WIFI_CONNECTING;
+  } else {
+    configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
+    timeSyncState = TIME_NTP_SYNCING;
   }
+}
 
-  // Configure time
-  configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
-  
-  // Wait for time sync
+// Advances the WiFi/NTP state machine. Never waits, call it every loop.
+void updateTimeSync() {
+  unsigned long now = millis();
   struct tm timeinfo;
-  int attempts = 0;
-  while (!getLocalTime(&timeinfo) && attempts < 30) {
-    Serial.println("Waiting for NTP time sync...");
-    delay(1000);
-    attempts++;
+  
+  switch (timeSyncState) {
+    case TIME_WIFI_CONNECTING:
+      if (WiFi.status() == WL_CONNECTED) {
+        if (wifiConnectedAt == 0) wifiConnectedAt = now;
+        Serial.printf("WiFi connected after %lu ms\n", now - timeStateStart);
+        
+        // Configure time, the SNTP client syncs in the background
+        configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
+        timeSyncState = TIME_NTP_SYNCING;
+        timeStateStart = now;
+      } else if (now - timeStateStart > wifiTimeout) {
+        Serial.println("WiFi connection failed!");
+        WiFi.disconnect();
+        timeSyncState = TIME_FAILED;
+        timeStateStart = now;
+      }
+      break;
+      
+    case TIME_NTP_SYNCING:
+      // A zero timeout checks the clock once instead of polling for 5 s
+      if (getLocalTime(&timeinfo, 0)) {
+        timeSyncedAt = now;
+        timeInitialized = true;
+        timeSyncState = TIME_READY;
+        Serial.printf("Time synchronized after %lu ms\n", now - timeStateStart);
+      } else if (now - timeStateStart > ntpTimeout) {
+        Serial.println("NTP sync failed!");
+        timeSyncState = TIME_FAILED;
+        timeStateStart = now;
+      }
+      break;
+      
+    case TIME_FAILED:
+      if (now - timeStateStart > timeRetryDelay) initializeTime();
+      break;
+      
+    default:
+      break;
   }
+}
+
+// Formats the clock into the fixed buffers once per second. Between second
+// boundaries it returns false after a single millis() compare.
+bool updateTimeText() {
+  if (nextTimeUpdate != 0 && (long)(millis() - nextTimeUpdate) < 0) return false;
   
-  if (getLocalTime(&timeinfo)) {
-    timeInitialized = true;
-    Serial.println("Time synchronized!");
-  } else {
-    Serial.println("NTP sync failed!");
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  struct tm timeinfo;
+  localtime_r(&tv.tv_sec, &timeinfo);
+  
+  strftime(timeText, sizeof(timeText), "%H:%M:%S", &timeinfo);
+  // Day and date only change at midnight
+  if (timeinfo.tm_yday != textYday) {
+    strftime(dayText, sizeof(dayText), "%A", &timeinfo);
+    strftime(dateText, sizeof(dateText), "%B | %d | %Y", &timeinfo);
+    textYday = timeinfo.tm_yday;
   }
+  
+  // Wake up again just after the next second starts
+  nextTimeUpdate = millis() + (1000 - tv.tv_usec / 1000);
+  if (nextTimeUpdate == 0) nextTimeUpdate = 1;
+  return true;
 }
 
 void displayTime() {
-  String dayStr = getCurrentDayString();
-  String timeStr = getCurrentTimeString();
-  String dateStr = getCurrentDateString();
+  if (!updateTimeText() && initialDrawDone) return;
   
   // First time drawing or after a reset
   if (!initialDrawDone) {
+    TFT_eSPI& gfx = beginLayer(LAYER_TIME);
+    
     // Clear the entire time/date area
-    tft.fillRect(DISPLAY_X, DISPLAY_Y, DISPLAY_WIDTH, DISPLAY_HEIGHT, TFT_BLACK);
+    gfx.fillRect(DISPLAY_X, DISPLAY_Y, DISPLAY_WIDTH, DISPLAY_HEIGHT, TFT_BLACK);
     
     // Draw border around time/date section
-    tft.drawRect(DISPLAY_X, DISPLAY_Y, DISPLAY_WIDTH, DISPLAY_HEIGHT, TFT_WHITE);
+    gfx.drawRect(DISPLAY_X, DISPLAY_Y, DISPLAY_WIDTH, DISPLAY_HEIGHT, TFT_WHITE);
+    compositorMarkDirty(LAYER_TIME, DISPLAY_X, DISPLAY_Y, DISPLAY_WIDTH, DISPLAY_HEIGHT);
     
+    prevDayText[0] = '\0';
+    prevDateText[0] = '\0';
+    shownTimeLen = 0;
     initialDrawDone = true;
   }
   
   // Only update day if it changed
-  if (dayStr != prevDayStr) {
+  if (strcmp(dayText, prevDayText) != 0) {
+    TFT_eSPI& gfx = beginLayer(LAYER_TIME);
+    
     // Clear previous day text area only
-    tft.fillRect(DISPLAY_X + 5, DAY_Y, DISPLAY_WIDTH - 10, 20, TFT_BLACK);
+    gfx.fillRect(DISPLAY_X + 5, DAY_Y, DISPLAY_WIDTH - 10, 20, TFT_BLACK);
     
     // Display day of week
-    tft.setTextSize(2);
-    tft.setTextColor(TFT_CYAN);
-    int dayWidth = dayStr.length() * 12; // Approximate width for size 2
+    gfx.setTextSize(2);
+    gfx.setTextColor(TFT_CYAN);
+    int dayWidth = strlen(dayText) * 12; // Approximate width for size 2
     int dayX = (240 - dayWidth) / 2;
-    tft.setCursor(dayX, DAY_Y);
-    tft.print(dayStr);
+    gfx.setCursor(dayX, DAY_Y);
+    gfx.print(dayText);
+    compositorMarkDirty(LAYER_TIME, DISPLAY_X + 5, DAY_Y, DISPLAY_WIDTH - 10, 20);
+    compositorMarkDirty(LAYER_TIME, dayX, DAY_Y, gfx.textWidth(dayText), 16);
     
-    prevDayStr = dayStr;
+    strlcpy(prevDayText, dayText, sizeof(prevDayText));
   }
   
-  // Only update time if it changed
-  if (timeStr != prevTimeStr) {
+  // Only redraw the time digits that changed. HH:MM:SS is fixed width, so
+  // each character keeps its cell and is drawn over its own background.
+  int timeLen = strlen(timeText);
+  TFT_eSPI& gfx = beginLayer(LAYER_TIME);
+  if (timeLen != shownTimeLen) {
     // Clear previous time text area only
-    tft.fillRect(DISPLAY_X + 5, TIME_Y, DISPLAY_WIDTH - 10, 30, TFT_BLACK);
-    
-    // Display time
-    tft.setTextSize(3);
-    tft.setTextColor(TFT_WHITE);
-    int timeWidth = timeStr.length() * 18; // Approximate width for size 3
-    int timeX = (240 - timeWidth) / 2;
-    tft.setCursor(timeX, TIME_Y);
-    tft.print(timeStr);
-    
-    prevTimeStr = timeStr;
+    gfx.fillRect(DISPLAY_X + 5, TIME_Y, DISPLAY_WIDTH - 10, 30, TFT_BLACK);
+    compositorMarkDirty(LAYER_TIME, DISPLAY_X + 5, TIME_Y, DISPLAY_WIDTH - 10, 30);
+    resetGlyphLine(timeCells, 16);
+    shownTimeLen = timeLen;
+  }
+  int timeX = (240 - timeLen * 18) / 2; // 18 pixel cells for size 3
+  if (drawGlyphLine(gfx, timeCells, 16, timeX, TIME_Y, timeText, 3, TFT_WHITE, TFT_BLACK) > 0) {
+    compositorMarkDirty(LAYER_TIME, timeX, TIME_Y, timeLen * 18, 24);
   }
   
   // Only update date if it changed
-  if (dateStr != prevDateStr) {
+  if (strcmp(dateText, prevDateText) != 0) {
+    TFT_eSPI& gfx = beginLayer(LAYER_TIME);
+    
     // Clear previous date text area only
-    tft.fillRect(DISPLAY_X + 5, DATE_Y, DISPLAY_WIDTH - 10, 20, TFT_BLACK);
+    gfx.fillRect(DISPLAY_X + 5, DATE_Y, DISPLAY_WIDTH - 10, 20, TFT_BLACK);
     
     // Display date
-    tft.setTextSize(2);
-    int dateWidth = dateStr.length() * 6;
+    gfx.setTextSize(2);
+    gfx.setTextColor(TFT_WHITE);
+    int dateWidth = strlen(dateText) * 6;
     int dateX = (145 - dateWidth) / 2;
-    tft.setCursor(dateX, DATE_Y);
-    tft.print(dateStr);
+    gfx.setCursor(dateX, DATE_Y);
+    gfx.print(dateText);
+    compositorMarkDirty(LAYER_TIME, DISPLAY_X + 5, DATE_Y, DISPLAY_WIDTH - 10, 20);
+    compositorMarkDirty(LAYER_TIME, dateX, DATE_Y, gfx.textWidth(dateText), 16);
     
-    prevDateStr = dateStr;
+    strlcpy(prevDateText, dateText, sizeof(prevDateText));
   }
 }
 
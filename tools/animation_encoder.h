@@ -0,0 +1,130 @@
+// Delta encoding of 1-bpp frames in the format of animation.h, used by
+// encode_intro.cpp and by the host test of the player
+// (Libraries/TFT_eSPI/tests/animation.cpp).
+
+#ifndef ANIMATION_ENCODER_H
+#define ANIMATION_ENCODER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+const uint8_t ENCODER_VERSION = 1; // Must match ANIMATION_VERSION in animation.h
+
+typedef std::vector<uint8_t> Pixels; // One byte per pixel, 0 or 1
+
+inline void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+  while (value >= 0x80) {
+    out.push_back((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  out.push_back(value);
+}
+
+inline uint32_t getVarint(const uint8_t*& pos) {
+  uint32_t value = 0;
+  uint8_t shift = 0;
+  uint8_t b;
+  do {
+    b = *pos++;
+    value |= (uint32_t)(b & 0x7F) << shift;
+    shift += 7;
+  } while (b & 0x80);
+  return value;
+}
+
+// The header, for frames of width x height
+inline std::vector<uint8_t> animationHeader(int width, int height, int frameCount) {
+  return {'D', 'A', ENCODER_VERSION,
+          (uint8_t)(width & 0xFF), (uint8_t)(width >> 8),
+          (uint8_t)(height & 0xFF), (uint8_t)(height >> 8),
+          (uint8_t)(frameCount & 0xFF), (uint8_t)(frameCount >> 8)};
+}
+
+// Appends the runs that turn 'shown' into 'next'
+inline void encodeFrame(std::vector<uint8_t>& out, const Pixels& shown, const Pixels& next, int width, int height, uint32_t& runTotal) {
+  std::vector<uint8_t> rows;
+  uint32_t rowCount = 0;
+  int lastRow = 0;
+
+  for (int y = 0; y < height; y++) {
+    std::vector<uint8_t> runs;
+    uint32_t runCount = 0;
+    int lastEnd = 0;
+    const uint8_t* a = &shown[y * width];
+    const uint8_t* b = &next[y * width];
+
+    int x = 0;
+    while (x < width) {
+      if (a[x] == b[x]) {
+        x++;
+        continue;
+      }
+      // A run of changed pixels that all end up the same colour
+      int start = x;
+      uint8_t color = b[x];
+      while (x < width && a[x] != b[x] && b[x] == color) x++;
+      putVarint(runs, start - lastEnd);
+      putVarint(runs, (uint32_t)(x - start) << 1 | color);
+      lastEnd = x;
+      runCount++;
+    }
+
+    if (runCount) {
+      putVarint(rows, y - lastRow);
+      putVarint(rows, runCount);
+      rows.insert(rows.end(), runs.begin(), runs.end());
+      lastRow = y;
+      rowCount++;
+      runTotal += runCount;
+    }
+  }
+
+  putVarint(out, rowCount);
+  out.insert(out.end(), rows.begin(), rows.end());
+}
+
+// Plays the encoded data back the way animation.h does and compares every frame
+inline bool verifyAnimation(const std::vector<uint8_t>& data, const std::vector<Pixels>& expected, int width, int height) {
+  Pixels screen(width * height, 0);
+  const uint8_t* pos = data.data() + 9;
+  for (size_t f = 0; f < expected.size(); f++) {
+    uint32_t rowCount = getVarint(pos);
+    int row = 0;
+    for (uint32_t r = 0; r < rowCount; r++) {
+      row += getVarint(pos);
+      uint32_t runCount = getVarint(pos);
+      int col = 0;
+      for (uint32_t i = 0; i < runCount; i++) {
+        col += getVarint(pos);
+        uint32_t run = getVarint(pos);
+        memset(&screen[row * width + col], run & 1, run >> 1);
+        col += run >> 1;
+      }
+    }
+    if (screen != expected[f]) {
+      fprintf(stderr, "Frame %zu does not match after decoding\n", f);
+      return false;
+    }
+  }
+  return pos == data.data() + data.size();
+}
+
+// Encodes frames shown one after the other on a black screen. Without
+// replace, pixels are never turned off again and 'frames' is updated to what
+// the screen shows.
+inline std::vector<uint8_t> encodeAnimation(std::vector<Pixels>& frames, int width, int height, bool replace, uint32_t& runTotal) {
+  std::vector<uint8_t> out = animationHeader(width, height, frames.size());
+  Pixels shown(width * height, 0);
+  for (Pixels& next : frames) {
+    if (!replace) {
+      for (size_t i = 0; i < next.size(); i++) next[i] |= shown[i];
+    }
+    encodeFrame(out, shown, next, width, height, runTotal);
+    shown = next;
+  }
+  return out;
+}
+
+#endif
@@ -0,0 +1,60 @@
+// Builds intro_anim.h (see animation.h) from the frames in intro.h.
+//
+// Build and run on the PC from the project folder:
+//   g++ -O2 -o encode_intro tools/encode_intro.cpp
+//   ./encode_intro > intro_anim.h
+//
+// displayIntro() draws the raw frames without a background colour, so pixels
+// are never turned off again. The encoder reproduces that by default; pass
+// --replace to encode the frames exactly (pixels are cleared as well).
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "animation_encoder.h"
+
+#define PROGMEM
+#include "../intro.h"
+
+const int INTRO_WIDTH = 240;
+const int INTRO_HEIGHT = 320;
+
+static Pixels unpackFrame(const uint8_t* bitmap) {
+  Pixels pixels(INTRO_WIDTH * INTRO_HEIGHT);
+  int byteWidth = (INTRO_WIDTH + 7) / 8;
+  for (int y = 0; y < INTRO_HEIGHT; y++) {
+    for (int x = 0; x < INTRO_WIDTH; x++) {
+      pixels[y * INTRO_WIDTH + x] = (bitmap[y * byteWidth + x / 8] >> (7 - (x & 7))) & 1;
+    }
+  }
+  return pixels;
+}
+
+int main(int argc, char** argv) {
+  bool replace = argc > 1 && strcmp(argv[1], "--replace") == 0;
+  int frameCount = epd_bitmap_allArray_LEN;
+  int frameBytes = (INTRO_WIDTH + 7) / 8 * INTRO_HEIGHT;
+
+  // The screen starts black (fillScreen before the intro), see encodeAnimation()
+  std::vector<Pixels> expected;
+  for (int f = 0; f < frameCount; f++) expected.push_back(unpackFrame(epd_bitmap_allArray[f]));
+  uint32_t runTotal = 0;
+  std::vector<uint8_t> out = encodeAnimation(expected, INTRO_WIDTH, INTRO_HEIGHT, replace, runTotal);
+
+  if (!verifyAnimation(out, expected, INTRO_WIDTH, INTRO_HEIGHT)) return 1;
+
+  printf("// Generated by tools/encode_intro.cpp%s, played by animation.h\n", replace ? " --replace" : "");
+  printf("// %d frames, %d x %d, %u runs\n", frameCount, INTRO_WIDTH, INTRO_HEIGHT, runTotal);
+  printf("// %zu bytes (raw frames: %d bytes)\n\n", out.size(), frameCount * frameBytes);
+  printf("#ifndef INTRO_ANIM_H\n#define INTRO_ANIM_H\n\n#include <Arduino.h>\n\n");
+  printf("const uint8_t intro_anim[] PROGMEM = {");
+  for (size_t i = 0; i < out.size(); i++) {
+    printf("%s0x%02x%s", (i % 16) ? " " : "\n  ", out[i], (i + 1 < out.size()) ? "," : "");
+  }
+  printf("\n};\n\n#endif\n");
+
+  fprintf(stderr, "%d frames: %zu bytes encoded, %d bytes raw, %u runs\n", frameCount, out.size(), frameCount * frameBytes, runTotal);
+  return 0;
+}